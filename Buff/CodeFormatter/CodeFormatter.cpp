@@ -1,7 +1,7 @@
 #include "LibWindows/AssertHandler.h"
 #include "LibWindows/Platform.h"
 #include "Lib/Assert.h"
-#include "Lib/containers/Map.h"
+#include "Lib/containers/BTreeMap.h"
 #include "Lib/Cryptography.h"
 #include "Lib/Exception.h"
 #include "Lib/Expected.h"
@@ -9,6 +9,7 @@
 #include "Lib/Function.h"
 #include "Lib/Path.h"
 #include "Lib/String.h"
+#include "Lib/StringBuilder.h"
 #include "Lib/Time.h"
 #include <algorithm>
 #include <iostream>
@@ -18,10 +19,10 @@ BUFF_NAMESPACE_BEGIN
 constexpr bool BINARY_SERIALIZATION = true;
 
 struct Cache {
-    Map<FilePath, String> files; // absolutePath -> contentHash
-    String                clangFormatVersion;
-    String                clangFormatConfigHash;
-    String                prettierVersion;
+    BTreeMap<FilePath, String> files; // absolutePath -> contentHash
+    String                     clangFormatVersion;
+    String                     clangFormatConfigHash;
+    String                     prettierVersion;
 
     void enumerateStructMembers(auto&& functor) {
         functor(clangFormatVersion, "clangFormatVersion");
@@ -92,11 +93,11 @@ static void runClangFormat(const Array<String>& args) {
         try {
             if constexpr (BINARY_SERIALIZATION) {
                 Optional<Array<std::byte>> data = readBinaryFile(cacheFile);
-                BinaryDeserializer         deserializer(std::vector(data->begin(), data->end()));
+                BinaryDeserializer         deserializer(*data);
                 deserializer.deserialize(cache, "cache");
             } else {
                 Optional<String> data = readTextFile(cacheFile);
-                JsonDeserializer deserializer(*data);
+                JsonDeserializer deserializer = JsonDeserializer::pull(*data);
                 deserializer.deserialize(cache, "cache");
             }
             std::cout << "Loaded cache with " << cache.files.size() << " entries." << std::endl;
@@ -186,14 +187,16 @@ static void runClangFormat(const Array<String>& args) {
     }
 
     if constexpr (BINARY_SERIALIZATION) {
-        BinarySerializer serializer;
+        // Tagged, so that the cache survives adding members to Cache
+        BinarySerializer serializer(BinaryFormat::TAGGED);
         serializer.serialize(cache, "cache");
         auto state = serializer.getState();
         BUFF_CHECKED_CALL(true, writeBinaryFile(cacheFile, ArrayView(state.data(), state.size())));
     } else {
-        JsonSerializer serializer;
+        StringBuilder  state;
+        JsonSerializer serializer(state, true);
         serializer.serialize(cache, "cache");
-        String state = serializer.getJson(true);
+        serializer.finish();
         BUFF_CHECKED_CALL(true, writeTextFile(cacheFile, state));
     }
     std::cout << "\n"
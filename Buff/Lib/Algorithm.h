@@ -1,5 +1,6 @@
 #pragma once
 #include "Lib/Bootstrap.h"
+#include "Lib/Hash.h"
 #include "Lib/Pixel.h"
 
 BUFF_NAMESPACE_BEGIN
@@ -37,11 +38,9 @@ inline auto iterate2D(const Pixel& size) {
     return IteratorWrapper {size};
 }
 
-inline uint hash(uint x) {
-    x = ((x >> 16) ^ x) * 0x45d9f3b;
-    x = ((x >> 16) ^ x) * 0x45d9f3b;
-    x = (x >> 16) ^ x;
-    return x;
+/// See Hash.h for hashing of 64-bit values, strings and composite keys
+inline uint hash(const uint x) {
+    return uint(hashInt(x));
 }
 
 BUFF_NAMESPACE_END
@@ -0,0 +1,100 @@
+#include "Lib/Arena.h"
+#include "Lib/Bootstrap.Test.h"
+
+BUFF_NAMESPACE_BEGIN
+
+// Test compilation:
+template class ArenaAllocator<int>;
+template class ArenaAllocator<String>;
+
+TEST_CASE("Arena hello world") {
+    Arena arena(1024);
+    CHECK(arena.getUsedBytes() == 0);
+    CHECK(arena.getReservedBytes() == 0);
+
+    int*    i = arena.construct<int>(5);
+    double* d = arena.construct<double>(3.5);
+    CHECK(*i == 5);
+    CHECK(*d == 3.5);
+    CHECK(std::uintptr_t(d) % alignof(double) == 0);
+    CHECK(arena.getReservedBytes() == 1024);
+
+    void* aligned = arena.allocate(3, 256);
+    CHECK(std::uintptr_t(aligned) % 256 == 0);
+
+    // Does not fit into a single block
+    void* big = arena.allocate(5000);
+    CHECK(big);
+    CHECK(arena.getReservedBytes() > 5000);
+    CHECK(arena.getUsedBytes() == sizeof(int) + sizeof(double) + 3 + 5000);
+}
+
+TEST_CASE("Arena reset") {
+    Arena        arena(1024);
+    Array<void*> first;
+    for (int i = 0; i < 100; ++i) {
+        first.pushBack(arena.allocate(100));
+    }
+    const int64 reserved = arena.getReservedBytes();
+    CHECK(reserved >= 100 * 100);
+
+    arena.reset();
+    CHECK(arena.getUsedBytes() == 0);
+    CHECK(arena.getReservedBytes() == reserved);
+    // Same sequence of allocations is served from the same blocks
+    for (int i = 0; i < 100; ++i) {
+        CHECK(arena.allocate(100) == first[i]);
+    }
+    CHECK(arena.getReservedBytes() == reserved);
+
+    arena.release();
+    CHECK(arena.getReservedBytes() == 0);
+    CHECK(arena.allocate(10));
+}
+
+TEST_CASE("Arena deallocate") {
+    Arena arena;
+    void* a = arena.allocate(16);
+    void* b = arena.allocate(16);
+    arena.deallocate(a, 16); // Not the last one, no-op
+    CHECK(arena.getUsedBytes() == 32);
+    arena.deallocate(b, 16);
+    CHECK(arena.getUsedBytes() == 16);
+    CHECK(arena.allocate(16) == b);
+}
+
+TEST_CASE("ArenaArray") {
+    Arena           arena(256);
+    ArenaArray<int> array(arena);
+    for (int i = 0; i < 1000; ++i) {
+        array.pushBack(i);
+    }
+    CHECK(array.size() == 1000);
+    CHECK(array[999] == 999);
+    CHECK(arena.getUsedBytes() >= 1000 * int64(sizeof(int)));
+
+    ArenaArray<String> strings(arena);
+    strings.pushBack("hello");
+    strings.pushBack("world");
+    CHECK(ArrayView<const String>(strings) == ArrayView<const String>(Array<String>{"hello", "world"}));
+}
+
+TEST_CASE("ArenaString") {
+    Arena       arena;
+    ArenaString empty;
+    CHECK(empty.isEmpty());
+    CHECK(empty.asCString()[0] == '\0');
+
+    String      source = "hello";
+    ArenaString hello(arena, source);
+    source = "changed";
+    CHECK(hello == "hello");
+    CHECK(hello.size() == 5);
+    CHECK(hello.notEmpty());
+    CHECK(hello.asCString()[5] == '\0');
+    CHECK(hello.getHash() == StringView("hello").getHash());
+    CHECK(ArenaString(arena, "abc") < ArenaString(arena, "abd"));
+    CHECK(ArenaString(arena, "abc") == ArenaString(arena, "abc"));
+}
+
+BUFF_NAMESPACE_END
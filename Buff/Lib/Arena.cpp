@@ -0,0 +1,92 @@
+#include "Lib/Arena.h"
+#include "Lib/Math.h"
+#include "Lib/Platform.h"
+#include <cstring>
+
+BUFF_NAMESPACE_BEGIN
+
+/// Space reserved at the start of each block for its header, keeps the first allocation well aligned
+static constexpr int64 HEADER_SIZE     = 64;
+static constexpr int   BLOCK_ALIGNMENT = 64;
+
+Arena::Arena(const int64 blockSize)
+    : mBlockSize(max(blockSize, HEADER_SIZE + 64)) {}
+
+Arena::~Arena() {
+    release();
+}
+
+void Arena::startBlock(Block* block) {
+    mCurrent = block;
+    mPtr     = reinterpret_cast<std::byte*>(block) + HEADER_SIZE;
+    mEnd     = reinterpret_cast<std::byte*>(block) + block->size;
+}
+
+void* Arena::allocateSlow(const int64 size, const int alignment) {
+    // First try the blocks kept from before the last reset()
+    Block* next = mCurrent ? mCurrent->next : mFirst;
+    while (next) {
+        startBlock(next);
+        std::byte* aligned = alignPointer(mPtr, alignment);
+        if (aligned + size <= mEnd) {
+            mPtr = aligned + size;
+            mUsedBytes += size;
+            return aligned;
+        }
+        next = next->next;
+    }
+
+    // Oversized requests get a dedicated block, inserted into the chain as any other block
+    const int64 blockSize =
+        alignUp(max(mBlockSize, HEADER_SIZE + size + max(alignment - BLOCK_ALIGNMENT, 0)), BLOCK_ALIGNMENT);
+    Block* block = static_cast<Block*>(alignedMalloc(blockSize, BLOCK_ALIGNMENT));
+    block->size  = blockSize;
+    block->next  = nullptr;
+    if (mCurrent) {
+        // mCurrent is now the last block of the chain
+        mCurrent->next = block;
+    } else {
+        mFirst = block;
+    }
+    startBlock(block);
+    std::byte* aligned = alignPointer(mPtr, alignment);
+    BUFF_ASSERT(aligned + size <= mEnd);
+    mPtr = aligned + size;
+    mUsedBytes += size;
+    return aligned;
+}
+
+StringView Arena::copyString(const StringView string) {
+    char* data = static_cast<char*>(allocate(string.size() + 1, 1));
+    std::memcpy(data, string.data(), string.size());
+    data[string.size()] = '\0';
+    return StringView(data, string.size());
+}
+
+void Arena::reset() {
+    mCurrent   = nullptr;
+    mPtr       = nullptr;
+    mEnd       = nullptr;
+    mUsedBytes = 0;
+}
+
+void Arena::release() {
+    Block* block = mFirst;
+    while (block) {
+        Block* next = block->next;
+        alignedFree(block);
+        block = next;
+    }
+    mFirst = nullptr;
+    reset();
+}
+
+int64 Arena::getReservedBytes() const {
+    int64 result = 0;
+    for (const Block* block = mFirst; block; block = block->next) {
+        result += block->size;
+    }
+    return result;
+}
+
+BUFF_NAMESPACE_END
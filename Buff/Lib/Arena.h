@@ -0,0 +1,182 @@
+#pragma once
+#include "Lib/Bootstrap.h"
+#include "Lib/containers/Array.h"
+#include "Lib/StringView.h"
+#include <cstddef>
+
+BUFF_NAMESPACE_BEGIN
+
+/// Monotonic (bump) allocator for many small allocations which all die together, e.g. everything created
+/// while parsing a single file or during a single frame.
+///
+/// Memory is taken from a chain of blocks and individual allocations are never freed. Instead, reset() makes
+/// all blocks available again in one go, without calling any destructors. Not thread safe.
+class Arena : public Noncopyable {
+    struct Block {
+        Block* next;
+        int64  size; // Including this header
+    };
+
+    Block*     mFirst   = nullptr;
+    Block*     mCurrent = nullptr;
+    std::byte* mPtr     = nullptr;
+    std::byte* mEnd     = nullptr;
+    int64      mBlockSize;
+    int64      mUsedBytes = 0;
+
+public:
+    static constexpr int64 DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+    /// \param blockSize Size of each block requested from the system. Allocations which do not fit in a block
+    /// get a dedicated one.
+    explicit Arena(int64 blockSize = DEFAULT_BLOCK_SIZE);
+
+    ~Arena();
+
+    /// \param alignment Must be power of 2
+    void* allocate(const int64 size, const int alignment = alignof(std::max_align_t)) {
+        BUFF_ASSERT(size >= 0 && alignment > 0 && (alignment & (alignment - 1)) == 0, size, alignment);
+        std::byte* aligned = alignPointer(mPtr, alignment);
+        if (aligned + size > mEnd || !mPtr) [[unlikely]] {
+            return allocateSlow(size, alignment);
+        }
+        mPtr = aligned + size;
+        mUsedBytes += size;
+        return aligned;
+    }
+
+    /// Gives the memory back only when it was the last allocation (e.g. a growing Array reallocating),
+    /// otherwise does nothing.
+    void deallocate(void* ptr, const int64 size) {
+        if (static_cast<std::byte*>(ptr) + size == mPtr) {
+            mPtr = static_cast<std::byte*>(ptr);
+            mUsedBytes -= size;
+        }
+    }
+
+    /// The destructor of the object will never be called.
+    template <typename T, typename... TConstructorArgs>
+    T* construct(TConstructorArgs&&... args) requires ConstructibleFrom<T, TConstructorArgs...> {
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<TConstructorArgs>(args)...);
+    }
+
+    /// Returns a zero-terminated copy of the string, valid until reset() is called
+    StringView copyString(StringView string);
+
+    /// Makes all memory available for new allocations. Keeps the blocks allocated from the system, so an
+    /// arena reused every frame stops calling the system allocator after the first frame.
+    void reset();
+
+    /// Like reset(), but also returns all blocks to the system
+    void release();
+
+    /// Sum of sizes of all allocations since the last reset()
+    int64 getUsedBytes() const {
+        return mUsedBytes;
+    }
+
+    /// Memory currently taken from the system
+    int64 getReservedBytes() const;
+
+private:
+    static std::byte* alignPointer(std::byte* ptr, const int alignment) {
+        return reinterpret_cast<std::byte*>((std::uintptr_t(ptr) + (alignment - 1)) &
+                                            ~std::uintptr_t(alignment - 1));
+    }
+
+    void* allocateSlow(int64 size, int alignment);
+
+    void startBlock(Block* block);
+};
+
+/// Standard library compatible allocator drawing memory from an Arena, to be used with containers. Freeing
+/// memory is a no-op, it is reclaimed all at once by Arena::reset().
+template <typename T>
+class ArenaAllocator {
+    template <typename T2>
+    friend class ArenaAllocator;
+
+    Arena* mArena;
+
+public:
+    using value_type = T;
+
+    // ReSharper disable once CppNonExplicitConvertingConstructor
+    ArenaAllocator(Arena& arena)
+        : mArena(&arena) {}
+
+    // ReSharper disable once CppNonExplicitConvertingConstructor
+    template <typename T2>
+    ArenaAllocator(const ArenaAllocator<T2>& other)
+        : mArena(other.mArena) {}
+
+    T* allocate(const size_t count) {
+        return static_cast<T*>(mArena->allocate(int64(count * sizeof(T)), alignof(T)));
+    }
+    void deallocate(T* ptr, const size_t count) {
+        mArena->deallocate(ptr, int64(count * sizeof(T)));
+    }
+
+    Arena& getArena() const {
+        return *mArena;
+    }
+
+    template <typename T2>
+    bool operator==(const ArenaAllocator<T2>& other) const {
+        return mArena == other.mArena;
+    }
+};
+
+template <typename T>
+using ArenaArray = Array<T, ArenaAllocator<T>>;
+
+/// Immutable zero-terminated string stored inside an Arena. Only holds a pointer, so it is trivially copyable
+/// and destructible. Valid until the arena is reset.
+class ArenaString {
+    const char* mData = "";
+    int         mSize = 0;
+
+public:
+    ArenaString() = default;
+
+    ArenaString(Arena& arena, const StringView value) {
+        const StringView copy = arena.copyString(value);
+        mData                 = copy.data();
+        mSize                 = copy.size();
+    }
+
+    // ReSharper disable once CppNonExplicitConversionOperator
+    operator StringView() const {
+        return StringView(mData, mSize);
+    }
+
+    const char* asCString() const {
+        return mData;
+    }
+
+    int size() const {
+        return mSize;
+    }
+    bool isEmpty() const {
+        return mSize == 0;
+    }
+    bool notEmpty() const {
+        return mSize != 0;
+    }
+
+    bool operator==(const ArenaString& other) const {
+        return StringView(*this) == StringView(other);
+    }
+    bool operator==(const StringView& other) const {
+        return StringView(*this) == other;
+    }
+    std::strong_ordering operator<=>(const ArenaString& other) const {
+        return StringView(*this) <=> StringView(other);
+    }
+
+    size_t getHash() const {
+        return StringView(*this).getHash();
+    }
+};
+
+BUFF_NAMESPACE_END
@@ -1,5 +1,6 @@
 #pragma once
 #include "Lib/Bootstrap.h"
+#include "Lib/Exception.h"
 #include "Lib/Serialization.h"
 #include "Lib/String.h"
 #include <memory>
@@ -64,10 +65,7 @@ public:
         serializer.serialize(bool(mImpl), "hasValue");
         if (bool(mImpl)) {
             if constexpr (std::is_base_of_v<Polymorphic, T>) {
-                [[maybe_unused]] const T* ptr       = mImpl.get();
-                const char*               className = typeid(*ptr).name();
-                serializer.serialize(String(className), "className");
-                Detail::serializePolymorphicClass(className, *mImpl, serializer);
+                Detail::serializePolymorphicClass(*mImpl, serializer);
             } else {
                 serializer.serialize(*mImpl, "nonPolymorphicValue");
             }
@@ -79,12 +77,13 @@ public:
         deserializer.deserialize(hasValue, "hasValue");
         if (hasValue) {
             if constexpr (std::is_base_of_v<Polymorphic, T>) {
-                String className;
-                deserializer.deserialize(className, "className");
-                Polymorphic* polymorphic =
-                    Detail::instantiatePolymorphicClass(className.asCString(), deserializer);
-                BUFF_ASSERT(dynamic_cast<T*>(polymorphic));
-                mImpl.reset(static_cast<T*>(polymorphic));
+                Polymorphic* polymorphic = Detail::instantiatePolymorphicClass(deserializer);
+                T* typed = dynamic_cast<T*>(polymorphic);
+                if (!typed) {
+                    delete polymorphic;
+                    throw Exception("Polymorphic type ID does not match the expected class");
+                }
+                mImpl.reset(typed);
             } else {
                 mImpl = std::make_unique<T>();
                 deserializer.deserialize(*mImpl, "nonPolymorphicValue");
@@ -13,6 +13,12 @@ concept Integer = std::is_integral_v<T>;
 template <typename T>
 concept UnsignedInteger = std::is_integral_v<T> && std::is_unsigned_v<T>;
 
+/// Integer or floating point type which is formatted as a number, i.e. not bool or a character type
+template <typename T>
+concept Number = std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char> &&
+                 !std::is_same_v<T, wchar_t> && !std::is_same_v<T, char8_t> && !std::is_same_v<T, char16_t> &&
+                 !std::is_same_v<T, char32_t>;
+
 // Concept for a type with operator< defined. Note that STL only has one for <=>
 template <typename T, typename T2 = T>
 concept LessThanComparable = requires(const T& a, const T2& b) {
@@ -3,9 +3,6 @@
 #include "Lib/containers/StaticArray.h"
 #include "Lib/Optional.h"
 #include "Lib/String.h"
-#ifdef __EMSCRIPTEN__
-#    include <iomanip>
-#endif
 
 BUFF_NAMESPACE_BEGIN
 
@@ -296,9 +293,7 @@ String getMd5Ascii(const StringView string) {
     const StaticArray<std::byte, 16> binary = md5.final();
     String                           result;
     for (auto& i : binary) {
-        std::stringstream stream;
-        stream << std::setfill('0') << std::setw(2) << std::hex << int(i);
-        result << stream.str();
+        result << leftPad(toStrHexadecimal(int(i)), 2, '0');
     }
     return result;
 }
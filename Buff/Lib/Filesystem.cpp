@@ -5,7 +5,9 @@
 #include "Lib/Function.h"
 #include "Lib/Optional.h"
 #include "Lib/Path.h"
+#include "Lib/Simd.h"
 #include "Lib/String.h"
+#include "Lib/StringBuilder.h"
 #include <filesystem>
 #include <fstream>
 #include <functional>
@@ -41,22 +43,24 @@ Optional<int64> fileSize(const FilePath& filename) {
 }
 
 Optional<String> readTextFile(const FilePath& filename) {
-    // TODO: this is inefficient, but standard std::ifstream stops at character \x19 (END OF MEDIUM).
+    // Standard std::ifstream stops at character \x19 (END OF MEDIUM), so the file is read as binary
     if (const Optional<Array<std::byte>> data = readBinaryFile(filename)) {
-        String result;
-        result.reserve(int(data->size()));
-        for (int i = 0; i < data->size(); ++i) {
-            if ((*data)[i] == std::byte('\r')) {
-                result << '\n';
-                if (i + 1 < data->size() && (*data)[i + 1] == std::byte('\n')) {
-                    ++i; // for windows newlines remove second character of the sequence
-                }
-            } else { // Batch append of regular chars for performance
-                const int begin = i;
-                while (i < data->size() - 1 && (*data)[i + 1] != std::byte('\r')) {
-                    ++i;
-                }
-                result << StringView(reinterpret_cast<const char*>(data->data()) + begin, i - begin + 1);
+        const char* chars = reinterpret_cast<const char*>(data->data());
+        const int64 size  = data->size();
+        String      result;
+        result.reserve(int(size));
+        int64 i = 0;
+        while (true) {
+            // Batch append of regular chars up to the next \r
+            const int64 lineEnd = i + Simd::findEqual(chars + i, size - i, '\r');
+            result << StringView(chars + i, int(lineEnd - i));
+            if (lineEnd == size) {
+                break;
+            }
+            result << '\n';
+            i = lineEnd + 1;
+            if (i < size && chars[i] == '\n') {
+                ++i; // for windows newlines remove second character of the sequence
             }
         }
         return result;
@@ -85,6 +89,12 @@ bool writeTextFile(const FilePath& filename, const StringView text) {
     return stream.good();
 }
 
+bool writeTextFile(const FilePath& filename, const StringBuilder& text) {
+    std::ofstream stream(filename.getNative().asWString(), std::ios::out);
+    text.forEachChunk([&](const StringView chunk) { stream.write(chunk.data(), chunk.size()); });
+    return stream.good();
+}
+
 bool writeBinaryFile(const FilePath& filename, const ArrayView<const std::byte> data) {
     std::ofstream stream(filename.getNative().asWString(), std::ios::out | std::ios::binary);
     stream.write(reinterpret_cast<const char*>(data.data()), data.size());
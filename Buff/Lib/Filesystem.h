@@ -11,6 +11,7 @@ template <typename T>
 class Function;
 class FilePath;
 class DirectoryPath;
+class StringBuilder;
 
 // TODO: unify handling of errors between removeFile and removeDir
 
@@ -41,6 +42,9 @@ void renameFile(const FilePath& from, const FilePath& to);
 
 [[nodiscard]] bool writeTextFile(const FilePath& filename, StringView text);
 
+/// Writes the builder chunk by chunk, without assembling the whole text in memory first
+[[nodiscard]] bool writeTextFile(const FilePath& filename, const StringBuilder& text);
+
 [[nodiscard]] bool writeBinaryFile(const FilePath& filename, ArrayView<const std::byte> data);
 
 // ===========================================================================================================
@@ -0,0 +1,99 @@
+#include "Lib/FuzzyIndex.h"
+#include "Lib/Bootstrap.Test.h"
+#include "Lib/Random.h"
+#include "Lib/Time.h"
+#include <iostream>
+
+BUFF_NAMESPACE_BEGIN
+
+static String generateName(RandomNumberGenerator& rng, const int maxLength) {
+    String result;
+    for ([[maybe_unused]] const int i : range(1 + rng.getRandomInt(maxLength - 1))) {
+        result << char('a' + rng.getRandomInt(5));
+    }
+    return result;
+}
+
+TEST_CASE("FuzzyIndex") {
+    const Array<StringView> names = {"apple", "apply", "ape", "maple", "apple", "banana", "bandana"};
+    const FuzzyIndex        index(names);
+    CHECK(index.size() == 7);
+
+    using Match = FuzzyIndex::Match;
+    CHECK(index.findClosest("apple", 3) == Array<Match> {Match {0, 0}, Match {4, 0}, Match {1, 1}});
+    CHECK(index.findClosest("bananas", 2) == Array<Match> {Match {5, 1}, Match {6, 2}});
+    CHECK(index.findClosest("bananas", 5, 1) == Array<Match> {Match {5, 1}});
+    CHECK(index.findClosest("xyz", 0).isEmpty());
+    CHECK(FuzzyIndex().findClosest("xyz", 3).isEmpty());
+}
+
+TEST_CASE("FuzzyIndex random") {
+    // Same result as computing the distance to every name
+    RandomNumberGenerator rng;
+    Array<String>         names;
+    FuzzyIndex            index;
+    for ([[maybe_unused]] const int i : range(500)) {
+        names.pushBack(generateName(rng, 8));
+        CHECK(index.insert(names.back()) == i);
+    }
+    for (const int i : range(100)) {
+        const String query       = generateName(rng, 8);
+        const int    count       = 1 + rng.getRandomInt(10);
+        const int    maxDistance = i % 10 == 0 ? INT_MAX : rng.getRandomInt(6);
+
+        Array<FuzzyIndex::Match> expected;
+        for (const int id : range(int(names.size()))) {
+            const int distance = *getLevenshteinDistanceOnly(query, names[id]);
+            if (distance <= maxDistance) {
+                expected.pushBack({id, distance});
+            }
+        }
+        std::ranges::stable_sort(expected, {}, &FuzzyIndex::Match::distance);
+        expected.resize(min<int64>(expected.size(), count));
+        CHECK(index.findClosest(query, count, maxDistance) == expected);
+    }
+}
+
+TEST_CASE("FuzzyIndex benchmark" * doctest::skip()) {
+    // Looking up misspelled names among many identifiers
+    RandomNumberGenerator rng;
+    Array<String>         names;
+    FuzzyIndex            index;
+    for ([[maybe_unused]] const int i : range(100'000)) {
+        String name;
+        for ([[maybe_unused]] const int j : range(rng.getRandomInt(6, 20))) {
+            name << char('a' + rng.getRandomInt(25));
+        }
+        index.insert(name);
+        names.pushBack(std::move(name));
+    }
+    Array<String> queries;
+    for ([[maybe_unused]] const int i : range(1'000)) {
+        String query = names[rng.getRandomInt(int(names.size()) - 1)];
+        for ([[maybe_unused]] const int j : range(rng.getRandomInt(1, 2))) {
+            query[rng.getRandomInt(query.size() - 1)] = char('a' + rng.getRandomInt(25));
+        }
+        queries.pushBack(std::move(query));
+    }
+
+    Timer timer;
+    int   found = 0;
+    for (const String& query : queries) {
+        found += int(index.findClosest(query, 5, 2).size());
+    }
+    std::cout << "FuzzyIndex: " << found << " matches in " << timer.getElapsed().getUserReadable()
+              << std::endl;
+
+    timer.reset();
+    found = 0;
+    for (const String& query : queries) {
+        const LevenshteinMatcher matcher(query);
+        for (const String& name : names) {
+            found += matcher.getDistance(name, 2).hasValue();
+        }
+    }
+    std::cout << "Brute force: " << found << " matches in " << timer.getElapsed().getUserReadable()
+              << std::endl;
+}
+
+BUFF_NAMESPACE_END
@@ -0,0 +1,128 @@
+#include "Lib/FuzzyIndex.h"
+
+BUFF_NAMESPACE_BEGIN
+
+namespace {
+struct BigramCount {
+    uint16 bigram;
+    int    count;
+};
+} // namespace
+
+/// Distinct bigrams of the text padded with a zero at both ends, with their number of occurrences
+static Array<BigramCount> getBigrams(const StringView text) {
+    Array<uint16> bigrams(text.size() + 1);
+    for (const int i : range(text.size() + 1)) {
+        const uint8 first  = i == 0 ? 0 : uint8(text[i - 1]);
+        const uint8 second = i == text.size() ? 0 : uint8(text[i]);
+        bigrams[i]         = uint16(first << 8 | second);
+    }
+    std::ranges::sort(bigrams);
+    Array<BigramCount> result;
+    for (const uint16 bigram : bigrams) {
+        if (result.notEmpty() && result.back().bigram == bigram) {
+            ++result.back().count;
+        } else {
+            result.pushBack(BigramCount {bigram, 1});
+        }
+    }
+    return result;
+}
+
+int FuzzyIndex::insert(const StringView text) {
+    const int id = size();
+    mEntries.pushBack(Entry {int(mTexts.size()), text.size()});
+    mTexts.pushBackRange(ArrayView(text));
+    for (const BigramCount& it : getBigrams(text)) {
+        mPostings[it.bigram].pushBack(Posting {id, it.count});
+    }
+    return id;
+}
+
+Array<FuzzyIndex::Match> FuzzyIndex::findClosest(const StringView query,
+                                                 const int        count,
+                                                 const int        maxDistance) const {
+    BUFF_ASSERT(count >= 0 && maxDistance >= 0, count, maxDistance);
+    Array<Match> result;
+    if (count == 0 || mEntries.isEmpty()) {
+        return result;
+    }
+    const auto isBetter = [](const Match& a, const Match& b) {
+        return a.distance < b.distance || (a.distance == b.distance && a.id < b.id);
+    };
+    // Once count matches are found, only matches at most as far as the worst of them can still be added
+    const auto getRadius = [&] {
+        return result.size() == count ? min(maxDistance, result.back().distance) : maxDistance;
+    };
+    // Strings sharing fewer bigrams with the query are further than radius from it
+    const auto getMinShared = [&](const int textSize, const int radius) {
+        return int64(max(query.size(), textSize)) + 1 - 2 * int64(radius);
+    };
+
+    // Counts repeated bigrams as many times as they occur in both strings
+    Array<int> shared(size());
+    Array<int> candidates;
+    for (const BigramCount& it : getBigrams(query)) {
+        if (const Array<Posting>* postings = mPostings.find(it.bigram)) {
+            for (const Posting& posting : *postings) {
+                if (shared[posting.id] == 0) {
+                    candidates.pushBack(posting.id);
+                }
+                shared[posting.id] += min(it.count, posting.count);
+            }
+        }
+    }
+
+    // Counting sort, most shared bigrams first
+    const int  maxShared = query.size() + 1;
+    Array<int> firstIndex(maxShared + 1);
+    for (const int id : candidates) {
+        ++firstIndex[maxShared - shared[id] + 1];
+    }
+    for (const int i : range(1, maxShared + 1)) {
+        firstIndex[i] += firstIndex[i - 1];
+    }
+    Array<int> sorted(candidates.size());
+    for (const int id : candidates) {
+        sorted[firstIndex[maxShared - shared[id]]++] = id;
+    }
+
+    const LevenshteinMatcher matcher(query);
+    const auto               tryMatch = [&](const int id) {
+        const int        radius = getRadius();
+        const StringView text   = (*this)[id];
+        if (shared[id] < getMinShared(text.size(), radius)) {
+            return;
+        }
+        const Optional<int> distance = matcher.getDistance(text, radius);
+        if (!distance) {
+            return;
+        }
+        const Match match {id, *distance};
+        if (result.size() == count && !isBetter(match, result.back())) {
+            return;
+        }
+        const auto position = std::ranges::upper_bound(result, match, isBetter);
+        result.insert(position - result.begin(), match);
+        if (result.size() > count) {
+            result.popBack();
+        }
+    };
+    for (const int id : sorted) {
+        if (shared[id] < getMinShared(0, getRadius())) {
+            break; // All the remaining candidates share even fewer bigrams
+        }
+        tryMatch(id);
+    }
+    // Strings sharing no bigram at all only match when the radius allows rewriting the whole query
+    if (getMinShared(0, getRadius()) <= 0) {
+        for (const int id : range(size())) {
+            if (shared[id] == 0) {
+                tryMatch(id);
+            }
+        }
+    }
+    return result;
+}
+
+BUFF_NAMESPACE_END
@@ -0,0 +1,65 @@
+#pragma once
+#include "Lib/Bootstrap.h"
+#include "Lib/containers/Array.h"
+#include "Lib/containers/HashMap.h"
+#include "Lib/String.h"
+#include "Lib/StringView.h"
+
+BUFF_NAMESPACE_BEGIN
+
+/// Finds the strings closest to a query by Levenshtein distance, without computing the distance to every
+/// string. Strings are indexed by their bigrams (pairs of consecutive bytes, the ends padded with zero):
+/// a string with k edits from the query shares at least max(|query|, |string|) + 1 - 2k bigrams with it,
+/// because every edit changes at most two of them. Candidates are verified from the most shared bigrams
+/// down, and the search stops once no remaining candidate can beat the k-th best distance found so far.
+class FuzzyIndex {
+    struct Entry {
+        int textOffset;
+        int textSize;
+    };
+    struct Posting {
+        int id;
+        /// Number of occurrences of the bigram in the string
+        int count;
+    };
+    Array<Entry> mEntries;
+    /// Texts of all entries, one after another
+    Array<char> mTexts;
+    /// Strings containing each bigram, in increasing order of ids
+    HashMap<uint16, Array<Posting>> mPostings;
+
+public:
+    struct Match {
+        /// Index of the string in insertion order
+        int id;
+        int distance;
+
+        bool operator==(const Match& other) const = default;
+    };
+
+    FuzzyIndex() = default;
+    explicit FuzzyIndex(ArrayView<const StringView> texts) {
+        for (const StringView text : texts) {
+            insert(text);
+        }
+    }
+
+    /// \return Id of the inserted string, which is its index in insertion order
+    int insert(StringView text);
+
+    /// Number of inserted strings, including duplicates
+    int size() const {
+        return int(mEntries.size());
+    }
+
+    StringView operator[](const int id) const {
+        const Entry& entry = mEntries[id];
+        return StringView(mTexts.data() + entry.textOffset, entry.textSize);
+    }
+
+    /// At most count strings closest to query, ordered by distance, then by id
+    /// \param maxDistance Strings further from query are never returned
+    Array<Match> findClosest(StringView query, int count, int maxDistance = INT_MAX) const;
+};
+
+BUFF_NAMESPACE_END
@@ -0,0 +1,50 @@
+#include "Lib/Hash.h"
+#include "Lib/Bootstrap.Test.h"
+#include "Lib/containers/HashMap.h"
+#include "Lib/String.h"
+
+BUFF_NAMESPACE_BEGIN
+
+static constexpr char LONG_TEXT[] = "The quick brown fox jumps over the lazy dog, again and again and again";
+
+// Hashes are stored on disk, they must not change between versions or platforms
+static_assert(hashBytes("hello", 5) == 0x49a593f92a7c549full);
+static_assert(hashBytes("", 0) == 0x93228a4de0eec5a2ull);
+static_assert(hashBytes(LONG_TEXT, 70) == 0xb27910d24d078480ull);
+static_assert(hashInt(1) == 0x5ed9c758b9c48de0ull);
+
+TEST_CASE("hashBytes") {
+    // Runtime and constexpr paths agree
+    CHECK(hashBytes(StringView("hello").data(), 5) == 0x49a593f92a7c549full);
+    CHECK(hashBytes(StringView(LONG_TEXT).data(), 70) == 0xb27910d24d078480ull);
+    CHECK(StringView("hello").getHash() == size_t(0x49a593f92a7c549full));
+    CHECK(String("hello").getHash() == StringView("hello").getHash());
+
+    // All prefixes, covering all the length-specific branches, are different
+    HashMap<uint64, int> seen;
+    for (const int length : range(71)) {
+        const uint64 hash = hashBytes(LONG_TEXT, length);
+        CHECK(!seen.contains(hash));
+        seen[hash] = length;
+        CHECK(hashBytes(LONG_TEXT, length, 1) != hash);
+    }
+}
+
+TEST_CASE("hashValue") {
+    CHECK(hashValue(1) != 1);
+    CHECK(hashValue(1) != hashValue(2));
+    CHECK(hashValue(0.f) == hashValue(-0.f));
+    CHECK(hashValue(StringView("abc")) == StringView("abc").getHash());
+    CHECK(Detail::MyHash {}(42) == size_t(hashInt(42)));
+}
+
+TEST_CASE("Hasher") {
+    const uint64 ab = Hasher().add(StringView("a")).add(StringView("b")).get();
+    CHECK(ab == Hasher().add(String("a")).add(String("b")).get());
+    CHECK(ab != Hasher().add(StringView("b")).add(StringView("a")).get());
+    CHECK(ab != Hasher().add(StringView("ab")).add(StringView("")).get());
+    CHECK(Hasher().add(1).add(2).get() != Hasher().add(2).add(1).get());
+    static_assert(Hasher().add(1).addBytes("x", 1).get() == Hasher().add(1).addBytes("x", 1).get());
+}
+
+BUFF_NAMESPACE_END
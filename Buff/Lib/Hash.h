@@ -0,0 +1,190 @@
+#pragma once
+#include "Lib/Bootstrap.h"
+#include <bit>
+#include <cstring>
+#include <functional>
+#if defined(_MSC_VER) && !defined(__SIZEOF_INT128__)
+#    include <intrin.h>
+#endif
+
+BUFF_NAMESPACE_BEGIN
+
+// Fast non-cryptographic 64-bit hashing, based on wyhash (https://github.com/wangyi-fudan/wyhash, public
+// domain). Results are the same on all platforms and in constexpr evaluation, so they can be stored on disk.
+
+static_assert(std::endian::native == std::endian::little, "Stable hashes assume little endian byte order");
+
+namespace Detail {
+
+inline constexpr uint64 HASH_SECRET[4] = {
+    0x2d358dccaa6c78a5ull,
+    0x8bb84b93962eacc9ull,
+    0x4b33a62ed433d4a3ull,
+    0x4d5a2da51de1aa47ull,
+};
+
+/// Full 128-bit product of a and b, low half returned in a, high half in b
+constexpr void multiply128(uint64& a, uint64& b) {
+    if (!std::is_constant_evaluated()) {
+#if defined(__SIZEOF_INT128__)
+        const unsigned __int128 result = static_cast<unsigned __int128>(a) * b;
+        a                              = uint64(result);
+        b                              = uint64(result >> 64);
+        return;
+#elif defined(_MSC_VER) && defined(_M_X64)
+        a = _umul128(a, b, &b);
+        return;
+#endif
+    }
+    const uint64 aLow   = a & 0xFFFFFFFF;
+    const uint64 aHigh  = a >> 32;
+    const uint64 bLow   = b & 0xFFFFFFFF;
+    const uint64 bHigh  = b >> 32;
+    const uint64 lowLow = aLow * bLow;
+    const uint64 lowHi  = aLow * bHigh;
+    const uint64 hiLow  = aHigh * bLow;
+    const uint64 middle = (lowLow >> 32) + (lowHi & 0xFFFFFFFF) + (hiLow & 0xFFFFFFFF);
+    a                   = (lowLow & 0xFFFFFFFF) | (middle << 32);
+    b                   = aHigh * bHigh + (lowHi >> 32) + (hiLow >> 32) + (middle >> 32);
+}
+
+constexpr uint64 hashMix(uint64 a, uint64 b) {
+    multiply128(a, b);
+    return a ^ b;
+}
+
+template <int TBytes>
+constexpr uint64 readLittleEndian(const char* data) {
+    if (std::is_constant_evaluated()) {
+        uint64 result = 0;
+        for (int i = 0; i < TBytes; ++i) {
+            result |= uint64(uint8(data[i])) << (8 * i);
+        }
+        return result;
+    } else {
+        std::conditional_t<TBytes == 8, uint64, uint> result;
+        std::memcpy(&result, data, TBytes);
+        return result;
+    }
+}
+
+} // namespace Detail
+
+/// Hash of size bytes of data
+constexpr uint64 hashBytes(const char* data, const int64 size, uint64 seed = 0) {
+    using namespace Detail;
+    const uint64 length = uint64(size);
+    seed ^= hashMix(seed ^ HASH_SECRET[0], HASH_SECRET[1]);
+    uint64 a;
+    uint64 b;
+    if (length <= 16) [[likely]] {
+        if (length >= 4) {
+            const uint64 shift = (length >> 3) << 2;
+            a = (readLittleEndian<4>(data) << 32) | readLittleEndian<4>(data + shift);
+            b = (readLittleEndian<4>(data + length - 4) << 32) |
+                readLittleEndian<4>(data + length - 4 - shift);
+        } else if (length > 0) {
+            a = (uint64(uint8(data[0])) << 16) | (uint64(uint8(data[length >> 1])) << 8) |
+                uint64(uint8(data[length - 1]));
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        // Three independent lanes keep the multipliers busy on long inputs
+        uint64 remaining = length;
+        if (remaining >= 48) {
+            uint64 seed1 = seed;
+            uint64 seed2 = seed;
+            do {
+                seed  = hashMix(readLittleEndian<8>(data) ^ HASH_SECRET[1],
+                                readLittleEndian<8>(data + 8) ^ seed);
+                seed1 = hashMix(readLittleEndian<8>(data + 16) ^ HASH_SECRET[2],
+                                readLittleEndian<8>(data + 24) ^ seed1);
+                seed2 = hashMix(readLittleEndian<8>(data + 32) ^ HASH_SECRET[3],
+                                readLittleEndian<8>(data + 40) ^ seed2);
+                data += 48;
+                remaining -= 48;
+            } while (remaining >= 48);
+            seed ^= seed1 ^ seed2;
+        }
+        while (remaining > 16) {
+            seed = hashMix(readLittleEndian<8>(data) ^ HASH_SECRET[1], readLittleEndian<8>(data + 8) ^ seed);
+            data += 16;
+            remaining -= 16;
+        }
+        a = readLittleEndian<8>(data + remaining - 16);
+        b = readLittleEndian<8>(data + remaining - 8);
+    }
+    a ^= HASH_SECRET[1];
+    b ^= seed;
+    multiply128(a, b);
+    return hashMix(a ^ HASH_SECRET[0] ^ length, b ^ HASH_SECRET[1]);
+}
+
+/// Hash of a single 64-bit value. Unlike std::hash, this is never identity.
+constexpr uint64 hashInt(const uint64 value, const uint64 seed = 0) {
+    return Detail::hashMix(value ^ seed ^ Detail::HASH_SECRET[0], Detail::HASH_SECRET[1]);
+}
+
+namespace Detail {
+template <typename T>
+concept HasGetHashFunction = requires(const T& a) {
+    { a.getHash() } -> std::convertible_to<size_t>;
+};
+template <typename T>
+concept HasStdHashOverload = requires(const T& a) {
+    { std::hash<T> {}(a) } -> std::convertible_to<size_t>;
+};
+} // namespace Detail
+
+/// Types accepted by hashValue and Hasher
+template <typename T>
+concept ValueHashable = std::is_arithmetic_v<T> || std::is_enum_v<T> || std::is_pointer_v<T> ||
+                        Detail::HasGetHashFunction<T> || Detail::HasStdHashOverload<T>;
+
+/// Hash of a value: integers, enums, floats and pointers are hashed directly, other types use their getHash()
+/// or std::hash. Floats are hashed so that 0 and -0 are equal.
+template <ValueHashable T>
+constexpr uint64 hashValue(const T& value) {
+    if constexpr (Detail::HasGetHashFunction<T>) {
+        return uint64(value.getHash());
+    } else if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+        return hashInt(uint64(value));
+    } else if constexpr (std::is_floating_point_v<T>) {
+        const double normalized = value == 0 ? 0.0 : double(value);
+        return hashInt(std::bit_cast<uint64>(normalized));
+    } else if constexpr (std::is_pointer_v<T>) {
+        return hashInt(uint64(std::uintptr_t(value)));
+    } else {
+        return uint64(std::hash<T> {}(value));
+    }
+}
+
+/// Combines hashes of multiple values, e.g. of all members of a composite key:
+///     size_t getHash() const { return Hasher().add(name).add(index).get(); }
+/// The order of values matters.
+class Hasher {
+    uint64 mState;
+
+public:
+    constexpr explicit Hasher(const uint64 seed = 0)
+        : mState(seed) {}
+
+    template <ValueHashable T>
+    constexpr Hasher& add(const T& value) {
+        mState = Detail::hashMix(mState ^ Detail::HASH_SECRET[0], hashValue(value) ^ Detail::HASH_SECRET[1]);
+        return *this;
+    }
+
+    constexpr Hasher& addBytes(const char* data, const int64 size) {
+        mState = hashBytes(data, size, mState);
+        return *this;
+    }
+
+    constexpr uint64 get() const {
+        return mState;
+    }
+};
+
+BUFF_NAMESPACE_END
@@ -1,5 +1,8 @@
 #include "Lib/Json.h"
+#include "Lib/StringBuilder.h"
 #include "Lib/Bootstrap.Test.h"
+#include "Lib/Time.h"
+#include <iostream>
 
 BUFF_NAMESPACE_BEGIN
 
@@ -49,4 +52,129 @@ TEST_CASE("jsonRoundTrip") {
                 R"({"arr": [1, 3, true, "abc"]})");
 }
 
+TEST_CASE("JsonReader") {
+    const String  json = "{\"a\" :[1.5e3,-2, true,null],\n\t\"b\\\"c\": {\"d\": \"x\\\\\"}}  ";
+    JsonReader    reader(json);
+    Array<String> tokens;
+    while (!reader.isDone()) {
+        tokens.pushBack(reader.getNextToken());
+    }
+    CHECK(tokens == Array<String> {"{", "\"a\"", ":", "[", "1.5e3", ",", "-2", ",", "true", ",", "null", "]",
+                                   ",", "\"b\\\"c\"", ":", "{", "\"d\"", ":", "\"x\\\\\"", "}", "}"});
+
+    // Long strings and whitespace runs, crossing the blocks scanned at once
+    const String longString = String(std::string(100, 'a')) + "\\\"" + String(std::string(50, 'b'));
+    const String whitespace = String(std::string(70, ' '));
+    const String newlines   = String(std::string(40, '\n'));
+    const String padded     = "{" + whitespace + "\"" + longString + "\"" + newlines + ":1}";
+    JsonReader   paddedReader(padded);
+    paddedReader.getNextTokenChecked("{");
+    CHECK(paddedReader.getNextToken() == "\"" + longString + "\"");
+    paddedReader.getNextTokenChecked(":");
+    CHECK(paddedReader.getNextToken() == "1");
+    paddedReader.getNextTokenChecked("}");
+    CHECK(paddedReader.isDone());
+
+    const String unterminatedString = "\"abc" + String(std::string(40, 'd'));
+    JsonReader   unterminated(unterminatedString);
+    CHECK_THROWS(unterminated.getNextToken());
+
+    JsonReader skipping(R"([{"a": [1, {"b": "]"}]}, 2] 3)");
+    skipping.skipValue();
+    CHECK(skipping.getNextToken() == "3");
+}
+
+namespace {
+/// Documents shaped like the usual JSON parsing corpora, which are too large to be kept in the repository
+struct JsonCorpus {
+    const char* name;
+    String      json;
+};
+
+/// Like canada.json: mostly floating point coordinates
+String makeNumbersCorpus() {
+    StringBuilder output;
+    output << R"({"type": "FeatureCollection", "features": [{"type": "Feature", "geometry": )"
+           << R"({"type": "Polygon", "coordinates": [)";
+    for (const int ring : range(100)) {
+        output << (ring > 0 ? ",[" : "[");
+        for (const int i : range(2000)) {
+            output << (i > 0 ? ",[" : "[") << -65.613616999999977 + i * 0.000137 << ","
+                   << 43.420273000000009 - ring * 0.0217 << "]";
+        }
+        output << "]";
+    }
+    output << "]}}]}";
+    return output.toString();
+}
+
+/// Like twitter.json: objects with many strings, some of them escaped or non-ASCII
+String makeTextCorpus() {
+    StringBuilder output;
+    output << R"({"statuses": [)";
+    for (const int i : range(10'000)) {
+        output << (i > 0 ? ", {" : "{") << R"("id": )" << 505874924095815681ll + i
+               << R"(, "text": "RT @user)" << i
+               << R"(: Příliš žluťoučký kůň úpěl ďábelské ódy, \"quoted\" text\nwith a newline A", )"
+               << R"("user": {"name": "Some User", "screen_name": "user)" << i
+               << R"(", "description": "A longer description of the user, which is a usual part of )"
+               << R"(the data", )"
+               << R"("followers_count": )" << i * 7 << R"(, "verified": false}, "retweeted": false, )"
+               << R"("entities": {"hashtags": [], "urls": [], "user_mentions": [{"screen_name": "other"}]}, )"
+               << R"("lang": "cs"})";
+    }
+    output << "]}";
+    return output.toString();
+}
+
+/// Like citm_catalog.json: pretty printed nested objects with integers and short strings
+String makeNestedCorpus() {
+    StringBuilder output;
+    output << "{\n    \"events\": {\n";
+    for (const int i : range(20'000)) {
+        output << (i > 0 ? ",\n" : "") << "        \"" << 138586341 + i << "\": {\n"
+               << "            \"description\": null,\n"
+               << "            \"id\": " << 138586341 + i << ",\n"
+               << "            \"name\": \"Event " << i << "\",\n"
+               << "            \"subTopicIds\": [\n                337184269,\n                337184283\n"
+               << "            ],\n            \"topicIds\": [\n                324846099,\n"
+               << "                107888604\n            ]\n        }";
+    }
+    output << "\n    }\n}";
+    return output.toString();
+}
+} // namespace
+
+TEST_CASE("parseJson benchmark" * doctest::skip()) {
+    const JsonCorpus corpora[] = {
+        {"numbers (canada.json-like)",      makeNumbersCorpus()},
+        {"text (twitter.json-like)",        makeTextCorpus()   },
+        {"nested (citm_catalog.json-like)", makeNestedCorpus() },
+    };
+    constexpr int REPEATS = 5;
+    for (const JsonCorpus& corpus : corpora) {
+        const double megabytes = double(corpus.json.size()) * REPEATS / 1'000'000.0;
+
+        Timer timer;
+        for ([[maybe_unused]] const int i : range(REPEATS)) {
+            CHECK(parseJson(corpus.json));
+        }
+        const double parseSpeed = megabytes / timer.getElapsed().toSeconds();
+
+        timer.reset();
+        int64 tokens = 0;
+        for ([[maybe_unused]] const int i : range(REPEATS)) {
+            JsonReader reader(corpus.json);
+            while (!reader.isDone()) {
+                reader.getNextToken();
+                ++tokens;
+            }
+        }
+        const double tokenizeSpeed = megabytes / timer.getElapsed().toSeconds();
+        std::cout << corpus.name << ", " << corpus.json.size() / 1000 << " kB: parseJson " << int(parseSpeed)
+                  << " MB/s, JsonReader " << int(tokenizeSpeed) << " MB/s (" << tokens / REPEATS << " tokens)"
+                  << std::endl;
+    }
+}
+
 BUFF_NAMESPACE_END
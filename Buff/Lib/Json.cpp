@@ -2,15 +2,22 @@
 #include "Lib/containers/SmallArray.h"
 #include "Lib/Exception.h"
 #include "Lib/Function.h"
+#include "Lib/Simd.h"
+#include "Lib/StringBuilder.h"
+#include <array>
 
 BUFF_NAMESPACE_BEGIN
 
-static String indent(const Optional<int> indentation) {
-    String result;
-    for (int i = 0; i < indentation.valueOr(0); ++i) {
-        result << "    ";
-    }
-    return result;
+static void appendIndent(StringBuilder& output, const Optional<int> indentation) {
+    output.appendRepeated(' ', 4 * indentation.valueOr(0));
+}
+
+/// Writes the value into a fresh builder and assembles the result
+template <typename T>
+static String toJsonString(const T& value, const Optional<int> indentation) {
+    StringBuilder output;
+    value.appendJson(output, indentation);
+    return output.toString();
 }
 
 // ===========================================================================================================
@@ -42,26 +49,31 @@ void JsObject::visitAllValues(const Function<void(const String&, const JsValue&)
 }
 
 String JsObject::toJson(const Optional<int> indentation) const {
+    return toJsonString(*this, indentation);
+}
+
+void JsObject::appendJson(StringBuilder& output, const Optional<int> indentation) const {
     // TODO: Seems unquoted keys are only allowed in JSON5: https://en.wikipedia.org/wiki/JSON#JSON5
-    // auto isValidKey = [](const StringView identifier) {
-    //    // TODO: Improve - allow numbers for example
-    //    return std::ranges::all_of(identifier, [](const char c) { return isLetter(c) || c == '_'; });
-    //};
-    const String        newline         = indentation ? "\n" : "";
     const Optional<int> indentationNext = indentation ? Optional(*indentation + 1) : NULL_OPTIONAL;
-    return "{" + newline +
-           listToStr(mValues,
-                     ","_S + (indentation ? "\n" : " "),
-                     [&](const auto& pair) {
-                         String result;
-                         if (indentation) {
-                             result << indent(indentationNext);
-                         }
-                         result << /*(isValidKey(pair.first) ? pair.first :*/ pair.first.getQuoted() /*)*/ +
-                                       ": " + pair.second.toJson(indentationNext);
-                         return result;
-                     }) +
-           newline + indent(indentation) + "}";
+    output << '{';
+    if (indentation) {
+        output << '\n';
+    }
+    bool first = true;
+    for (const auto& [key, value] : mValues) {
+        if (!first) {
+            output << (indentation ? ",\n" : ", ");
+        }
+        first = false;
+        appendIndent(output, indentationNext);
+        output << '"' << key << "\": ";
+        value.appendJson(output, indentationNext);
+    }
+    if (indentation) {
+        output << '\n';
+    }
+    appendIndent(output, indentation);
+    output << '}';
 }
 
 // ===========================================================================================================
@@ -97,21 +109,24 @@ JsValue& JsArray::peek() {
 }
 
 String JsArray::toJson(const Optional<int> indentation) const {
-    String result       = "[";
-    int    currentIndex = 0;
+    return toJsonString(*this, indentation);
+}
+
+void JsArray::appendJson(StringBuilder& output, const Optional<int> indentation) const {
+    output << '[';
+    int currentIndex = 0;
     for (auto& [index, value] : mValues) {
         while (currentIndex < index) {
-            result << "undefined, ";
+            output << (currentIndex > 0 ? ", undefined" : "undefined");
             ++currentIndex;
         }
-        result << value.toJson(indentation) << ", ";
+        if (currentIndex > 0) {
+            output << ", ";
+        }
+        value.appendJson(output, indentation);
         ++currentIndex;
     }
-    if (mValues.notEmpty()) {
-        BUFF_ASSERT(result[result.size() - 2] == ',');
-        result.erase(result.size() - 2);
-    }
-    return result + "]";
+    output << ']';
 }
 
 void JsArray::visitAllValues(const Function<void(int64, const JsValue&)>& functor) const {
@@ -147,13 +162,21 @@ JsValue& JsValue::peek() {
 }
 
 String JsValue::toJson(const Optional<int> indentation) const {
-    return mImpl.visit([](const Undefined BUFF_UNUSED(x)) { return String("undefined"); },
-                       [](const Null BUFF_UNUSED(x)) { return String("null"); },
-                       [](const bool x) { return String(x ? "true" : "false"); },
-                       [](const double x) { return toStr(x); },
-                       [](const String& x) { return escapeJson(x).getQuoted(); },
-                       [&](const JsArray& x) { return x.toJson(indentation); },
-                       [&](const JsObject& x) { return x.toJson(indentation); });
+    return toJsonString(*this, indentation);
+}
+
+void JsValue::appendJson(StringBuilder& output, const Optional<int> indentation) const {
+    mImpl.visit([&](const Undefined BUFF_UNUSED(x)) { output << "undefined"; },
+                [&](const Null BUFF_UNUSED(x)) { output << "null"; },
+                [&](const bool x) { output << (x ? "true" : "false"); },
+                [&](const double x) { output.appendFormatted(x); },
+                [&](const String& x) {
+                    output << '"';
+                    appendEscapedJson(output, x);
+                    output << '"';
+                },
+                [&](const JsArray& x) { x.appendJson(output, indentation); },
+                [&](const JsObject& x) { x.appendJson(output, indentation); });
 }
 
 const Array<std::pair<char, String>> JSON_ESCAPE_PAIRS = {
@@ -167,25 +190,34 @@ const Array<std::pair<char, String>> JSON_ESCAPE_PAIRS = {
 };
 
 String escapeJson(const StringView str) {
-    String result;
-    for (const unsigned char ch : str) {
-        if (ch < ' ' || ch == anyOf('\\', '\"')) {
-            bool found = false;
-            for (const auto& [from, to] : JSON_ESCAPE_PAIRS) {
-                if (ch == from) {
-                    result << to;
-                    found = true;
-                    break;
-                }
-            }
-            if (!found) {
-                result << "\\u" << leftPad(toStrHexadecimal(int(ch)), 4, '0');
+    StringBuilder output(str.size() + 16);
+    appendEscapedJson(output, str);
+    return output.toString();
+}
+
+void appendEscapedJson(StringBuilder& output, const StringView str) {
+    // Runs of characters which do not need escaping are appended at once
+    int runStart = 0;
+    for (const int i : range(str.size())) {
+        const unsigned char ch = str[i];
+        if (ch >= ' ' && ch != anyOf('\\', '\"')) {
+            continue;
+        }
+        output << str.getSubstring(runStart, i - runStart);
+        runStart   = i + 1;
+        bool found = false;
+        for (const auto& [from, to] : JSON_ESCAPE_PAIRS) {
+            if (ch == from) {
+                output << to;
+                found = true;
+                break;
             }
-        } else {
-            result << ch;
+        }
+        if (!found) {
+            output << "\\u" << leftPad(toStrHexadecimal(int(ch)), 4, '0');
         }
     }
-    return result;
+    output << str.getSubstring(runStart);
 }
 
 String unEscapeJson(const StringView str) {
@@ -231,96 +263,159 @@ String unEscapeJson(const StringView str) {
 // parseJson
 // ===========================================================================================================
 
-class Reader {
-    StringView mStr;
-    int        mPos = 0;
+namespace {
+/// Classes of characters which decide where tokens end, a character can be in more than one
+enum JsonCharacterClass : uint8 {
+    JSON_WHITESPACE  = 1 << 0,
+    JSON_PUNCTUATION = 1 << 1,
+    /// Continues a keyword
+    JSON_LETTER = 1 << 2,
+    /// Starts a number
+    JSON_NUMBER_START = 1 << 3,
+};
+} // namespace
 
-public:
-    explicit Reader(const StringView& str)
-        : mStr(str) {
-        skipWhitespace();
+static constexpr std::array<uint8, 256> JSON_CHARACTER_CLASSES = [] {
+    std::array<uint8, 256> result {};
+    // Same as std::isspace in the "C" locale
+    for (const char c : {' ', '\t', '\n', '\v', '\f', '\r'}) {
+        result[uint8(c)] |= JSON_WHITESPACE;
     }
-    bool isDone() const {
-        return mPos == mStr.size();
+    for (const char c : {'{', '}', '[', ']', ',', ':'}) {
+        result[uint8(c)] |= JSON_PUNCTUATION;
     }
+    for (int c = 'a'; c <= 'z'; ++c) {
+        result[c] |= JSON_LETTER;
+        result[c - 'a' + 'A'] |= JSON_LETTER;
+    }
+    for (int c = '0'; c <= '9'; ++c) {
+        result[c] |= JSON_NUMBER_START;
+    }
+    result['-'] |= JSON_NUMBER_START;
+    return result;
+}();
 
-    StringView getNextToken() {
-        if (isDone()) {
-            throw Exception("Unexpected EOF");
+static bool isJsonCharacter(const char c, const uint8 classes) {
+    return (JSON_CHARACTER_CLASSES[uint8(c)] & classes) != 0;
+}
+
+/// Index of the first character at or after from which is not whitespace, or size if there is none. Tokens
+/// are mostly separated by no or a single whitespace character, longer runs (indentation) are skipped a block
+/// at a time.
+static int findNonWhitespace(const char* data, int from, const int size) {
+    if (from == size || !isJsonCharacter(data[from], JSON_WHITESPACE)) {
+        return from;
+    }
+    ++from;
+    const Simd::Block WHITESPACE[] = {Simd::Block::broadcast(' '),
+                                      Simd::Block::broadcast('\n'),
+                                      Simd::Block::broadcast('\t'),
+                                      Simd::Block::broadcast('\r'),
+                                      Simd::Block::broadcast('\v'),
+                                      Simd::Block::broadcast('\f')};
+    constexpr uint64 FULL_MASK = (uint64(1) << Simd::Block::SIZE) - 1;
+    for (; from + Simd::Block::SIZE <= size; from += Simd::Block::SIZE) {
+        const Simd::Block block      = Simd::Block::load(data + from);
+        uint              whitespace = 0;
+        for (const Simd::Block& character : WHITESPACE) {
+            whitespace |= block.equalMask<1>(character);
         }
-        BUFF_ASSERT(!isWhitespace(mStr[mPos]));
-
-        int                                   count         = 1;
-        const char                            first         = get();
-        constexpr static StaticArray<char, 6> SINGLE_TOKENS = {'{', '}', '[', ']', ',', ':'};
-        if (SINGLE_TOKENS.contains(first)) {
-            // Done
-        } else if (first == '\"') { // String
-            while (true) {
-                const char next = get();
-                ++count;
-                if (next == '\\') {
-                    ++count;
-                    get(); // Read next char as escaped
-                } else if (next == '\"') {
-                    break;
-                }
-            }
-        } else if (std::isalpha(first)) { // keywords (null, true, false)
-            while (peekChar() && std::isalpha(*peekChar())) {
-                ++count;
-                get();
-            }
-        } else if (first == '-' || std::isdigit(first)) {
-            while (peekChar() && *peekChar() != anyOf(',', ']', '}', '\t', ' ', '\n')) {
-                ++count;
-                get();
-            }
+        if (const uint other = uint(~whitespace & FULL_MASK)) {
+            return from + Simd::lowestBit(other);
         }
-        const StringView result = mStr.getSubstring(mPos - count, count);
-        skipWhitespace();
-        return result;
     }
+    while (from < size && isJsonCharacter(data[from], JSON_WHITESPACE)) {
+        ++from;
+    }
+    return from;
+}
 
-    void getNextTokenChecked(const StringView value) {
-        const StringView token = getNextToken();
-        if (token != value) {
-            throw Exception("Expected " + value + ", got " + token);
+JsonReader::JsonReader(const StringView str)
+    : mStr(str) {
+    skipWhitespace();
+}
+
+StringView JsonReader::getNextToken() {
+    if (isDone()) {
+        throw Exception("Unexpected EOF");
+    }
+    BUFF_ASSERT(!isWhitespace(mStr[mPos]));
+
+    const char* data  = mStr.data();
+    const int   size  = mStr.size();
+    const int   begin = mPos;
+    const char  first = data[begin];
+    int         end   = begin + 1;
+    if (first == '\"') { // String
+        // Skips to the next quote or backslash a block at a time, most strings have no escapes
+        while (true) {
+            end += int(Simd::findFirstOf(data + end, size - end, "\"\\", 2));
+            if (end >= size) {
+                throw Exception("Unexpected EOF");
+            }
+            if (data[end] == '\"') {
+                ++end;
+                break;
+            }
+            end += 2; // Backslash and the escaped character
+        }
+    } else if (isJsonCharacter(first, JSON_LETTER)) { // keywords (null, true, false)
+        while (end < size && isJsonCharacter(data[end], JSON_LETTER)) {
+            ++end;
+        }
+    } else if (isJsonCharacter(first, JSON_NUMBER_START)) {
+        // Validated when parsed by from_chars
+        while (end < size && !isJsonCharacter(data[end], JSON_WHITESPACE | JSON_PUNCTUATION)) {
+            ++end;
         }
     }
+    // Otherwise a punctuation character, other characters are returned alone and rejected by the caller
+    mPos = end;
+    skipWhitespace();
+    return mStr.getSubstring(begin, end - begin);
+}
 
-    Optional<char> peekChar() const {
-        return isDone() ? Optional<char>() : Optional(mStr[mPos]);
+void JsonReader::getNextTokenChecked(const StringView value) {
+    const StringView token = getNextToken();
+    if (token != value) {
+        throw Exception("Expected " + value + ", got " + token);
     }
+}
 
-private:
-    void skipWhitespace() {
-        while (!isDone() && isWhitespace(mStr[mPos])) {
-            ++mPos;
-        }
-    }
-    char get() {
-        if (isDone()) {
-            throw Exception("Unexpected EOF");
+void JsonReader::skipValue() {
+    int depth = 0;
+    do {
+        const StringView token = getNextToken();
+        if (token[0] == anyOf('{', '[')) {
+            ++depth;
+        } else if (token[0] == anyOf('}', ']')) {
+            --depth;
+            if (depth < 0) {
+                throw Exception("Unexpected " + token);
+            }
         }
-        return mStr[mPos++];
-    }
-};
+    } while (depth > 0);
+}
 
-JsObject parseObject(Reader& reader);
-JsArray  parseArray(Reader& reader);
+void JsonReader::skipWhitespace() {
+    mPos = findNonWhitespace(mStr.data(), mPos, mStr.size());
+}
+
+JsObject parseObject(JsonReader& reader);
+JsArray  parseArray(JsonReader& reader);
 
-static String unescapeString(const StringView read) {
-    if (!read.startsWith("\"") || !read.endsWith("\"") || read.size() < 2) {
+String unescapeJsonString(const StringView token) {
+    if (!token.startsWith("\"") || !token.endsWith("\"") || token.size() < 2) {
         throw Exception("Wrong key format");
     }
-    return unEscapeJson(read.getSubstring(1, read.size() - 2));
+    const StringView content = token.getSubstring(1, token.size() - 2);
+    return content.contains("\\") ? unEscapeJson(content) : String(content);
 }
 
-static JsValue readValue(Reader& reader) {
+static JsValue readValue(JsonReader& reader) {
     const StringView token = reader.getNextToken();
     if (token[0] == '"') {
-        return unescapeString(token);
+        return unescapeJsonString(token);
     } else if (token[0] == '{') {
         return parseObject(reader);
     } else if (token[0] == '[') {
@@ -334,20 +429,15 @@ static JsValue readValue(Reader& reader) {
     } else if (token == "false") {
         return false;
     } else {
-#ifdef __EMSCRIPTEN__
-        // 2024-06 Still missing std::from_chars...
-        return std::atof(String(token).asCString());
-#else
-        double                       result;
-        const std::from_chars_result fromCharsResult =
-            std::from_chars(token.data(), token.data() + token.size(), result);
-        BUFF_ASSERT(fromCharsResult.ptr == token.data() + token.size());
-        return result;
-#endif
+        const Optional<double> number = fromStr<double>(token);
+        if (!number) {
+            throw Exception("Invalid number " + token);
+        }
+        return *number;
     }
 }
 
-JsObject parseObject(Reader& reader) {
+JsObject parseObject(JsonReader& reader) {
     JsObject result;
     bool     first = true;
     while (reader.peekChar() != '}') {
@@ -358,13 +448,13 @@ JsObject parseObject(Reader& reader) {
         }
         const StringView key = reader.getNextToken();
         reader.getNextTokenChecked(":");
-        result[unescapeString(key)] = readValue(reader);
+        result[unescapeJsonString(key)] = readValue(reader);
     }
     reader.getNextTokenChecked("}");
     return result;
 }
 
-JsArray parseArray(Reader& reader) {
+JsArray parseArray(JsonReader& reader) {
     JsArray result;
     bool    first = true;
     while (reader.peekChar() != ']') {
@@ -384,7 +474,7 @@ JsArray parseArray(Reader& reader) {
 }
 
 Optional<JsObject> parseJson(const StringView json) {
-    Reader reader(json);
+    JsonReader reader(json);
 
     try {
         reader.getNextTokenChecked("{");
@@ -12,13 +12,58 @@ BUFF_NAMESPACE_BEGIN
 template <typename T>
 class Function;
 class JsObject;
+class StringBuilder;
 
 /// Does not add enclosing " "!
 String escapeJson(StringView str);
+void   appendEscapedJson(StringBuilder& output, StringView str);
 String unEscapeJson(StringView str);
 
 Optional<JsObject> parseJson(StringView json);
 
+/// Cursor over the tokens of a JSON text. Reads the values in place, without building any JsValue, and can
+/// return to an earlier position.
+class JsonReader {
+    StringView mStr;
+    int        mPos = 0;
+
+public:
+    explicit JsonReader(StringView str);
+
+    bool isDone() const {
+        return mPos == mStr.size();
+    }
+
+    /// A whole string (including the quotes), number or keyword, or a single punctuation character. Throws
+    /// Exception at the end of the input.
+    StringView getNextToken();
+
+    /// Throws Exception when the next token is different
+    void getNextTokenChecked(StringView value);
+
+    /// Skips the next value, including all nested objects and arrays
+    void skipValue();
+
+    Optional<char> peekChar() const {
+        return isDone() ? Optional<char>() : Optional(mStr[mPos]);
+    }
+
+    int getPosition() const {
+        return mPos;
+    }
+    /// \param position Obtained from getPosition()
+    void setPosition(const int position) {
+        BUFF_ASSERT(position >= 0 && position <= mStr.size(), position);
+        mPos = position;
+    }
+
+private:
+    void skipWhitespace();
+};
+
+/// Unescaped content of a string token returned by JsonReader
+String unescapeJsonString(StringView token);
+
 class JsValue;
 
 class JsObject {
@@ -45,6 +90,7 @@ public:
     }
 
     String toJson(Optional<int> indentation = NULL_OPTIONAL) const;
+    void   appendJson(StringBuilder& output, Optional<int> indentation = NULL_OPTIONAL) const;
 
     void visitAllValues(const Function<void(const String&, const JsValue&)>& functor) const;
 };
@@ -76,6 +122,7 @@ public:
     JsValue&       peek();
 
     String toJson(Optional<int> indentation = NULL_OPTIONAL) const;
+    void   appendJson(StringBuilder& output, Optional<int> indentation = NULL_OPTIONAL) const;
 
     int64 numItems() const {
         return mValues.size();
@@ -229,6 +276,7 @@ public:
     }
 
     String toJson(Optional<int> indentation = NULL_OPTIONAL) const;
+    void   appendJson(StringBuilder& output, Optional<int> indentation = NULL_OPTIONAL) const;
 };
 
 BUFF_NAMESPACE_END
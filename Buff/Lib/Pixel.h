@@ -1,11 +1,12 @@
 #pragma once
 #include "Lib/Bootstrap.h"
 #include "Lib/Math.h"
+#include "Lib/Serialization.h"
 
 BUFF_NAMESPACE_BEGIN
 struct Vector2;
 
-struct Pixel {
+struct Pixel : BitwiseSerialization {
     int x = 0;
     int y = 0;
 
@@ -1,5 +1,6 @@
 #include "Lib/PoolAllocator.h"
 #include "Lib/Bootstrap.Test.h"
+#include "Lib/Thread.h"
 
 BUFF_NAMESPACE_BEGIN
 
@@ -45,4 +46,147 @@ TEST_CASE("Pool allocator reuse") {
     a.destruct(ptr2);
 }
 
+TEST_CASE("SizeClassAllocator hello world") {
+    SizeClassAllocator a;
+    Array<String*>     constructed;
+    for (const int i : range(1000)) {
+        constructed.pushBack(a.construct<String>(toStr(i)));
+    }
+    for (const int i : range(1000)) {
+        CHECK(*constructed[i] == toStr(i));
+    }
+    CHECK(a.getStatistics().liveAllocations == 1000);
+    CHECK(a.getStatistics().liveBytes >= 1000 * int64(sizeof(String)));
+    for (auto& i : constructed) {
+        a.destruct(i);
+    }
+    CHECK(a.getStatistics().liveAllocations == 0);
+    CHECK(a.getStatistics().liveBytes == 0);
+}
+
+TEST_CASE("SizeClassAllocator sizes") {
+    SizeClassAllocator a;
+    Array<std::pair<std::byte*, int64>> allocations;
+    for (const int64 size : {1, 8, 16, 17, 100, 1000, 2047, 2048, 2049, 100000}) {
+        std::byte* ptr = static_cast<std::byte*>(a.allocate(size));
+        CHECK(uint64(ptr) % SizeClassAllocator::MIN_ALIGNMENT == 0);
+        std::memset(ptr, int(size % 256), size);
+        allocations.pushBack({ptr, size});
+    }
+    for (const auto& [ptr, size] : allocations) {
+        CHECK(ptr[size - 1] == std::byte(size % 256));
+    }
+    const SizeClassAllocator::Statistics stats = a.getStatistics();
+    CHECK(stats.liveAllocations == 8);
+    CHECK(stats.liveLargeAllocations == 2);
+    CHECK(stats.liveLargeBytes == 2049 + 100000);
+    for (const auto& [ptr, size] : allocations) {
+        a.deallocate(ptr, size);
+    }
+    CHECK(a.getStatistics().liveLargeAllocations == 0);
+}
+
+TEST_CASE("SizeClassAllocator releaseUnused") {
+    SizeClassAllocator a;
+    CHECK(a.releaseUnused() == 0);
+    Array<int64*> allocated;
+    for (const int i : range(100000)) {
+        allocated.pushBack(a.construct<int64>(i));
+    }
+    const SizeClassAllocator::Statistics full = a.getStatistics();
+    CHECK(full.chunkCount > 1);
+    CHECK(full.reservedBytes >= 100000 * 16);
+
+    // Keep one allocation alive, its chunk must survive
+    for (const int i : range(1, 100000)) {
+        a.destruct(allocated[i]);
+    }
+    const int64 released = a.releaseUnused();
+    CHECK(released > 0);
+    const SizeClassAllocator::Statistics afterRelease = a.getStatistics();
+    CHECK(afterRelease.chunkCount == 1);
+    CHECK(afterRelease.reservedBytes == full.reservedBytes - released);
+    CHECK(*allocated[0] == 0);
+
+    // The remaining chunk is still usable
+    int64* reused = a.construct<int64>(42);
+    CHECK(*reused == 42);
+    CHECK(a.getStatistics().chunkCount == 1);
+    a.destruct(reused);
+    a.destruct(allocated[0]);
+    a.releaseUnused();
+    CHECK(a.getStatistics().chunkCount == 0);
+}
+
+TEST_CASE("SizeClassAllocator multithreaded") {
+    SizeClassAllocator a;
+    constexpr int      NUM_THREADS = 8;
+    constexpr int      NUM_ITEMS   = 20000;
+    Array<Array<int*>> produced(NUM_THREADS);
+    {
+        Array<Thread> threads;
+        for (const int t : range(NUM_THREADS)) {
+            threads.pushBack(Thread([&, t] {
+                for (const int i : range(NUM_ITEMS)) {
+                    produced[t].pushBack(a.construct<int>(t * NUM_ITEMS + i));
+                    if (i % 3 == 0) {
+                        a.destruct(produced[t].popBack());
+                    }
+                }
+            }));
+        }
+    }
+    // Free from different threads than the ones which allocated
+    {
+        Array<Thread> threads;
+        for (const int t : range(NUM_THREADS)) {
+            threads.pushBack(Thread([&, t] {
+                for (int* i : produced[(t + 1) % NUM_THREADS]) {
+                    BUFF_ASSERT(*i / NUM_ITEMS == (t + 1) % NUM_THREADS);
+                    a.destruct(i);
+                }
+            }));
+        }
+    }
+    CHECK(a.getStatistics().liveAllocations == 0);
+}
+
+TEST_CASE("PoolAllocatedSharedPtr") {
+    PoolAllocator<PoolAllocatedSharedPtr<String>::Record> a(4);
+    {
+        PoolAllocatedSharedPtr<String> ptr(a, "abc");
+        PoolAllocatedSharedPtr<String> copy = ptr;
+        CHECK(copy == ptr);
+        CHECK(*copy == "abc");
+        ptr = PoolAllocatedSharedPtr<String>();
+        CHECK(!ptr);
+        CHECK(*copy == "abc");
+        copy = copy;
+        CHECK(*copy == "abc");
+    }
+}
+
+TEST_CASE("PoolAllocatedSharedPtr atomic") {
+    using Ptr = PoolAllocatedSharedPtr<String, ReferenceCounting::ATOMIC>;
+    SizeClassAllocator a;
+    {
+        Ptr        ptr(a, "shared");
+        Array<Ptr> copies;
+        {
+            Array<Thread> threads;
+            for ([[maybe_unused]] const int t : range(4)) {
+                threads.pushBack(Thread([ptr] {
+                    for ([[maybe_unused]] const int i : range(10000)) {
+                        Ptr copy = ptr;
+                        BUFF_ASSERT(*copy == "shared");
+                    }
+                }));
+            }
+        }
+        CHECK(*ptr == "shared");
+        CHECK(a.getStatistics().liveAllocations == 1);
+    }
+    CHECK(a.getStatistics().liveAllocations == 0);
+}
+
 BUFF_NAMESPACE_END
@@ -0,0 +1,442 @@
+#include "Lib/PoolAllocator.h"
+#include "Lib/containers/Array.h"
+#include "Lib/Math.h"
+#include "Lib/Platform.h"
+#include <array>
+#include <mutex>
+
+BUFF_NAMESPACE_BEGIN
+
+// ===========================================================================================================
+// Size classes
+// ===========================================================================================================
+
+static constexpr int64 CHUNK_SIZE = 64 * 1024;
+
+/// Start of each chunk, blocks follow after it. Chunks are aligned to CHUNK_SIZE, so the header of any block
+/// can be found by masking its address.
+struct ChunkHeader {
+    int   sizeClass;
+    int   blockCount;
+    int64 freeCount; // Scratch space for releaseUnused()
+};
+static constexpr int64 CHUNK_HEADER_SIZE = 64;
+static_assert(sizeof(ChunkHeader) <= CHUNK_HEADER_SIZE);
+
+static constexpr int SIZE_CLASSES[]  = {16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024, 1536, 2048};
+static constexpr int NUM_SIZE_CLASSES = int(std::size(SIZE_CLASSES));
+static_assert(SIZE_CLASSES[NUM_SIZE_CLASSES - 1] == SizeClassAllocator::MAX_SMALL_SIZE);
+
+/// Maps (size + 15) / 16 to the index of the smallest size class which can hold it
+static constexpr std::array<uint8, SizeClassAllocator::MAX_SMALL_SIZE / 16 + 1> SIZE_CLASS_LOOKUP = [] {
+    std::array<uint8, SizeClassAllocator::MAX_SMALL_SIZE / 16 + 1> result {};
+    int                                                            sizeClass = 0;
+    for (int i = 0; i < int(result.size()); ++i) {
+        while (SIZE_CLASSES[sizeClass] < i * 16) {
+            ++sizeClass;
+        }
+        result[i] = uint8(sizeClass);
+    }
+    return result;
+}();
+
+static int getSizeClass(const int64 size) {
+    BUFF_ASSERT(size > 0 && size <= SizeClassAllocator::MAX_SMALL_SIZE, size);
+    return SIZE_CLASS_LOOKUP[(size + 15) / 16];
+}
+
+/// Number of blocks moved between a thread cache and the depot at once
+static int getBatchSize(const int sizeClass) {
+    return clamp(4096 / SIZE_CLASSES[sizeClass], 2, 64);
+}
+
+// ===========================================================================================================
+// Depot
+// ===========================================================================================================
+
+namespace {
+
+/// Overlaid over the memory of a free block
+struct FreeBlock {
+    /// Next block in the same batch or thread cache
+    FreeBlock* next;
+
+    /// Only valid in the first block of a batch stored in the depot
+    FreeBlock* nextBatch;
+};
+static_assert(sizeof(FreeBlock) <= 16);
+
+/// Treiber stack of batches. The head pointer is packed with a counter incremented by every modification so
+/// that a pop racing with pop+push of the same block fails instead of corrupting the stack (ABA problem).
+class BatchStack {
+    static constexpr int    POINTER_BITS = sizeof(void*) == 8 ? 48 : 32;
+    static constexpr uint64 POINTER_MASK = (uint64(1) << POINTER_BITS) - 1;
+
+    std::atomic<uint64> mHead = 0;
+
+    static FreeBlock* getPointer(const uint64 packed) {
+        return reinterpret_cast<FreeBlock*>(std::uintptr_t(packed & POINTER_MASK));
+    }
+    static uint64 pack(FreeBlock* pointer, const uint64 previous) {
+        const uint64 tag = (previous >> POINTER_BITS) + 1;
+        BUFF_ASSERT((uint64(std::uintptr_t(pointer)) & ~POINTER_MASK) == 0);
+        return (tag << POINTER_BITS) | uint64(std::uintptr_t(pointer));
+    }
+
+public:
+    void push(FreeBlock* batch) {
+        BUFF_ASSERT(batch);
+        uint64 head = mHead.load(std::memory_order_relaxed);
+        do {
+            batch->nextBatch = getPointer(head);
+        } while (!mHead.compare_exchange_weak(head,
+                                              pack(batch, head),
+                                              std::memory_order_release,
+                                              std::memory_order_relaxed));
+    }
+
+    FreeBlock* pop() {
+        uint64 head = mHead.load(std::memory_order_acquire);
+        while (FreeBlock* top = getPointer(head)) {
+            // top may be concurrently popped and handed out to the user, in which case we read garbage here.
+            // The tag then no longer matches and the exchange fails.
+            FreeBlock* next = top->nextBatch;
+            if (mHead.compare_exchange_weak(head,
+                                            pack(next, head),
+                                            std::memory_order_acquire,
+                                            std::memory_order_acquire)) {
+                return top;
+            }
+        }
+        return nullptr;
+    }
+
+    /// Returns all batches linked through nextBatch
+    FreeBlock* popAll() {
+        uint64 head = mHead.load(std::memory_order_acquire);
+        while (!mHead.compare_exchange_weak(head,
+                                            pack(nullptr, head),
+                                            std::memory_order_acquire,
+                                            std::memory_order_acquire)) {
+        }
+        return getPointer(head);
+    }
+};
+
+// ===========================================================================================================
+// Thread caches
+// ===========================================================================================================
+
+/// Caches of threads with index above this limit are not used, such threads talk to the depot directly
+constexpr int MAX_CACHED_THREADS = 64;
+
+/// Index of the calling thread into the per-allocator cache arrays, shared by all allocators. Indices of
+/// finished threads are recycled - the new thread simply inherits the free blocks the old one cached.
+class ThreadIndex {
+    int mIndex;
+
+    struct Registry {
+        std::mutex mutex;
+        Array<int> freeIndices;
+        int        nextIndex = 0;
+    };
+    static Registry& getRegistry() {
+        static Registry sRegistry;
+        return sRegistry;
+    }
+
+public:
+    ThreadIndex() {
+        Registry&                   registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        if (registry.freeIndices.notEmpty()) {
+            mIndex = registry.freeIndices.popBack();
+        } else if (registry.nextIndex < MAX_CACHED_THREADS) {
+            mIndex = registry.nextIndex++;
+        } else {
+            mIndex = -1;
+        }
+    }
+    ~ThreadIndex() {
+        if (mIndex != -1) {
+            Registry&                   registry = getRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            registry.freeIndices.pushBack(mIndex);
+        }
+    }
+
+    /// Returns -1 when the thread does not get a cache
+    static int get() {
+        thread_local const ThreadIndex sIndex;
+        return sIndex.mIndex;
+    }
+};
+
+/// Allocation counters are only ever written by their owning thread, so they do not need read-modify-write
+/// atomics, only atomic loads/stores to be readable by getStatistics().
+void increment(std::atomic<int64>& counter) {
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+struct alignas(64) ThreadCache {
+    struct PerClass {
+        FreeBlock*         head  = nullptr;
+        int                count = 0;
+        std::atomic<int64> allocations {0};
+        std::atomic<int64> deallocations {0};
+    };
+    PerClass classes[NUM_SIZE_CLASSES];
+};
+
+} // namespace
+
+// ===========================================================================================================
+// SizeClassAllocator
+// ===========================================================================================================
+
+struct SizeClassAllocator::Impl {
+    BatchStack  depot[NUM_SIZE_CLASSES];
+    ThreadCache caches[MAX_CACHED_THREADS];
+
+    /// Counters of threads without a cache
+    std::atomic<int64> uncachedAllocations[NUM_SIZE_CLASSES]   = {};
+    std::atomic<int64> uncachedDeallocations[NUM_SIZE_CLASSES] = {};
+
+    std::atomic<int64> largeAllocations = 0;
+    std::atomic<int64> largeBytes       = 0;
+
+    /// Guards creating and releasing chunks
+    mutable std::mutex  chunksMutex;
+    Array<ChunkHeader*> chunks;
+
+    static ChunkHeader* getChunk(const FreeBlock* block) {
+        return reinterpret_cast<ChunkHeader*>(std::uintptr_t(block) & ~std::uintptr_t(CHUNK_SIZE - 1));
+    }
+
+    /// Links count blocks starting at head into a batch, returns the first block after it
+    static FreeBlock* splitBatch(FreeBlock* head, const int count) {
+        BUFF_ASSERT(count > 0);
+        FreeBlock* last = head;
+        for (int i = 1; i < count; ++i) {
+            last = last->next;
+        }
+        FreeBlock* rest = last->next;
+        last->next      = nullptr;
+        return rest;
+    }
+
+    /// Allocates a new chunk, pushes all its blocks to the depot as batches
+    void createChunk(const int sizeClass) {
+        const int    blockSize  = SIZE_CLASSES[sizeClass];
+        const int    blockCount = int((CHUNK_SIZE - CHUNK_HEADER_SIZE) / blockSize);
+        auto*        chunk      = static_cast<ChunkHeader*>(alignedMalloc(CHUNK_SIZE, int(CHUNK_SIZE)));
+        ChunkHeader* header     = new (chunk) ChunkHeader {sizeClass, blockCount, 0};
+        {
+            std::lock_guard<std::mutex> lock(chunksMutex);
+            chunks.pushBack(header);
+        }
+        std::byte* const firstBlock = reinterpret_cast<std::byte*>(chunk) + CHUNK_HEADER_SIZE;
+        FreeBlock*       head       = nullptr;
+        for (int i = blockCount - 1; i >= 0; --i) {
+            FreeBlock* block = reinterpret_cast<FreeBlock*>(firstBlock + int64(i) * blockSize);
+            block->next      = head;
+            head             = block;
+        }
+        pushBatches(sizeClass, head);
+    }
+
+    /// Cuts the list into batches of the class batch size and pushes them to the depot
+    void pushBatches(const int sizeClass, FreeBlock* head) {
+        const int batchSize = getBatchSize(sizeClass);
+        while (head) {
+            FreeBlock* batch = head;
+            int        count = 1;
+            while (count < batchSize && head->next) {
+                head = head->next;
+                ++count;
+            }
+            FreeBlock* rest = head->next;
+            head->next      = nullptr;
+            depot[sizeClass].push(batch);
+            head = rest;
+        }
+    }
+
+    FreeBlock* popBatch(const int sizeClass) {
+        while (true) {
+            if (FreeBlock* batch = depot[sizeClass].pop()) {
+                return batch;
+            }
+            createChunk(sizeClass);
+        }
+    }
+
+    void refill(const int sizeClass, ThreadCache::PerClass& cache) {
+        BUFF_ASSERT(!cache.head && cache.count == 0);
+        cache.head = popBatch(sizeClass);
+        for (const FreeBlock* it = cache.head; it; it = it->next) {
+            ++cache.count;
+        }
+    }
+
+    void flush(const int sizeClass, ThreadCache::PerClass& cache, const int keep) {
+        const int batchSize = getBatchSize(sizeClass);
+        while (cache.count > keep) {
+            const int  count = min(batchSize, cache.count - keep);
+            FreeBlock* batch = cache.head;
+            cache.head       = splitBatch(batch, count);
+            cache.count -= count;
+            depot[sizeClass].push(batch);
+        }
+    }
+};
+
+SizeClassAllocator::SizeClassAllocator()
+    : mImpl(ALLOCATE_DEFAULT_CONSTRUCTED) {}
+
+SizeClassAllocator::~SizeClassAllocator() {
+    BUFF_ASSERT(getStatistics().liveAllocations == 0, getStatistics().liveAllocations);
+    BUFF_ASSERT(mImpl->largeAllocations == 0, mImpl->largeAllocations.load());
+    for (ChunkHeader* chunk : mImpl->chunks) {
+        alignedFree(chunk);
+    }
+}
+
+void* SizeClassAllocator::allocate(const int64 size) {
+    BUFF_ASSERT(size > 0, size);
+    if (size > MAX_SMALL_SIZE) {
+        ++mImpl->largeAllocations;
+        mImpl->largeBytes += size;
+        // aligned_alloc requires the size to be a multiple of the alignment
+        return alignedMalloc(alignUp(size, MIN_ALIGNMENT), MIN_ALIGNMENT);
+    }
+    const int sizeClass   = getSizeClass(size);
+    const int threadIndex = ThreadIndex::get();
+    if (threadIndex == -1) {
+        ++mImpl->uncachedAllocations[sizeClass];
+        FreeBlock* batch = mImpl->popBatch(sizeClass);
+        if (batch->next) {
+            mImpl->depot[sizeClass].push(batch->next);
+        }
+        return batch;
+    }
+    ThreadCache::PerClass& cache = mImpl->caches[threadIndex].classes[sizeClass];
+    if (!cache.head) {
+        mImpl->refill(sizeClass, cache);
+    }
+    FreeBlock* block = cache.head;
+    cache.head       = block->next;
+    --cache.count;
+    increment(cache.allocations);
+    return block;
+}
+
+void SizeClassAllocator::deallocate(void* ptr, const int64 size) {
+    BUFF_ASSERT(ptr && size > 0, size);
+    if (size > MAX_SMALL_SIZE) {
+        --mImpl->largeAllocations;
+        mImpl->largeBytes -= size;
+        alignedFree(ptr);
+        return;
+    }
+    const int sizeClass = getSizeClass(size);
+    FreeBlock* block    = static_cast<FreeBlock*>(ptr);
+    BUFF_ASSERT(Impl::getChunk(block)->sizeClass == sizeClass, "Deallocating with a different size");
+    const int threadIndex = ThreadIndex::get();
+    if (threadIndex == -1) {
+        ++mImpl->uncachedDeallocations[sizeClass];
+        block->next = nullptr;
+        mImpl->depot[sizeClass].push(block);
+        return;
+    }
+    ThreadCache::PerClass& cache = mImpl->caches[threadIndex].classes[sizeClass];
+    block->next                  = cache.head;
+    cache.head                   = block;
+    ++cache.count;
+    increment(cache.deallocations);
+    if (cache.count >= 2 * getBatchSize(sizeClass)) {
+        mImpl->flush(sizeClass, cache, getBatchSize(sizeClass));
+    }
+}
+
+int64 SizeClassAllocator::releaseUnused() {
+    if (const int threadIndex = ThreadIndex::get(); threadIndex != -1) {
+        for (int sizeClass = 0; sizeClass < NUM_SIZE_CLASSES; ++sizeClass) {
+            mImpl->flush(sizeClass, mImpl->caches[threadIndex].classes[sizeClass], 0);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mImpl->chunksMutex);
+    for (ChunkHeader* chunk : mImpl->chunks) {
+        chunk->freeCount = 0;
+    }
+
+    // Take everything out of the depot and count free blocks per chunk
+    FreeBlock* freeBlocks[NUM_SIZE_CLASSES];
+    for (int sizeClass = 0; sizeClass < NUM_SIZE_CLASSES; ++sizeClass) {
+        FreeBlock* all = nullptr;
+        for (FreeBlock* batch = mImpl->depot[sizeClass].popAll(); batch;) {
+            FreeBlock* nextBatch = batch->nextBatch;
+            FreeBlock* last      = batch;
+            while (true) {
+                ++Impl::getChunk(last)->freeCount;
+                if (!last->next) {
+                    break;
+                }
+                last = last->next;
+            }
+            last->next = all;
+            all        = batch;
+            batch      = nextBatch;
+        }
+        freeBlocks[sizeClass] = all;
+    }
+
+    // Put back blocks of chunks which stay alive
+    for (int sizeClass = 0; sizeClass < NUM_SIZE_CLASSES; ++sizeClass) {
+        FreeBlock* kept = nullptr;
+        for (FreeBlock* block = freeBlocks[sizeClass]; block;) {
+            FreeBlock* next = block->next;
+            if (const ChunkHeader* chunk = Impl::getChunk(block); chunk->freeCount != chunk->blockCount) {
+                block->next = kept;
+                kept        = block;
+            }
+            block = next;
+        }
+        mImpl->pushBatches(sizeClass, kept);
+    }
+
+    int64 released = 0;
+    mImpl->chunks.eraseIf([&](ChunkHeader* chunk) {
+        if (chunk->freeCount == chunk->blockCount) {
+            alignedFree(chunk);
+            released += CHUNK_SIZE;
+            return true;
+        }
+        return false;
+    });
+    return released;
+}
+
+SizeClassAllocator::Statistics SizeClassAllocator::getStatistics() const {
+    Statistics result;
+    {
+        std::lock_guard<std::mutex> lock(mImpl->chunksMutex);
+        result.chunkCount    = mImpl->chunks.size();
+        result.reservedBytes = result.chunkCount * CHUNK_SIZE;
+    }
+    for (int sizeClass = 0; sizeClass < NUM_SIZE_CLASSES; ++sizeClass) {
+        int64 live = mImpl->uncachedAllocations[sizeClass] - mImpl->uncachedDeallocations[sizeClass];
+        for (const ThreadCache& cache : mImpl->caches) {
+            live += cache.classes[sizeClass].allocations.load(std::memory_order_relaxed) -
+                    cache.classes[sizeClass].deallocations.load(std::memory_order_relaxed);
+        }
+        result.liveAllocations += live;
+        result.liveBytes += live * SIZE_CLASSES[sizeClass];
+    }
+    result.liveLargeAllocations = mImpl->largeAllocations;
+    result.liveLargeBytes       = mImpl->largeBytes;
+    return result;
+}
+
+BUFF_NAMESPACE_END
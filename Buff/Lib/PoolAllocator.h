@@ -1,9 +1,11 @@
 #pragma once
+#include "Lib/AutoPtr.h"
 #include "Lib/Bootstrap.h"
 #include "Lib/containers/StableArray.h"
 #include "Lib/containers/StaticArray.h"
 #include "Lib/Math.h"
 #include "Lib/Utils.h"
+#include <atomic>
 
 BUFF_NAMESPACE_BEGIN
 
@@ -37,12 +39,94 @@ public:
     }
 };
 
-template <typename T>
+/// General-purpose allocator for small objects of any type, safe to use from multiple threads at once.
+///
+/// Requests are rounded up to one of a fixed set of size classes. Each class is served from 64 KiB chunks
+/// carved into equally sized blocks. Every thread has its own cache of free blocks per class, so the common
+/// allocate/deallocate path touches no shared state. Caches exchange whole batches of blocks with a shared
+/// lock-free depot when they run empty or overflow. Requests larger than the biggest size class go directly
+/// to alignedMalloc().
+///
+/// Blocks are aligned to MIN_ALIGNMENT. A block may be freed by a different thread than the one that
+/// allocated it.
+class SizeClassAllocator : public Noncopyable {
+    struct Impl;
+    AutoPtr<Impl> mImpl;
+
+public:
+    static constexpr int MIN_ALIGNMENT = 16;
+
+    /// Largest request served from the size classes, anything bigger goes to alignedMalloc()
+    static constexpr int64 MAX_SMALL_SIZE = 2048;
+
+    struct Statistics {
+        /// Chunks currently held by the allocator, including those with no live allocations
+        int64 chunkCount    = 0;
+        int64 reservedBytes = 0;
+
+        /// Small allocations which were not deallocated yet, and the sum of their size classes
+        int64 liveAllocations = 0;
+        int64 liveBytes       = 0;
+
+        /// Allocations above MAX_SMALL_SIZE which were not deallocated yet
+        int64 liveLargeAllocations = 0;
+        int64 liveLargeBytes       = 0;
+    };
+
+    SizeClassAllocator();
+
+    /// All allocations must be deallocated before the allocator is destroyed
+    ~SizeClassAllocator();
+
+    void* allocate(int64 size);
+
+    /// \param size Must be the same size that was passed to allocate()
+    void deallocate(void* ptr, int64 size);
+
+    template <typename T, typename... TConstructorArgs>
+    T* construct(TConstructorArgs&&... args) requires ConstructibleFrom<T, TConstructorArgs...> {
+        static_assert(alignof(T) <= MIN_ALIGNMENT, "Over-aligned types are not supported");
+        void* memory = allocate(sizeof(T));
+        try {
+            return new (memory) T(std::forward<TConstructorArgs>(args)...);
+        } catch (...) {
+            deallocate(memory, sizeof(T));
+            throw;
+        }
+    }
+
+    /// T must be the exact type that was constructed, not its base class
+    template <typename T>
+    void destruct(const T* object) {
+        object->~T();
+        deallocate(const_cast<T*>(object), sizeof(T));
+    }
+
+    /// Returns chunks without any live allocations back to the system. Returns the number of bytes freed.
+    ///
+    /// Free blocks cached by other threads keep their chunks alive. Not safe to call while other threads are
+    /// using this allocator (e.g. call it between frames).
+    int64 releaseUnused();
+
+    /// Is thread safe, but the result is only a snapshot when other threads are using the allocator
+    Statistics getStatistics() const;
+};
+
+/// Selects how PoolAllocatedSharedPtr counts references. ATOMIC lets copies of the pointer be created and
+/// destroyed from multiple threads, the records are then allocated from the thread-safe SizeClassAllocator.
+enum class ReferenceCounting {
+    SINGLE_THREADED,
+    ATOMIC,
+};
+
+template <typename T, ReferenceCounting TReferenceCounting = ReferenceCounting::SINGLE_THREADED>
 class PoolAllocatedSharedPtr {
+    static constexpr bool ATOMIC = TReferenceCounting == ReferenceCounting::ATOMIC;
+
 public:
     struct Record {
-        T     value;
-        int64 referenceCount;
+        T                                                     value;
+        std::conditional_t<ATOMIC, std::atomic<int64>, int64> referenceCount;
 
         template <typename... TConstructorArgs>
         explicit Record(TConstructorArgs&&... args) requires ConstructibleFrom<T, TConstructorArgs...>
@@ -50,9 +134,11 @@ public:
             , referenceCount(1) {}
     };
 
+    using Allocator = std::conditional_t<ATOMIC, SizeClassAllocator, PoolAllocator<Record>>;
+
 private:
-    PoolAllocator<Record>* mAllocator;
-    Record*                mPtr;
+    Allocator* mAllocator;
+    Record*    mPtr;
 
 public:
     PoolAllocatedSharedPtr()
@@ -60,10 +146,10 @@ public:
         , mPtr(nullptr) {}
 
     template <typename... TConstructorArgs>
-    explicit PoolAllocatedSharedPtr(PoolAllocator<Record>& allocator, TConstructorArgs&&... args)
+    explicit PoolAllocatedSharedPtr(Allocator& allocator, TConstructorArgs&&... args)
         requires ConstructibleFrom<T, TConstructorArgs...>
         : mAllocator(&allocator)
-        , mPtr(allocator.construct(std::forward<TConstructorArgs>(args)...)) {}
+        , mPtr(constructRecord(allocator, std::forward<TConstructorArgs>(args)...)) {}
 
     ~PoolAllocatedSharedPtr() {
         dealloc();
@@ -76,11 +162,13 @@ public:
         }
     }
     PoolAllocatedSharedPtr& operator=(const PoolAllocatedSharedPtr& other) {
-        dealloc();
-        mAllocator = other.mAllocator;
-        mPtr       = other.mPtr;
-        if (mPtr) {
-            ++mPtr->referenceCount;
+        if (this != &other) {
+            dealloc();
+            mAllocator = other.mAllocator;
+            mPtr       = other.mPtr;
+            if (mPtr) {
+                ++mPtr->referenceCount;
+            }
         }
         return *this;
     }
@@ -112,14 +200,23 @@ public:
     }
 
 private:
+    template <typename... TConstructorArgs>
+    static Record* constructRecord(Allocator& allocator, TConstructorArgs&&... args) {
+        if constexpr (ATOMIC) {
+            return allocator.template construct<Record>(std::forward<TConstructorArgs>(args)...);
+        } else {
+            return allocator.construct(std::forward<TConstructorArgs>(args)...);
+        }
+    }
+
     void dealloc() {
         if (mPtr) {
-            if (mPtr->referenceCount == 1) {
+            BUFF_ASSERT(mPtr->referenceCount > 0);
+            // Also correct for the atomic variant: the decrement returns the new value, only one owner sees 0
+            if (--mPtr->referenceCount == 0) {
                 mAllocator->destruct(mPtr);
-            } else {
-                --mPtr->referenceCount;
-                BUFF_ASSERT(mPtr->referenceCount > 0);
             }
+            mPtr = nullptr;
         }
     }
 };
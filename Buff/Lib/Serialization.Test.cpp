@@ -1,6 +1,16 @@
 #include "Lib/Serialization.h"
+#include "Lib/containers/Array.h"
+#include "Lib/containers/Array2D.h"
+#include "Lib/containers/ArrayView.h"
+#include "Lib/containers/StaticArray.h"
 #include "Lib/AutoPtr.h"
+#include "Lib/Function.h"
+#include "Lib/Optional.h"
+#include "Lib/StringBuilder.h"
 #include "Lib/Bootstrap.Test.h"
+#include "Lib/Time.h"
+#include "Lib/Vector.h"
+#include <iostream>
 
 BUFF_NAMESPACE_BEGIN
 
@@ -71,7 +81,7 @@ TEST_CASE("BinarySerializer::String") {
 }
 
 struct SerializablePolymorphicType : public Polymorphic {
-    BUFF_REGISTER_FOR_POLYMORPHIC_SERIALIZATION(SerializablePolymorphicType);
+    BUFF_REGISTER_FOR_POLYMORPHIC_SERIALIZATION(SerializablePolymorphicType, "Test.PolymorphicType");
     int  x = 0;
     void serializeCustom(ISerializer& serializer) const {
         serializer.serialize(x, "x");
@@ -83,7 +93,7 @@ struct SerializablePolymorphicType : public Polymorphic {
         : x(x) {}
 };
 struct SerializablePolymorphicType2 : public Polymorphic {
-    BUFF_REGISTER_FOR_POLYMORPHIC_SERIALIZATION(SerializablePolymorphicType2);
+    BUFF_REGISTER_FOR_POLYMORPHIC_SERIALIZATION(SerializablePolymorphicType2, "Test.PolymorphicType2");
     double x = 0;
     void   serializeCustom(ISerializer& serializer) const {
         serializer.serialize(x, "x");
@@ -121,4 +131,604 @@ TEST_CASE("BinarySerializer::polymorphic") {
     CHECK(dynamic_cast<SerializablePolymorphicType2&>(*resPtr).x == -1.5);
 }
 
+TEST_CASE("BinarySerializer::polymorphic type IDs") {
+    BinarySerializer serializer;
+    serializer.serialize(AutoPtr<Polymorphic>(makeAutoPtr<SerializablePolymorphicType>(5)), "ptr");
+    // hasValue, type ID and x, the class name is not stored
+    const BinarySerializationState& state = serializer.getState();
+    CHECK(state.size() == 1 + sizeof(uint) + sizeof(int));
+    uint typeId = 0;
+    std::memcpy(&typeId, state.data() + 1, sizeof(typeId));
+    CHECK(typeId == Detail::getSerializedNameHash("Test.PolymorphicType"));
+    static_assert(Detail::getSerializedNameHash("") == 2166136261u);
+
+    BinarySerializationState unknown = state;
+    unknown[1] ^= std::byte(1);
+    BinaryDeserializer   deserializer(unknown);
+    AutoPtr<Polymorphic> res;
+    CHECK_THROWS(deserializer.deserialize(res, "ptr"));
+}
+
+static_assert(BitwiseSerializable<int>);
+static_assert(BitwiseSerializable<Pixel>);
+static_assert(BitwiseSerializable<Vector2>);
+static_assert(!BitwiseSerializable<String>);
+static_assert(!BitwiseSerializable<SType>);
+
+TEST_CASE("BinarySerializer::bitwise lists") {
+    // The bytes are the same as when serializing the elements one by one
+    const Array<int16> numbers = {1, -2, 3, 1000};
+    BinarySerializer   bulk;
+    bulk.serialize(numbers, "numbers");
+    BinarySerializer oneByOne;
+    oneByOne.serialize(numbers.size(), "size");
+    for (const int16 number : numbers) {
+        oneByOne.serialize(number, "number");
+    }
+    CHECK(bulk.getState() == oneByOne.getState());
+
+    Array2D<Pixel> pixels(3, 2);
+    for (const int64 i : range(pixels.getPixelCount())) {
+        pixels.getNthPixel(i) = Pixel(int(i), -int(i));
+    }
+    const Array<Vector2>        vectors = {Vector2(1.f, 2.f), Vector2(-3.f, 0.5f)};
+    const StaticArray<uint8, 3> bytes   = {7, 8, 9};
+    const Array<String>         strings = {"a", "", "bcd"};
+
+    BinarySerializer serializer;
+    serializer.serialize(numbers, "numbers");
+    serializer.serialize(pixels, "pixels");
+    serializer.serialize(vectors, "vectors");
+    serializer.serialize(bytes, "bytes");
+    serializer.serialize(strings, "strings");
+    serializer.serialize(Array<float>(), "empty");
+
+    BinaryDeserializer    deserializer(serializer.getState());
+    Array<int16>          numbers2;
+    Array2D<Pixel>        pixels2;
+    Array<Vector2>        vectors2;
+    StaticArray<uint8, 3> bytes2;
+    Array<String>         strings2;
+    Array<float>          empty2 = {1.f};
+    deserializer.deserialize(numbers2, "numbers");
+    deserializer.deserialize(pixels2, "pixels");
+    deserializer.deserialize(vectors2, "vectors");
+    deserializer.deserialize(bytes2, "bytes");
+    deserializer.deserialize(strings2, "strings");
+    deserializer.deserialize(empty2, "empty");
+    CHECK(numbers2 == numbers);
+    CHECK(pixels2.size() == Pixel(3, 2));
+    CHECK(pixels2(2, 1) == pixels(2, 1));
+    CHECK(vectors2[1].x == -3.f);
+    CHECK(vectors2[1].y == 0.5f);
+    CHECK(bytes2 == bytes);
+    CHECK(strings2 == strings);
+    CHECK(empty2.isEmpty());
+
+    // Not enough data for the claimed size
+    BinarySerializationState truncated = bulk.getState();
+    truncated.pop_back();
+    BinaryDeserializer truncatedDeserializer(truncated);
+    CHECK_THROWS(truncatedDeserializer.deserialize(numbers2, "numbers"));
+}
+
+TEST_CASE("BinaryDeserializer views") {
+    const Array<float> floats = {1.f, 2.f, 3.f};
+    BinarySerializer   serializer;
+    serializer.serialize(String("abcd"), "string");
+    serializer.serialize(floats, "floats");
+    serializer.serialize(String("x"), "string");
+    serializer.serialize(floats, "floats");
+    serializer.serialize(int64(5), "number");
+
+    // Reads from a buffer owned by the caller
+    const Array<std::byte> buffer(ArrayView<const std::byte>(serializer.getState().data(),
+                                                             int64(serializer.getState().size())));
+    const char*            bufferStart = reinterpret_cast<const char*>(buffer.data());
+    BinaryDeserializer     deserializer(buffer);
+    const StringView       string = deserializer.deserializeStringView("string");
+    CHECK(string == "abcd");
+    CHECK(string.data() == bufferStart + sizeof(int));
+
+    // 4 + 4 + 8 bytes precede the first list, so it is aligned
+    const Optional<ArrayView<const float>> view = deserializer.deserializeArrayView<float>("floats");
+    REQUIRE(view);
+    CHECK(*view == ArrayView<const float>(floats));
+    CHECK(reinterpret_cast<const char*>(view->data()) == bufferStart + 16);
+
+    // The second list is not, and can still be copied
+    deserializer.deserializeStringView("string");
+    CHECK_FALSE(deserializer.deserializeArrayView<float>("floats"));
+    Array<float> copy;
+    deserializer.deserialize(copy, "floats");
+    CHECK(copy == floats);
+    int64 number;
+    deserializer.deserialize(number, "number");
+    CHECK(number == 5);
+    CHECK_THROWS(deserializer.deserializeStringView("string"));
+}
+
+namespace {
+enum class Shape { CIRCLE, SQUARE };
+
+struct Particle {
+    Vector2 position;
+    float   mass  = 0.f;
+    Shape   shape = Shape::CIRCLE;
+    bool    alive = false;
+
+    void enumerateStructMembers(auto&& functor) {
+        functor(position, "position");
+        functor(mass, "mass");
+        functor(shape, "shape");
+        functor(alive, "alive");
+    }
+};
+
+struct World {
+    String          name;
+    Particle        first;
+    Array<Particle> particles;
+    Array<Vector2>  path;
+    int64           tick = 0;
+
+    void enumerateStructMembers(auto&& functor) {
+        functor(name, "name");
+        functor(first, "first");
+        functor(particles, "particles");
+        functor(path, "path");
+        functor(tick, "tick");
+    }
+};
+}
+
+static World createWorld(const int numParticles) {
+    World world;
+    world.name = "world";
+    world.tick = 123456789;
+    for (const int i : range(numParticles)) {
+        world.particles.pushBack(
+            Particle {Vector2(float(i), 2.f), 0.5f * float(i), Shape(i % 2), i % 3 == 0});
+        world.path.pushBack(Vector2(1.f, float(i)));
+    }
+    world.first = world.particles.front();
+    return world;
+}
+
+TEST_CASE("StaticBinaryWriter") {
+    const World world = createWorld(10);
+
+    // Same bytes as BinarySerializer
+    BinarySerializer serializer;
+    serializer.serialize(world, "world");
+    serializer.serialize(String("end"), "end");
+    StaticBinaryWriter writer;
+    writer.serialize(world, "world");
+    writer.serialize(String("end"), "end");
+    CHECK(writer.getState() == serializer.getState());
+
+    StaticBinaryReader reader(writer.getState());
+    World              world2;
+    String             end;
+    reader.deserialize(world2, "world");
+    reader.deserialize(end, "end");
+    CHECK(world2.name == "world");
+    CHECK(world2.tick == world.tick);
+    REQUIRE(world2.particles.size() == 10);
+    CHECK(world2.particles[3].position.x == 3.f);
+    CHECK(world2.particles[3].mass == 1.5f);
+    CHECK(world2.particles[3].shape == Shape::SQUARE);
+    CHECK(world2.particles[3].alive);
+    CHECK(world2.first.mass == 0.f);
+    REQUIRE(world2.path.size() == 10);
+    CHECK(world2.path[9].y == 9.f);
+    CHECK(end == "end");
+    CHECK_THROWS(reader.deserialize(end, "end"));
+
+    // Empty lists
+    StaticBinaryWriter emptyWriter;
+    emptyWriter.serialize(World(), "world");
+    StaticBinaryReader emptyReader(emptyWriter.getState());
+    emptyReader.deserialize(world2, "world");
+    CHECK(world2.particles.isEmpty());
+    CHECK(world2.path.isEmpty());
+}
+
+TEST_CASE("StaticBinaryWriter benchmark" * doctest::skip()) {
+    const World world = createWorld(1'000'000);
+
+    Timer            timer;
+    BinarySerializer serializer;
+    serializer.serialize(world, "world");
+    std::cout << "BinarySerializer: " << timer.getElapsed().getUserReadable() << std::endl;
+
+    timer.reset();
+    StaticBinaryWriter writer;
+    writer.serialize(world, "world");
+    std::cout << "StaticBinaryWriter: " << timer.getElapsed().getUserReadable() << std::endl;
+
+    World world2;
+    timer.reset();
+    BinaryDeserializer deserializer(serializer.getState());
+    deserializer.deserialize(world2, "world");
+    std::cout << "BinaryDeserializer: " << timer.getElapsed().getUserReadable() << std::endl;
+
+    timer.reset();
+    StaticBinaryReader reader(writer.getState());
+    reader.deserialize(world2, "world");
+    std::cout << "StaticBinaryReader: " << timer.getElapsed().getUserReadable() << std::endl;
+    CHECK(writer.getState() == serializer.getState());
+}
+
+TEST_CASE("BinarySerializer::compact format") {
+    const World      world = createWorld(100);
+    BinarySerializer fixed;
+    fixed.serialize(world, "world");
+    BinarySerializer compact(BinaryFormat::COMPACT);
+    compact.serialize(world, "world");
+    const Array<int64>          extremes         = {0, -1, 63, -64, 64, INT64_MAX, INT64_MIN};
+    const Array<uint64>         unsignedExtremes = {0, 127, 128, UINT64_MAX};
+    const StaticArray<bool, 10> bools = {true, false, true, true, false, false, true, true, false, true};
+    compact.serialize(extremes, "extremes");
+    compact.serialize(unsignedExtremes, "unsignedExtremes");
+    compact.serialize(bools, "bools");
+    compact.serialize(int8(-5), "byte");
+    CHECK(compact.getState().size() < fixed.getState().size());
+
+    BinaryDeserializer fixedDeserializer(fixed.getState());
+    CHECK(fixedDeserializer.getFormat() == BinaryFormat::FIXED);
+    BinaryDeserializer deserializer(compact.getState());
+    CHECK(deserializer.getFormat() == BinaryFormat::COMPACT);
+    World                 world2;
+    Array<int64>          extremes2;
+    Array<uint64>         unsignedExtremes2;
+    StaticArray<bool, 10> bools2;
+    int8                  byte = 0;
+    deserializer.deserialize(world2, "world");
+    deserializer.deserialize(extremes2, "extremes");
+    deserializer.deserialize(unsignedExtremes2, "unsignedExtremes");
+    deserializer.deserialize(bools2, "bools");
+    deserializer.deserialize(byte, "byte");
+    CHECK(world2.tick == world.tick);
+    REQUIRE(world2.particles.size() == 100);
+    CHECK(world2.particles[99].shape == Shape::SQUARE);
+    CHECK(world2.particles[99].alive);
+    CHECK(world2.particles[98].alive == false);
+    CHECK(world2.path[99].y == 99.f);
+    CHECK(extremes2 == extremes);
+    CHECK(unsignedExtremes2 == unsignedExtremes);
+    CHECK(bools2 == bools);
+    CHECK(byte == -5);
+
+    // Values too big for the deserialized type are rejected
+    BinarySerializer big(BinaryFormat::COMPACT);
+    big.serialize(int64(1) << 40, "value");
+    BinaryDeserializer bigDeserializer(big.getState());
+    int                value;
+    CHECK_THROWS(bigDeserializer.deserialize(value, "value"));
+
+    // Lists are not stored bitwise
+    BinaryDeserializer viewDeserializer(compact.getState());
+    viewDeserializer.deserialize(world2, "world");
+    CHECK_FALSE(viewDeserializer.deserializeArrayView<int64>("extremes"));
+    CHECK_THROWS(StaticBinaryReader(compact.getState()));
+}
+
+namespace {
+struct ItemV1 {
+    String name;
+    int    count = 0;
+
+    void enumerateStructMembers(auto&& functor) {
+        functor(name, "name");
+        functor(count, "count");
+    }
+};
+
+struct InventoryV1 {
+    Array<ItemV1>   items;
+    Optional<int64> owner;
+    Array<float>    weights;
+    float           removed = 0.f;
+
+    void enumerateStructMembers(auto&& functor) {
+        functor(items, "items");
+        functor(owner, "owner");
+        functor(weights, "weights");
+        functor(removed, "removed");
+    }
+};
+
+/// Members added, removed and reordered
+struct ItemV2 {
+    int    count = 0;
+    String name;
+    bool   added = true;
+
+    void enumerateStructMembers(auto&& functor) {
+        functor(count, "count");
+        functor(added, "added");
+        functor(name, "name");
+    }
+};
+
+struct InventoryV2 {
+    Array<float>    weights;
+    String          added = "default";
+    Optional<int64> owner;
+    Array<ItemV2>   items;
+
+    void enumerateStructMembers(auto&& functor) {
+        functor(weights, "weights");
+        functor(added, "added");
+        functor(owner, "owner");
+        functor(items, "items");
+    }
+};
+}
+
+TEST_CASE("BinarySerializer::tagged format") {
+    InventoryV1 inventory;
+    inventory.items   = {ItemV1 {"sword", 1}, ItemV1 {"arrow", 20}};
+    inventory.owner   = 7;
+    inventory.weights = {1.5f, 0.1f};
+    inventory.removed = 3.f;
+    BinarySerializer serializer(BinaryFormat::TAGGED);
+    serializer.serialize(inventory, "inventory");
+    serializer.serialize(String("after"), "after");
+
+    // Same schema
+    BinaryDeserializer deserializer(serializer.getState());
+    CHECK(deserializer.getFormat() == BinaryFormat::TAGGED);
+    InventoryV1 inventory1;
+    String      after;
+    deserializer.deserialize(inventory1, "inventory");
+    deserializer.deserialize(after, "after");
+    REQUIRE(inventory1.items.size() == 2);
+    CHECK(inventory1.items[1].name == "arrow");
+    CHECK(inventory1.items[1].count == 20);
+    CHECK(inventory1.owner == 7);
+    CHECK(inventory1.weights == inventory.weights);
+    CHECK(inventory1.removed == 3.f);
+    CHECK(after == "after");
+
+    // Newer schema, added members keep their values
+    BinaryDeserializer deserializer2(serializer.getState());
+    InventoryV2        inventory2;
+    deserializer2.deserialize(inventory2, "inventory");
+    deserializer2.deserialize(after, "after");
+    REQUIRE(inventory2.items.size() == 2);
+    CHECK(inventory2.items[0].name == "sword");
+    CHECK(inventory2.items[0].count == 1);
+    CHECK(inventory2.items[0].added);
+    CHECK(inventory2.added == "default");
+    CHECK(inventory2.owner == 7);
+    CHECK(inventory2.weights == inventory.weights);
+    CHECK(after == "after");
+
+    // And back, unknown fields are skipped
+    inventory2.items[0].added = false;
+    BinarySerializer serializer2(BinaryFormat::TAGGED);
+    serializer2.serialize(inventory2, "inventory");
+    BinaryDeserializer deserializer3(serializer2.getState());
+    InventoryV1        inventory3;
+    deserializer3.deserialize(inventory3, "inventory");
+    REQUIRE(inventory3.items.size() == 2);
+    CHECK(inventory3.items[1].name == "arrow");
+    CHECK(inventory3.owner == 7);
+    CHECK(inventory3.removed == 0.f);
+
+    // Truncated data
+    BinarySerializationState truncated = serializer.getState();
+    truncated.resize(truncated.size() - 10);
+    BinaryDeserializer truncatedDeserializer(truncated);
+    CHECK_THROWS(truncatedDeserializer.deserialize(inventory1, "inventory"));
+}
+
+namespace {
+/// Members are in alphabetical order, so that the written JSON is the same as from JsValue, which sorts them
+struct JsonWriterTestStruct {
+    bool   a = true;
+    Pixel  b = Pixel(1, -2);
+    String c = "\"quoted\"\n";
+    double d = 0.5;
+
+    void enumerateStructMembers(auto&& functor) {
+        functor(a, "a");
+        functor(b, "b");
+        functor(c, "c");
+        functor(d, "d");
+    }
+};
+}
+
+TEST_CASE("JsonSerializer::writer") {
+    const JsonWriterTestStruct  value;
+    const StaticArray<Pixel, 2> list = {Pixel(3), Pixel(4)};
+    for (const bool addNewlines : {false, true}) {
+        JsonSerializer treeSerializer;
+        treeSerializer.serialize(value, "s");
+        treeSerializer.serializeList(list, "t");
+
+        StringBuilder  output;
+        JsonSerializer serializer(output, addNewlines);
+        serializer.serialize(value, "s");
+        serializer.serializeList(list, "t");
+        serializer.finish();
+        CHECK(output.toString() == treeSerializer.getJson(addNewlines));
+    }
+
+    SUBCASE("sink") {
+        Array<int> ints(100'000);
+        for (const int64 i : range(ints.size())) {
+            ints[i] = int(i) * 1000;
+        }
+        String         json;
+        int            sinkCalls = 0;
+        JsonSerializer serializer(
+            [&](const StringView text) {
+                json += text;
+                ++sinkCalls;
+            },
+            false);
+        serializer.serialize(ints, "ints");
+        serializer.serialize(value, "value");
+        CHECK(!json.isEmpty()); // Passed to the sink before the end
+        serializer.finish();
+        CHECK(sinkCalls > 1);
+
+        JsonDeserializer deserializer(json);
+        Array<int>       ints2;
+        deserializer.deserialize(ints2, "ints");
+        CHECK(ints2 == ints);
+        JsonWriterTestStruct value2;
+        value2.c = "";
+        deserializer.deserialize(value2, "value");
+        CHECK(value2.c == value.c);
+        CHECK(value2.b == value.b);
+    }
+}
+
+TEST_CASE("JsonDeserializer::pull") {
+    JsonWriterTestStruct value;
+    value.b = Pixel(-7, 8);
+    value.c = "tab\t\"quote\"";
+    value.d = 1.25;
+    Array<Pixel> pixels;
+    for (const int i : range(100)) {
+        pixels.pushBack(Pixel(i, -i));
+    }
+    const int64 big = (1ll << 62) + 1;
+
+    auto check = [&](const String& json) {
+        JsonDeserializer     deserializer = JsonDeserializer::pull(json);
+        JsonWriterTestStruct value2;
+        value2.a = false;
+        Array<Pixel> pixels2;
+        int64        big2 = 0;
+        // Other order than serialized
+        deserializer.deserialize(big2, "big");
+        deserializer.deserialize(value2, "value");
+        deserializer.deserialize(pixels2, "pixels");
+        CHECK(value2.a == value.a);
+        CHECK(value2.b == value.b);
+        CHECK(value2.c == value.c);
+        CHECK(value2.d == value.d);
+        CHECK(pixels2 == pixels);
+        CHECK(big2 == big);
+    };
+
+    StringBuilder  output;
+    JsonSerializer serializer(output, true);
+    serializer.serialize(value, "value");
+    serializer.serialize(pixels, "pixels");
+    serializer.serialize(big, "big");
+    serializer.finish();
+    check(output.toString());
+
+    // Sorted members, integers written as doubles
+    JsonSerializer treeSerializer;
+    treeSerializer.serialize(value, "value");
+    treeSerializer.serialize(pixels, "pixels");
+    treeSerializer.serialize(big, "big");
+    const String         treeJson     = treeSerializer.getJson(false);
+    JsonDeserializer     deserializer = JsonDeserializer::pull(treeJson);
+    JsonWriterTestStruct value2;
+    deserializer.deserialize(value2, "value");
+    CHECK(value2.b == value.b);
+    CHECK(value2.c == value.c);
+
+    SUBCASE("missing and unknown members") {
+        const String json = R"({"value": {"unknown": [1, {"a": [true]}], "b": {"y": 6, "x": 5}, "d": 2e1}})";
+        JsonDeserializer     partial = JsonDeserializer::pull(json);
+        JsonWriterTestStruct result;
+        result.a = false;
+        partial.deserialize(result, "value");
+        CHECK(result.a == false);
+        CHECK(result.b == Pixel(5, 6));
+        CHECK(result.c == JsonWriterTestStruct().c);
+        CHECK(result.d == 20.0);
+        Array<int> ints = {1, 2};
+        partial.deserialize(ints, "ints");
+        CHECK(ints == Array<int> {1, 2});
+    }
+
+    SUBCASE("malformed") {
+        const String         json      = R"({"value": {"a": tru)";
+        JsonDeserializer     malformed = JsonDeserializer::pull(json);
+        JsonWriterTestStruct result;
+        CHECK_THROWS(malformed.deserialize(result, "value"));
+    }
+}
+
+TEST_CASE("JsonDeserializer::pull benchmark" * doctest::skip()) {
+    Array<Pixel> pixels(1'000'000);
+    for (const int64 i : range(pixels.size())) {
+        pixels[i] = Pixel(int(i), -int(i));
+    }
+    StringBuilder  output;
+    JsonSerializer serializer(output, false);
+    serializer.serialize(pixels, "pixels");
+    serializer.finish();
+    const String json = output.toString();
+
+    for (const bool pull : {false, true}) {
+        Timer            timer;
+        JsonDeserializer deserializer = pull ? JsonDeserializer::pull(json) : JsonDeserializer(json);
+        Array<Pixel>     result;
+        deserializer.deserialize(result, "pixels");
+        std::cout << (pull ? "Pull" : "Tree") << " deserialization of "
+                  << json.size() << " bytes took " << timer.getElapsed().getUserReadable() << std::endl;
+        CHECK(result == pixels);
+    }
+}
+
+TEST_CASE("BinarySerializer::polymorphic benchmark" * doctest::skip()) {
+    Array<AutoPtr<Polymorphic>> items(1'000'000);
+    for (const int64 i : range(items.size())) {
+        if (i % 2 == 0) {
+            items[i] = makeAutoPtr<SerializablePolymorphicType>(int(i));
+        } else {
+            items[i] = makeAutoPtr<SerializablePolymorphicType2>(double(i));
+        }
+    }
+
+    Timer            timer;
+    BinarySerializer serializer;
+    serializer.serialize(items, "items");
+    std::cout << "Serializing " << serializer.getState().size() << " bytes took "
+              << timer.getElapsed().getUserReadable() << std::endl;
+
+    timer.reset();
+    BinaryDeserializer deserializer(serializer.getState());
+    deserializer.deserialize(items, "items");
+    std::cout << "Deserializing took " << timer.getElapsed().getUserReadable() << std::endl;
+    CHECK(dynamic_cast<SerializablePolymorphicType2&>(*items.back()).x == 999'999.0);
+}
+
+TEST_CASE("BinarySerializer::bitwise lists benchmark" * doctest::skip()) {
+    Array<float> floats(10'000'000);
+    for (const int64 i : range(floats.size())) {
+        floats[i] = float(i);
+    }
+    Array2D<Vector2> vectors(2000, 2000);
+    for (const int64 i : range(vectors.getPixelCount())) {
+        vectors.getNthPixel(i) = Vector2(float(i), 1.f);
+    }
+
+    Timer            timer;
+    BinarySerializer serializer;
+    serializer.serialize(floats, "floats");
+    serializer.serialize(vectors, "vectors");
+    std::cout << "Serializing " << serializer.getState().size() << " bytes took "
+              << timer.getElapsed().getUserReadable() << std::endl;
+
+    timer.reset();
+    BinaryDeserializer deserializer(serializer.getState());
+    deserializer.deserialize(floats, "floats");
+    deserializer.deserialize(vectors, "vectors");
+    std::cout << "Deserializing took " << timer.getElapsed().getUserReadable() << std::endl;
+    CHECK(floats.back() == 9'999'999.f);
+}
+
 BUFF_NAMESPACE_END
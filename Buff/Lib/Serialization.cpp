@@ -1,11 +1,13 @@
 #include "Lib/Serialization.h"
+#include "Lib/containers/ArrayView.h"
+#include "Lib/containers/HashMap.h"
 #include "Lib/containers/Set.h"
 #include "Lib/Exception.h"
 #include "Lib/Function.h"
 #include "Lib/Json.h"
 #include "Lib/String.h"
+#include "Lib/StringBuilder.h"
 #include <functional>
-#include <map>
 
 BUFF_NAMESPACE_BEGIN
 
@@ -13,37 +15,72 @@ struct RegisteredClass {
     Function<Polymorphic*()>                                      constructor;
     Function<void(const Polymorphic*, ISerializer&, const char*)> serialize;
     Function<void(Polymorphic*, IDeserializer&, const char*)>     deserialize;
+    /// User-provided name, only for error messages
+    const char* name;
 };
 
 struct RegisteredClasses {
-    std::map<String, RegisteredClass> classes;
+    /// Type ID -> class
+    HashMap<uint, RegisteredClass> classes;
+    /// Type ID for each registered type. The same type may have multiple type_info objects when it is used
+    /// from multiple modules, those are found by comparing them.
+    HashMap<const std::type_info*, uint> typeIds;
 };
 
-static auto& registeredClasses() {
+static RegisteredClasses& registeredClasses() {
     static RegisteredClasses sClasses;
-    return sClasses.classes;
+    return sClasses;
 }
 
 void Detail::registerForPolymorphicSerializationImpl(
-    const char* name,
+    const char*           name,
+    const std::type_info& type,
     Polymorphic* (*constructor)(),
     void (*serializeT)(const Polymorphic*, ISerializer&, const char*),
     void (*deserializeT)(Polymorphic*, IDeserializer&, const char*)) {
-    BUFF_ASSERT(!registeredClasses().contains(String(name)));
-    registeredClasses()[name] = RegisteredClass {constructor, serializeT, deserializeT};
+    RegisteredClasses& registered = registeredClasses();
+    const uint         typeId     = getSerializedNameHash(name);
+    // Fails also when two names have the same hash, one of them has to be renamed
+    BUFF_ASSERT(!registered.classes.contains(typeId), name);
+    BUFF_ASSERT(!registered.typeIds.contains(&type), name);
+    registered.classes.insert(typeId, RegisteredClass {constructor, serializeT, deserializeT, name});
+    registered.typeIds.insert(&type, typeId);
 }
 
-void Detail::serializePolymorphicClass(const char* name, const Polymorphic& value, ISerializer& serializer) {
-    BUFF_ASSERT(registeredClasses().contains(name));
-    const auto& entry = registeredClasses().find(name)->second;
-    entry.serialize(&value, serializer, ("Polymorphic_"_S + name).asCString());
+static uint findTypeId(const std::type_info& type) {
+    const RegisteredClasses& registered = registeredClasses();
+    if (const uint* typeId = registered.typeIds.find(&type)) {
+        return *typeId;
+    }
+    for (auto& [registeredType, typeId] : registered.typeIds) {
+        if (*registeredType == type) {
+            return typeId;
+        }
+    }
+    BUFF_ASSERT(false, "Class not registered for polymorphic serialization", type.name());
+    BUFF_STOP;
 }
 
-Polymorphic* Detail::instantiatePolymorphicClass(const char* name, IDeserializer& deserializer) {
-    BUFF_ASSERT(registeredClasses().contains(name));
-    const auto&  entry  = registeredClasses().find(name)->second;
-    Polymorphic* result = entry.constructor();
-    entry.deserialize(result, deserializer, ("Polymorphic_"_S + name).asCString());
+void Detail::serializePolymorphicClass(const Polymorphic& value, ISerializer& serializer) {
+    const uint typeId = findTypeId(typeid(value));
+    serializer.serialize(typeId, "typeId");
+    registeredClasses().classes.find(typeId)->serialize(&value, serializer, "value");
+}
+
+Polymorphic* Detail::instantiatePolymorphicClass(IDeserializer& deserializer) {
+    uint typeId = 0;
+    deserializer.deserialize(typeId, "typeId");
+    const RegisteredClass* entry = registeredClasses().classes.find(typeId);
+    if (!entry) {
+        throw Exception("Unknown polymorphic type ID " + toStr(typeId));
+    }
+    Polymorphic* result = entry->constructor();
+    try {
+        entry->deserialize(result, deserializer, "value");
+    } catch (...) {
+        delete result;
+        throw;
+    }
     return result;
 }
 
@@ -51,48 +88,348 @@ Polymorphic* Detail::instantiatePolymorphicClass(const char* name, IDeserializer
 // BinarySerializer/Deserializer
 // ===========================================================================================================
 
+/// Starts data in other than the fixed format, followed by the format. The bytes would be a negative size or
+/// an unlikely value in the fixed format, which has no header.
+static constexpr uint8 BINARY_HEADER_MAGIC[] = {0xFF, 'B', 'U', 0xFF, 'F', 'F', 0xFF};
+static_assert(sizeof(BINARY_HEADER_MAGIC) + 1 == Detail::BINARY_HEADER_SIZE);
+
+BinaryFormat Detail::getBinaryFormat(const ArrayView<const std::byte> bytes) {
+    constexpr int64 MAGIC_SIZE = sizeof(BINARY_HEADER_MAGIC);
+    if (bytes.size() <= MAGIC_SIZE || std::memcmp(bytes.data(), BINARY_HEADER_MAGIC, MAGIC_SIZE) != 0) {
+        return BinaryFormat::FIXED;
+    }
+    const auto format = BinaryFormat(bytes[MAGIC_SIZE]);
+    if (format != BinaryFormat::COMPACT && format != BinaryFormat::TAGGED) {
+        throw Exception("Unknown binary format " + toStr(int(format)));
+    }
+    return format;
+}
+
+/// Largest number of bytes of a LEB128 encoded 64-bit integer
+static constexpr int MAX_VARINT_SIZE = 10;
+
+static uint64 zigzagEncode(const int64 value) {
+    return (uint64(value) << 1) ^ uint64(value >> 63);
+}
+
+static int64 zigzagDecode(const uint64 value) {
+    return int64(value >> 1) ^ -int64(value & 1);
+}
+
+static uint64 loadCompactInteger(const void* data, const int size, const bool isSigned) {
+    if (isSigned) {
+        switch (size) {
+        case 2:
+            return zigzagEncode(*static_cast<const int16*>(data));
+        case 4:
+            return zigzagEncode(*static_cast<const int*>(data));
+        case 8:
+            return zigzagEncode(*static_cast<const int64*>(data));
+        default:
+            BUFF_STOP;
+        }
+    } else {
+        switch (size) {
+        case 2:
+            return *static_cast<const uint16*>(data);
+        case 4:
+            return *static_cast<const uint*>(data);
+        case 8:
+            return *static_cast<const uint64*>(data);
+        default:
+            BUFF_STOP;
+        }
+    }
+}
+
+template <typename T, typename TValue>
+static bool storeIfFits(void* data, const TValue value) {
+    *static_cast<T*>(data) = T(value);
+    return TValue(T(value)) == value;
+}
+
+/// \return False if the value does not fit into the given size
+static bool storeCompactInteger(void* data, const int size, const bool isSigned, const uint64 value) {
+    if (isSigned) {
+        const int64 decoded = zigzagDecode(value);
+        switch (size) {
+        case 2:
+            return storeIfFits<int16>(data, decoded);
+        case 4:
+            return storeIfFits<int>(data, decoded);
+        case 8:
+            return storeIfFits<int64>(data, decoded);
+        default:
+            BUFF_STOP;
+        }
+    } else {
+        switch (size) {
+        case 2:
+            return storeIfFits<uint16>(data, value);
+        case 4:
+            return storeIfFits<uint>(data, value);
+        case 8:
+            return storeIfFits<uint64>(data, value);
+        default:
+            BUFF_STOP;
+        }
+    }
+}
+
+/// Identifies a field of the tagged format. Stored in the data, so it must never change.
+static uint getTaggedFieldId(const char* name) {
+    return Detail::getSerializedNameHash(name);
+}
+
+/// Fills in the length of an object or a field, which is the number of bytes following it
+static void writeTaggedLength(BinarySerializationState& bytes, const int64 position) {
+    const int64 length = int64(bytes.size()) - position - int64(sizeof(uint));
+    if (length > int64(UINT_MAX)) {
+        throw Exception("Object too large for the tagged binary format");
+    }
+    const uint truncated = uint(length);
+    std::memcpy(bytes.data() + position, &truncated, sizeof(truncated));
+}
+
+BinarySerializer::BinarySerializer(const BinaryFormat format)
+    : mFormat(format) {
+    if (format != BinaryFormat::FIXED) {
+        const auto* magic = reinterpret_cast<const std::byte*>(BINARY_HEADER_MAGIC);
+        mBytes.insert(mBytes.end(), magic, magic + sizeof(BINARY_HEADER_MAGIC));
+        mBytes.push_back(std::byte(format));
+    }
+}
+
+void BinarySerializer::pushObject() {
+    if (mFormat == BinaryFormat::TAGGED) {
+        mTaggedObjects.push_back(TaggedObject {int64(mBytes.size())});
+        mBytes.resize(mBytes.size() + sizeof(uint));
+    }
+}
+
+void BinarySerializer::popObject() {
+    if (mFormat == BinaryFormat::TAGGED) {
+        closeTaggedField();
+        writeTaggedLength(mBytes, mTaggedObjects.back().start);
+        mTaggedObjects.pop_back();
+    }
+}
+
+void BinarySerializer::setPropertyName(const char* name) {
+    // Unnamed values, e.g. list items, and values outside of objects are positional
+    if (mFormat == BinaryFormat::TAGGED && name && !mTaggedObjects.empty()) {
+        closeTaggedField();
+        const uint  id    = getTaggedFieldId(name);
+        const auto* bytes = reinterpret_cast<const std::byte*>(&id);
+        mBytes.insert(mBytes.end(), bytes, bytes + sizeof(id));
+        mTaggedObjects.back().openField = int64(mBytes.size());
+        mBytes.resize(mBytes.size() + sizeof(uint));
+    }
+}
+
+void BinarySerializer::closeTaggedField() {
+    int64& openField = mTaggedObjects.back().openField;
+    if (openField != -1) {
+        writeTaggedLength(mBytes, openField);
+        openField = -1;
+    }
+}
+
 void BinarySerializer::serializePrimitive(const void*                                  data,
                                           const int                                    size,
                                           const Detail::PrimitiveSerializationCategory type) {
-    const int64 oldVectorSize = int64(mBytes.size());
-    if (type == Detail::PrimitiveSerializationCategory::STRING) {
+    using enum Detail::PrimitiveSerializationCategory;
+    if (type == STRING) {
         const String& string = *static_cast<const String*>(data);
-        serialize(string.size(), "size");
-        // Serialization category does not matter here:
+        // Not serialize(), which would make the size a field in the tagged format
+        const int stringSize = string.size();
+        serializePrimitive(&stringSize, sizeof(stringSize), INT);
+        // Written as raw bytes in all formats:
         serializePrimitive(string.asCString(), string.size(), Detail::PrimitiveSerializationCategory(-1));
+    } else if (mFormat == BinaryFormat::COMPACT && type == BOOL) {
+        if (mUsedBoolBits == 8) {
+            mBoolByte = int64(mBytes.size());
+            mBytes.push_back(std::byte(0));
+            mUsedBoolBits = 0;
+        }
+        if (*static_cast<const bool*>(data)) {
+            mBytes[mBoolByte] |= std::byte(1 << mUsedBoolBits);
+        }
+        ++mUsedBoolBits;
+    } else if (mFormat == BinaryFormat::COMPACT && (type == INT || type == UNSIGNED_INT) && size > 1) {
+        uint64 value = loadCompactInteger(data, size, type == INT);
+        while (value >= 0x80) {
+            mBytes.push_back(std::byte(value | 0x80));
+            value >>= 7;
+        }
+        mBytes.push_back(std::byte(value));
     } else {
-        mBytes.resize(mBytes.size() + size);
-        std::memcpy(mBytes.data() + oldVectorSize, data, size);
+        const auto* bytes = static_cast<const std::byte*>(data);
+        mBytes.insert(mBytes.end(), bytes, bytes + size);
     }
 }
 void BinarySerializer::serializeListImpl(const std::function<bool()>& itemFunctor) {
     while (itemFunctor()) {
     }
 }
+bool BinarySerializer::serializeBitwiseList(const void* data,
+                                            const int64 size,
+                                            const bool  primitiveElements) {
+    // Compact elements are not written as in memory, tagged structs have their members tagged
+    if (mFormat == BinaryFormat::COMPACT || (mFormat == BinaryFormat::TAGGED && !primitiveElements)) {
+        return false;
+    }
+    // Same bytes as serializing the elements one by one
+    const auto* bytes = static_cast<const std::byte*>(data);
+    mBytes.insert(mBytes.end(), bytes, bytes + size);
+    return true;
+}
+
+BinaryDeserializer::BinaryDeserializer(const ArrayView<const std::byte> serialized)
+    : mData(serialized.data())
+    , mSize(serialized.size()) {
+    readHeader();
+}
+
+void BinaryDeserializer::readHeader() {
+    mFormat = Detail::getBinaryFormat(ArrayView(mData, mSize));
+    if (mFormat != BinaryFormat::FIXED) {
+        mPtr = Detail::BINARY_HEADER_SIZE;
+    }
+}
+
+void BinaryDeserializer::pushObject() {
+    if (mFormat != BinaryFormat::TAGGED) {
+        return;
+    }
+    uint length;
+    deserializePrimitive(&length, sizeof(length), Detail::PrimitiveSerializationCategory::UNSIGNED_INT);
+    if (mSize - mPtr < length) {
+        throw Exception("Not enough data to deserialize");
+    }
+    const TaggedObject object {mPtr + length, int64(mTaggedFields.size()), int64(mTaggedFields.size())};
+    for (int64 ptr = mPtr; ptr < object.end;) {
+        uint header[2]; // id, length
+        if (object.end - ptr < int64(sizeof(header))) {
+            throw Exception("Invalid tagged field");
+        }
+        std::memcpy(header, mData + ptr, sizeof(header));
+        ptr += sizeof(header);
+        if (object.end - ptr < header[1]) {
+            throw Exception("Invalid tagged field");
+        }
+        mTaggedFields.push_back(TaggedField {header[0], ptr, ptr + header[1]});
+        ptr += header[1];
+    }
+    mTaggedObjects.push_back(object);
+}
+
+void BinaryDeserializer::popObject() {
+    if (mFormat == BinaryFormat::TAGGED) {
+        const TaggedObject& object = mTaggedObjects.back();
+        mPtr                       = object.end; // Skips unknown fields
+        mTaggedFields.resize(object.firstField);
+        mTaggedObjects.pop_back();
+    }
+}
+
+bool BinaryDeserializer::setPropertyName(const char* name) {
+    if (mFormat != BinaryFormat::TAGGED || !name || mTaggedObjects.empty()) {
+        return true;
+    }
+    TaggedObject& object    = mTaggedObjects.back();
+    const int64   numFields = int64(mTaggedFields.size()) - object.firstField;
+    const uint    id        = getTaggedFieldId(name);
+    // Fields are usually deserialized in the order they were serialized, so the search starts after the last
+    // found field
+    for (const int64 i : range(numFields)) {
+        const int64 index = object.firstField + (object.nextField - object.firstField + i) % numFields;
+        if (mTaggedFields[index].id == id) {
+            mPtr             = mTaggedFields[index].begin;
+            object.nextField = index + 1;
+            return true;
+        }
+    }
+    return false;
+}
+
+StringView BinaryDeserializer::deserializeStringView(const char* name) {
+    if (!setPropertyName(name)) {
+        throw Exception("Missing property "_S + name);
+    }
+    int size;
+    deserializePrimitive(&size, sizeof(size), Detail::PrimitiveSerializationCategory::INT);
+    if (size < 0) {
+        throw Exception("Negative size deserialization");
+    }
+    if (mSize - mPtr < size) {
+        throw Exception("Not enough data to deserialize");
+    }
+    const StringView result(reinterpret_cast<const char*>(mData) + mPtr, size);
+    mPtr += size;
+    return result;
+}
+
+const std::byte* BinaryDeserializer::deserializeBitwiseView(int64&      size,
+                                                            const int64 elementSize,
+                                                            const char* BUFF_UNUSED(name)) {
+    BUFF_ASSERT(mFormat == BinaryFormat::FIXED);
+    deserialize(size, "size");
+    if (size < 0) {
+        throw Exception("Negative size deserialization");
+    }
+    if ((mSize - mPtr) / elementSize < size) {
+        throw Exception("Not enough data to deserialize");
+    }
+    const std::byte* result = mData + mPtr;
+    mPtr += size * elementSize;
+    return result;
+}
 
 void BinaryDeserializer::deserializePrimitive(void*                                        data,
                                               int                                          size,
                                               const Detail::PrimitiveSerializationCategory type) {
+    using enum Detail::PrimitiveSerializationCategory;
     if (size < 0) {
         throw Exception("Negative size deserialization");
     }
-    if (type == Detail::PrimitiveSerializationCategory::STRING) {
+    if (type == STRING) {
         String& string = *static_cast<String*>(data);
-        deserialize(size, "size"); // Get actual size
-        if (size < 0) {
-            throw Exception("Negative size deserialization");
+        string         = deserializeStringView(nullptr);
+    } else if (mFormat == BinaryFormat::COMPACT && type == BOOL) {
+        if (mRemainingBoolBits == 0) {
+            if (mPtr == mSize) {
+                throw Exception("Not enough data to deserialize");
+            }
+            mBoolByte          = uint8(mData[mPtr++]);
+            mRemainingBoolBits = 8;
         }
-        if (int64(mBytes.size()) < mPtr + size) {
-            throw Exception("Not enough data to deserialize");
+        *static_cast<bool*>(data) = mBoolByte & 1;
+        mBoolByte >>= 1;
+        --mRemainingBoolBits;
+    } else if (mFormat == BinaryFormat::COMPACT && (type == INT || type == UNSIGNED_INT) && size > 1) {
+        uint64 value = 0;
+        for (int i = 0;; ++i) {
+            if (mPtr == mSize) {
+                throw Exception("Not enough data to deserialize");
+            }
+            if (i == MAX_VARINT_SIZE) {
+                throw Exception("Invalid varint");
+            }
+            const uint8 byte = uint8(mData[mPtr++]);
+            value |= uint64(byte & 0x7F) << (7 * i);
+            if (byte < 0x80) {
+                break;
+            }
+        }
+        if (!storeCompactInteger(data, size, type == INT, value)) {
+            throw Exception("Integer does not fit into " + toStr(size) + " bytes");
         }
-        const StringView view(reinterpret_cast<const char*>(mBytes.data()) + mPtr, size);
-        mPtr += size;
-        string = view;
     } else {
-        if (int64(mBytes.size()) < mPtr + size) {
+        if (mSize - mPtr < size) {
             throw Exception("Not enough data to deserialize");
         }
-        std::memcpy(data, mBytes.data() + mPtr, size);
+        std::memcpy(data, mData + mPtr, size);
         mPtr += size;
     }
 }
@@ -100,15 +437,171 @@ void BinaryDeserializer::deserializeListImpl(const std::function<bool()>& itemFu
     while (itemFunctor()) {
     }
 }
+bool BinaryDeserializer::deserializeBitwiseList(void*       data,
+                                                const int64 size,
+                                                const bool  primitiveElements) {
+    if (mFormat == BinaryFormat::COMPACT || (mFormat == BinaryFormat::TAGGED && !primitiveElements)) {
+        return false;
+    }
+    if (mSize - mPtr < size) {
+        throw Exception("Not enough data to deserialize");
+    }
+    if (size > 0) {
+        std::memcpy(data, mData + mPtr, size);
+    }
+    mPtr += size;
+    return true;
+}
+
+StaticBinaryReader::StaticBinaryReader(const ArrayView<const std::byte> serialized)
+    : mDeserializer(serialized) {
+    checkFormat();
+}
+
+void StaticBinaryReader::readString(String& value) {
+    value = mDeserializer.deserializeStringView(nullptr);
+}
+
+void StaticBinaryReader::checkFormat() {
+    if (mDeserializer.getFormat() != BinaryFormat::FIXED) {
+        throw Exception("StaticBinaryReader supports only the fixed binary format");
+    }
+}
+
+void StaticBinaryReader::throwError(const char* message) {
+    throw Exception(message);
+}
 
 // ===========================================================================================================
 // JsonSerializer
 // ===========================================================================================================
 
+/// Text collected before it is passed to the sink
+static constexpr int64 JSON_SINK_BUFFER_SIZE = 64 * 1024;
+
+namespace {
+/// Writes JSON text as the values arrive, in the same layout as JsValue::appendJson
+class JsonWriter {
+    struct Level {
+        bool isList;
+        bool isEmpty = true;
+        /// Indentation of the members (or items), lists have the same indentation as their items
+        int indentation;
+    };
+
+    StringBuilder* mOutput;
+    StringBuilder  mBuffer;
+    JsonSink       mSink;
+    bool           mAddNewlines;
+    Array<Level>   mLevels;
+
+public:
+    JsonWriter(StringBuilder* output, JsonSink sink, const bool addNewlines)
+        : mOutput(output ? output : &mBuffer)
+        , mSink(std::move(sink))
+        , mAddNewlines(addNewlines) {
+        // The root object
+        *mOutput << '{';
+        if (mAddNewlines) {
+            *mOutput << '\n';
+        }
+        mLevels.pushBack({.isList = false, .indentation = 1});
+    }
+
+    bool isFinished() const {
+        return mLevels.isEmpty();
+    }
+
+    void pushObject(const String& name) {
+        beginValue(name);
+        *mOutput << '{';
+        if (mAddNewlines) {
+            *mOutput << '\n';
+        }
+        mLevels.pushBack({.isList = false, .indentation = mLevels.back().indentation + 1});
+    }
+
+    void popObject() {
+        const Level level = mLevels.popBack();
+        BUFF_ASSERT(!level.isList);
+        if (mAddNewlines) {
+            *mOutput << '\n';
+            mOutput->appendRepeated(' ', 4 * (level.indentation - 1));
+        }
+        *mOutput << '}';
+        flushIfFull();
+    }
+
+    void pushList(const String& name) {
+        beginValue(name);
+        *mOutput << '[';
+        mLevels.pushBack({.isList = true, .indentation = mLevels.back().indentation});
+    }
+
+    void popList() {
+        BUFF_ASSERT(mLevels.back().isList);
+        mLevels.popBack();
+        *mOutput << ']';
+    }
+
+    template <typename T>
+    void writePrimitive(const String& name, const T& value) {
+        beginValue(name);
+        if constexpr (std::is_same_v<T, bool>) {
+            *mOutput << (value ? "true" : "false");
+        } else if constexpr (std::is_same_v<T, String>) {
+            *mOutput << '"';
+            appendEscapedJson(*mOutput, value);
+            *mOutput << '"';
+        } else {
+            mOutput->appendFormatted(value);
+        }
+        flushIfFull();
+    }
+
+    void finish() {
+        popObject();
+        BUFF_ASSERT(isFinished());
+        flush();
+    }
+
+private:
+    void beginValue(const String& name) {
+        Level& level = mLevels.back();
+        if (!level.isEmpty) {
+            *mOutput << (level.isList || !mAddNewlines ? ", " : ",\n");
+        }
+        level.isEmpty = false;
+        if (!level.isList) {
+            BUFF_ASSERT(!name.isEmpty());
+            if (mAddNewlines) {
+                mOutput->appendRepeated(' ', 4 * level.indentation);
+            }
+            *mOutput << '"' << name << "\": ";
+        }
+    }
+
+    void flushIfFull() {
+        if (mSink && mBuffer.size() >= JSON_SINK_BUFFER_SIZE) {
+            flush();
+        }
+    }
+
+    void flush() {
+        if (mSink && mBuffer.notEmpty()) {
+            mBuffer.forEachChunk([this](const StringView chunk) { mSink(chunk); });
+            mBuffer.clear();
+        }
+    }
+};
+} // namespace
+
 struct JsonSerializer::Impl {
     JsValue         root;
     Array<JsValue*> stack;
     String          currentName;
+    /// Set when writing the text directly, the tree is not built then
+    std::unique_ptr<JsonWriter> writer;
 
     Impl() {
         root = JsObject();
@@ -130,9 +623,24 @@ struct JsonSerializer::Impl {
 JsonSerializer::JsonSerializer()
     : mImpl(std::make_unique<Impl>()) {}
 
+JsonSerializer::JsonSerializer(StringBuilder& output, const bool addNewlines)
+    : mImpl(std::make_unique<Impl>()) {
+    mImpl->writer = std::make_unique<JsonWriter>(&output, JsonSink(), addNewlines);
+}
+
+JsonSerializer::JsonSerializer(JsonSink sink, const bool addNewlines)
+    : mImpl(std::make_unique<Impl>()) {
+    BUFF_ASSERT(sink);
+    mImpl->writer = std::make_unique<JsonWriter>(nullptr, std::move(sink), addNewlines);
+}
+
 JsonSerializer::~JsonSerializer() = default;
 
 void JsonSerializer::pushObject() {
+    if (mImpl->writer) {
+        mImpl->writer->pushObject(mImpl->currentName);
+        return;
+    }
     auto& back = *mImpl->stack.back();
     if (mImpl->isSerializingList()) {
         back.push(JsObject());
@@ -144,16 +652,32 @@ void JsonSerializer::pushObject() {
 }
 
 void JsonSerializer::popObject() {
-    mImpl->stack.popBack();
-    BUFF_ASSERT(mImpl->stack.notEmpty());
+    if (mImpl->writer) {
+        mImpl->writer->popObject();
+    } else {
+        mImpl->stack.popBack();
+        BUFF_ASSERT(mImpl->stack.notEmpty());
+    }
     setPropertyName(nullptr);
 }
 
 String JsonSerializer::getJson(const bool addNewlines) const {
+    BUFF_ASSERT(!mImpl->writer);
     BUFF_ASSERT(mImpl->stack.size() == 1);
     return mImpl->root.toJson(addNewlines ? Optional(0) : NULL_OPTIONAL);
 }
 
+void JsonSerializer::appendJson(StringBuilder& output, const bool addNewlines) const {
+    BUFF_ASSERT(!mImpl->writer);
+    BUFF_ASSERT(mImpl->stack.size() == 1);
+    mImpl->root.appendJson(output, addNewlines ? Optional(0) : NULL_OPTIONAL);
+}
+
+void JsonSerializer::finish() {
+    BUFF_ASSERT(mImpl->writer && !mImpl->writer->isFinished());
+    mImpl->writer->finish();
+}
+
 void JsonSerializer::setPropertyName(const char* name) {
     mImpl->currentName = name ? name : "";
 }
@@ -162,6 +686,70 @@ void JsonSerializer::serializePrimitive(const void*
                                         const int                                    size,
                                         const Detail::PrimitiveSerializationCategory type) {
     BUFF_ASSERT(data);
+    if (JsonWriter* writer = mImpl->writer.get()) {
+        const String& name = mImpl->currentName;
+        // Written with their own types, so that integers are not converted to double as in JsValue
+        switch (type) {
+        case Detail::PrimitiveSerializationCategory::BOOL:
+            writer->writePrimitive(name, *static_cast<const bool*>(data));
+            break;
+        case Detail::PrimitiveSerializationCategory::INT:
+            switch (size) {
+            case 1:
+                writer->writePrimitive(name, *static_cast<const int8*>(data));
+                break;
+            case 2:
+                writer->writePrimitive(name, *static_cast<const int16*>(data));
+                break;
+            case 4:
+                writer->writePrimitive(name, *static_cast<const int*>(data));
+                break;
+            case 8:
+                writer->writePrimitive(name, *static_cast<const int64*>(data));
+                break;
+            default:
+                BUFF_STOP;
+            }
+            break;
+        case Detail::PrimitiveSerializationCategory::UNSIGNED_INT:
+            switch (size) {
+            case 1:
+                writer->writePrimitive(name, *static_cast<const uint8*>(data));
+                break;
+            case 2:
+                writer->writePrimitive(name, *static_cast<const uint16*>(data));
+                break;
+            case 4:
+                writer->writePrimitive(name, *static_cast<const uint*>(data));
+                break;
+            case 8:
+                writer->writePrimitive(name, *static_cast<const uint64*>(data));
+                break;
+            default:
+                BUFF_STOP;
+            }
+            break;
+        case Detail::PrimitiveSerializationCategory::FLOAT:
+            switch (size) {
+            case 4:
+                writer->writePrimitive(name, *static_cast<const float*>(data));
+                break;
+            case 8:
+                writer->writePrimitive(name, *static_cast<const double*>(data));
+                break;
+            default:
+                BUFF_STOP;
+            }
+            break;
+        case Detail::PrimitiveSerializationCategory::STRING:
+            writer->writePrimitive(name, *static_cast<const String*>(data));
+            break;
+        default:
+            BUFF_STOP;
+        }
+        return;
+    }
+
     auto getValue = [&]() -> JsValue {
         switch (type) {
         case Detail::PrimitiveSerializationCategory::BOOL:
@@ -217,6 +805,13 @@ void JsonSerializer::serializePrimitive(const void*
 }
 
 void JsonSerializer::serializeListImpl(const std::function<bool()>& itemFunctor) {
+    if (mImpl->writer) {
+        mImpl->writer->pushList(mImpl->currentName);
+        while (itemFunctor()) {
+        }
+        mImpl->writer->popList();
+        return;
+    }
     auto& array = (*mImpl->stack.back())[mImpl->getUniqueCurrentName()] = JsArray();
     mImpl->stack.pushBack(&array);
     while (itemFunctor()) {
@@ -228,6 +823,218 @@ void JsonSerializer::serializeListImpl(const std::function<bool()>& itemFunctor)
 // JsonDeserializer
 // ===========================================================================================================
 
+namespace {
+/// Finds the deserialized values directly in the JSON text
+class JsonPullReader {
+    struct Level {
+        bool isList;
+        bool isFirst = true;
+        /// Position of the first member, where the search for members continues after reaching the end
+        int begin = 0;
+    };
+
+    JsonReader   mReader;
+    Array<Level> mLevels;
+
+public:
+    explicit JsonPullReader(const StringView json)
+        : mReader(json) {
+        mReader.getNextTokenChecked("{");
+        mLevels.pushBack({.isList = false, .begin = mReader.getPosition()});
+    }
+
+    /// Moves to the named member of the current object, or to the next item of the current list
+    /// \return False when the value is not in the input, the reader does not move then
+    bool moveToValue(const String& name) {
+        Level& level = mLevels.back();
+        if (level.isList) {
+            if (mReader.peekChar() == ']') {
+                throw Exception("Not enough items in list");
+            }
+            if (!level.isFirst) {
+                mReader.getNextTokenChecked(",");
+            }
+            level.isFirst = false;
+            return true;
+        }
+        BUFF_ASSERT(!name.isEmpty());
+        // Members are usually deserialized in the order they were serialized, so the search starts at the
+        // current member and wraps around to the first one only when the end of the object is reached
+        const int start = mReader.getPosition();
+        if (findMember(name, -1)) {
+            return true;
+        }
+        mReader.setPosition(level.begin);
+        if (findMember(name, start)) {
+            return true;
+        }
+        mReader.setPosition(start);
+        return false;
+    }
+
+    /// The functions below read the value found by moveToValue()
+
+    void pushObject() {
+        mReader.getNextTokenChecked("{");
+        mLevels.pushBack({.isList = false, .begin = mReader.getPosition()});
+    }
+
+    /// Skips the members which were not deserialized
+    void popObject() {
+        const Level level = mLevels.popBack();
+        BUFF_ASSERT(!level.isList && mLevels.notEmpty());
+        while (mReader.peekChar() != '}') {
+            skipMember();
+        }
+        mReader.getNextTokenChecked("}");
+    }
+
+    void pushList() {
+        mReader.getNextTokenChecked("[");
+        mLevels.pushBack({.isList = true});
+    }
+
+    /// Skips the items which were not deserialized
+    void popList() {
+        const Level level = mLevels.popBack();
+        BUFF_ASSERT(level.isList);
+        while (mReader.peekChar() != ']') {
+            if (mReader.peekChar() == ',') {
+                mReader.getNextToken();
+            }
+            mReader.skipValue();
+        }
+        mReader.getNextTokenChecked("]");
+    }
+
+    StringView getNextToken() {
+        return mReader.getNextToken();
+    }
+
+private:
+    /// Searches the members from the current position until the end of the object or until stopPosition. When
+    /// found, stops at its value.
+    bool findMember(const StringView name, const int stopPosition) {
+        while (mReader.peekChar() != '}' && mReader.getPosition() != stopPosition) {
+            if (mReader.peekChar() == ',') {
+                mReader.getNextToken();
+            }
+            const StringView key = mReader.getNextToken();
+            mReader.getNextTokenChecked(":");
+            if (isKey(key, name)) {
+                return true;
+            }
+            mReader.skipValue();
+        }
+        return false;
+    }
+
+    void skipMember() {
+        if (mReader.peekChar() == ',') {
+            mReader.getNextToken();
+        }
+        mReader.getNextToken();
+        mReader.getNextTokenChecked(":");
+        mReader.skipValue();
+    }
+
+    static bool isKey(const StringView token, const StringView name) {
+        if (token.size() < 2 || token[0] != '"') {
+            throw Exception("Wrong key format");
+        }
+        const StringView key = token.getSubstring(1, token.size() - 2);
+        // Keys are rarely escaped, the common case is compared in place
+        return key.contains("\\") ? unescapeJsonString(token) == name : key == name;
+    }
+};
+
+/// Reads integers exactly, falling back to double for other formats of numbers (e.g. 1e3)
+template <typename T>
+T parseJsonNumber(const StringView token) {
+    if constexpr (std::is_integral_v<T>) {
+        if (const Optional<T> exact = fromStr<T>(token)) {
+            return *exact;
+        }
+    }
+    const Optional<double> number = fromStr<double>(token);
+    if (!number) {
+        throw Exception("Invalid number " + token);
+    }
+    return T(*number);
+}
+} // namespace
+
+static void deserializePulledPrimitive(JsonPullReader&                              reader,
+                                       void*                                        data,
+                                       const int                                    size,
+                                       const Detail::PrimitiveSerializationCategory type) {
+    const StringView token = reader.getNextToken();
+    switch (type) {
+    case Detail::PrimitiveSerializationCategory::BOOL:
+        if (token == "true") {
+            *static_cast<bool*>(data) = true;
+        } else if (token == "false") {
+            *static_cast<bool*>(data) = false;
+        } else {
+            throw Exception("Expected bool, got " + token);
+        }
+        break;
+    case Detail::PrimitiveSerializationCategory::INT:
+        switch (size) {
+        case 1:
+            *static_cast<int8*>(data) = parseJsonNumber<int8>(token);
+            break;
+        case 2:
+            *static_cast<int16*>(data) = parseJsonNumber<int16>(token);
+            break;
+        case 4:
+            *static_cast<int*>(data) = parseJsonNumber<int>(token);
+            break;
+        case 8:
+            *static_cast<int64*>(data) = parseJsonNumber<int64>(token);
+            break;
+        default:
+            BUFF_STOP;
+        }
+        break;
+    case Detail::PrimitiveSerializationCategory::UNSIGNED_INT:
+        switch (size) {
+        case 1:
+            *static_cast<uint8*>(data) = parseJsonNumber<uint8>(token);
+            break;
+        case 2:
+            *static_cast<uint16*>(data) = parseJsonNumber<uint16>(token);
+            break;
+        case 4:
+            *static_cast<uint*>(data) = parseJsonNumber<uint>(token);
+            break;
+        case 8:
+            *static_cast<uint64*>(data) = parseJsonNumber<uint64>(token);
+            break;
+        default:
+            BUFF_STOP;
+        }
+        break;
+    case Detail::PrimitiveSerializationCategory::FLOAT:
+        switch (size) {
+        case 4:
+            *static_cast<float*>(data) = parseJsonNumber<float>(token);
+            break;
+        case 8:
+            *static_cast<double*>(data) = parseJsonNumber<double>(token);
+            break;
+        default:
+            BUFF_STOP;
+        }
+        break;
+    case Detail::PrimitiveSerializationCategory::STRING:
+        *static_cast<String*>(data) = unescapeJsonString(token);
+        break;
+    default:
+        BUFF_STOP;
+    }
+}
+
 struct JsonDeserializer::Impl {
     const JsValue root;
     struct StackItem {
@@ -236,6 +1043,8 @@ struct JsonDeserializer::Impl {
     };
     Array<StackItem> stack;
     String           currentName;
+    /// Set in the pull mode, the tree is not built then
+    std::unique_ptr<JsonPullReader> pull;
 
     bool isReadingList() const {
         BUFF_ASSERT(stack.back().value);
@@ -248,9 +1057,22 @@ JsonDeserializer::JsonDeserializer(const String& serialized)
     mImpl->stack.pushBack({&mImpl->root});
 }
 
+JsonDeserializer::JsonDeserializer(std::unique_ptr<Impl> impl)
+    : mImpl(std::move(impl)) {}
+
+JsonDeserializer JsonDeserializer::pull(const String& serialized) {
+    auto impl  = std::make_unique<Impl>();
+    impl->pull = std::make_unique<JsonPullReader>(serialized);
+    return JsonDeserializer(std::move(impl));
+}
+
 JsonDeserializer::~JsonDeserializer() = default;
 
 void JsonDeserializer::pushObject() {
+    if (JsonPullReader* pull = mImpl->pull.get()) {
+        pull->pushObject();
+        return;
+    }
     auto& back = mImpl->stack.back();
     if (mImpl->isReadingList()) {
         mImpl->stack.pushBack({&(*back.value)[back.arrayIndex++]});
@@ -262,17 +1084,25 @@ void JsonDeserializer::pushObject() {
 }
 
 void JsonDeserializer::popObject() {
-    mImpl->stack.popBack();
+    if (mImpl->pull) {
+        mImpl->pull->popObject();
+    } else {
+        mImpl->stack.popBack();
+    }
 }
 
-void JsonDeserializer::setPropertyName(const char* name) {
+bool JsonDeserializer::setPropertyName(const char* name) {
     mImpl->currentName = name ? name : "";
+    return !mImpl->pull || mImpl->pull->moveToValue(mImpl->currentName);
 }
 
 void JsonDeserializer::deserializePrimitive(void*                                        data,
                                             const int                                    size,
                                             const Detail::PrimitiveSerializationCategory type) {
-
+    if (mImpl->pull) {
+        deserializePulledPrimitive(*mImpl->pull, data, size, type);
+        return;
+    }
     const JsValue& value = [&]() -> const JsValue& {
         auto& back = mImpl->stack.back();
         if (mImpl->isReadingList()) {
@@ -342,6 +1172,13 @@ void JsonDeserializer::deserializePrimitive(void*
 }
 
 void JsonDeserializer::deserializeListImpl(const std::function<bool()>& itemFunctor) {
+    if (JsonPullReader* pull = mImpl->pull.get()) {
+        pull->pushList();
+        while (itemFunctor()) {
+        }
+        pull->popList();
+        return;
+    }
     const int64 stackSize = mImpl->stack.size();
     mImpl->stack.pushBack({mImpl->stack.back().value->find(mImpl->currentName)});
     while (itemFunctor()) {
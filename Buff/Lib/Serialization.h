@@ -1,6 +1,8 @@
 #pragma once
 #include "Lib/Bootstrap.h"
+#include <cstring>
 #include <functional>
+#include <typeinfo>
 #include <vector>
 #ifdef __EMSCRIPTEN__
 #    include <type_traits>
@@ -9,6 +11,13 @@
 BUFF_NAMESPACE_BEGIN
 
 class StringView;
+class StringBuilder;
+template <typename T>
+class ArrayView;
+template <typename T>
+class Optional;
+template <typename TSignature>
+class Function;
 class ISerializer;
 class IDeserializer;
 class Polymorphic;
@@ -74,6 +83,36 @@ concept Deserializable = HasCustomDeserialization<T> || HasSimpleStructSerializa
 // TODO: cancel?
 struct TransparentObjectSerialization {};
 
+/// Inherit to mark a struct whose serialized bytes are exactly its memory: it is trivially copyable, has no
+/// padding and serializes all its members, which are themselves bitwise serializable, in declaration order.
+/// Contiguous lists of such structs are then written and read by BinarySerializer with a single memcpy.
+struct BitwiseSerialization {
+    /// Keeps defaulted comparisons of derived structs working
+    constexpr bool operator==(const BitwiseSerialization&) const = default;
+    constexpr auto operator<=>(const BitwiseSerialization&) const = default;
+};
+
+template <typename T>
+concept BitwiseSerializable =
+    std::is_trivially_copyable_v<T> &&
+    (IsSerializableDeserializablePrimitive<T> || std::is_base_of_v<BitwiseSerialization, T>);
+
+namespace Detail {
+/// Lists which can be (de)serialized with a single memcpy. Lists of bool are excluded, because
+/// std::vector<bool> does not store them contiguously.
+template <typename T, typename TElement>
+concept BitwiseSerializableList = BitwiseSerializable<TElement> && !std::is_same_v<TElement, bool> &&
+                                  requires(T& list) {
+                                      { list.data() } -> std::convertible_to<const TElement*>;
+                                      { list.size() } -> std::convertible_to<int64>;
+                                  };
+
+/// Containers serialized as their int64 size followed by their items, which lets StaticBinaryWriter and
+/// StaticBinaryReader handle them without virtual calls. Specialized next to the container.
+template <typename T>
+constexpr bool IS_SIZED_LIST = false;
+}
+
 // ===========================================================================================================
 // ISerializer/IDeserializer
 // ===========================================================================================================
@@ -112,7 +151,15 @@ public:
     template <typename T>
     void serializeList(const T& list, const char* name)
         requires Serializable<std::decay_t<decltype(*list.begin())>> {
+        using Element = std::remove_cvref_t<decltype(*list.begin())>;
         setPropertyName(name);
+        if constexpr (Detail::BitwiseSerializableList<const T, Element>) {
+            if (serializeBitwiseList(list.data(),
+                                     int64(list.size()) * int64(sizeof(Element)),
+                                     IsSerializableDeserializablePrimitive<Element>)) {
+                return;
+            }
+        }
         auto firstIt = list.begin();
         serializeListImpl([&]() {
             if (firstIt == list.end()) {
@@ -132,6 +179,14 @@ private:
                                     int                                    size,
                                     Detail::PrimitiveSerializationCategory type) = 0;
     virtual void serializeListImpl(const std::function<bool()>& itemFunctor)     = 0;
+    /// Optional fast path for contiguous lists of BitwiseSerializable elements
+    /// \param primitiveElements False for lists of structs
+    /// \return False when not supported, the elements are then serialized one by one
+    virtual bool serializeBitwiseList(const void* BUFF_UNUSED(data),
+                                      int64       BUFF_UNUSED(size),
+                                      bool        BUFF_UNUSED(primitiveElements)) {
+        return false;
+    }
 };
 
 class IDeserializer
@@ -141,7 +196,11 @@ public:
     template <Deserializable T>
     void deserialize(T& value, const char* name) {
         constexpr bool TRANSPARENT_OBJECT = std::is_base_of_v<TransparentObjectSerialization, T>;
-        setPropertyName(name);
+        // Members of a transparent object are stored directly in the parent, the object itself is not in the
+        // data
+        if (!TRANSPARENT_OBJECT && !setPropertyName(name)) {
+            return;
+        }
         if constexpr (HasCustomSerialization<T>) {
             if constexpr (!TRANSPARENT_OBJECT) {
                 pushObject();
@@ -166,7 +225,17 @@ public:
     template <typename T>
     void deserializeList(T& list, const char* name)
         requires Deserializable<std::decay_t<decltype(*list.begin())>> {
-        setPropertyName(name);
+        using Element = std::remove_cvref_t<decltype(*list.begin())>;
+        if (!setPropertyName(name)) {
+            return;
+        }
+        if constexpr (Detail::BitwiseSerializableList<T, Element>) {
+            if (deserializeBitwiseList(list.data(),
+                                       int64(list.size()) * int64(sizeof(Element)),
+                                       IsSerializableDeserializablePrimitive<Element>)) {
+                return;
+            }
+        }
         auto firstIt = list.begin();
         deserializeListImpl([&]() {
             if (firstIt == list.end()) {
@@ -181,9 +250,21 @@ public:
 private:
     virtual void pushObject() {}
     virtual void popObject() {}
-    virtual void setPropertyName(const char* BUFF_UNUSED(name)) {}
+    /// \return False when the data does not contain the property, e.g. when it was added to a struct after
+    ///         the data was serialized. The value is then left unchanged.
+    virtual bool setPropertyName(const char* BUFF_UNUSED(name)) {
+        return true;
+    }
     virtual void deserializePrimitive(void* data, int size, Detail::PrimitiveSerializationCategory type) = 0;
     virtual void deserializeListImpl(const std::function<bool()>& itemFunctor)                           = 0;
+    /// Optional fast path for contiguous lists of BitwiseSerializable elements, already resized to fit
+    /// \param primitiveElements False for lists of structs
+    /// \return False when not supported, the elements are then deserialized one by one
+    virtual bool deserializeBitwiseList(void* BUFF_UNUSED(data),
+                                        int64 BUFF_UNUSED(size),
+                                        bool  BUFF_UNUSED(primitiveElements)) {
+        return false;
+    }
 };
 
 // ===========================================================================================================
@@ -192,48 +273,294 @@ private:
 
 using BinarySerializationState = std::vector<std::byte>;
 
+enum class BinaryFormat : uint8 {
+    /// Every value is written with its full size. There is no header, so this is also assumed for data
+    /// without one.
+    FIXED = 0,
+
+    /// Integers wider than a byte are written as LEB128 varints, signed ones zigzag encoded first, and bools
+    /// are packed 8 to a byte. The data starts with a header identifying the format.
+    COMPACT = 1,
+
+    /// Values are written as in the fixed format, but every object is prefixed by its length and its named
+    /// members are stored as fields identified by a hash of the name. Members missing in the data keep their
+    /// value when deserializing and unknown fields are skipped, so data stays readable after members are
+    /// added, removed or reordered. Changing the type of a member is not supported, rename it instead.
+    TAGGED = 2,
+};
+
+namespace Detail {
+/// Size of the header which starts binary data in other than the fixed format
+constexpr int64 BINARY_HEADER_SIZE = 8;
+
+/// Detects the format from the header at the start of binary data. Throws Exception for unknown formats.
+/// \return FIXED when the data does not start with a header
+BinaryFormat getBinaryFormat(ArrayView<const std::byte> bytes);
+} // namespace Detail
+
 class BinarySerializer final : public ISerializer {
+    friend class StaticBinaryWriter;
+
     BinarySerializationState mBytes;
+    BinaryFormat             mFormat = BinaryFormat::FIXED;
+    /// Byte to which the next packed bool is written, with the number of its bits already used
+    int64 mBoolByte     = -1;
+    int   mUsedBoolBits = 8;
+
+    struct TaggedObject {
+        /// Position of the length of the object
+        int64 start;
+        /// Position of the length of the field being written, -1 if none
+        int64 openField = -1;
+    };
+    std::vector<TaggedObject> mTaggedObjects;
 
 public:
+    BinarySerializer() = default;
+    explicit BinarySerializer(BinaryFormat format);
+
     const BinarySerializationState& getState() const {
         return mBytes;
     }
 
 private:
+    virtual void pushObject() override;
+    virtual void popObject() override;
+    virtual void setPropertyName(const char* name) override;
     virtual void serializePrimitive(const void*                            data,
                                     int                                    size,
                                     Detail::PrimitiveSerializationCategory type) override;
     virtual void serializeListImpl(const std::function<bool()>& itemFunctor) override;
+    virtual bool serializeBitwiseList(const void* data, int64 size, bool primitiveElements) override;
+
+    void closeTaggedField();
 };
 
 class BinaryDeserializer final : public IDeserializer {
-    BinarySerializationState mBytes;
-    int64                    mPtr = 0;
+    friend class StaticBinaryReader;
+
+    /// Empty when reading from a buffer owned by the caller
+    BinarySerializationState mOwnedBytes;
+    const std::byte*         mData   = nullptr;
+    int64                    mSize   = 0;
+    int64                    mPtr    = 0;
+    BinaryFormat             mFormat = BinaryFormat::FIXED;
+    /// Remaining bits of the last byte of packed bools
+    uint8 mBoolByte          = 0;
+    int   mRemainingBoolBits = 0;
+
+    struct TaggedField {
+        uint  id;
+        int64 begin;
+        int64 end;
+    };
+    struct TaggedObject {
+        int64 end;
+        /// Fields of the object are stored in mTaggedFields from this index to the end
+        int64 firstField;
+        /// Where to start looking for the next field, usually the one following the last found field
+        int64 nextField;
+    };
+    std::vector<TaggedField>  mTaggedFields;
+    std::vector<TaggedObject> mTaggedObjects;
 
 public:
     explicit BinaryDeserializer(BinarySerializationState serialized)
-        : mBytes(std::move(serialized)) {}
+        : mOwnedBytes(std::move(serialized))
+        , mData(mOwnedBytes.data())
+        , mSize(int64(mOwnedBytes.size())) {
+        readHeader();
+    }
+
+    /// Reads directly from the buffer, e.g. a file loaded with readBinaryFile, without copying it. The buffer
+    /// must outlive the deserializer and all views returned by it.
+    explicit BinaryDeserializer(ArrayView<const std::byte> serialized);
+
+    /// Format detected from the header of the data
+    BinaryFormat getFormat() const {
+        return mFormat;
+    }
+
+    /// Reads a String as a view into the buffer instead of copying it
+    StringView deserializeStringView(const char* name);
+
+    /// Reads a list serialized with its size, such as Array<T> or ArrayView<T>, as a view into the buffer
+    /// \return Empty when the elements are not aligned for T in the buffer, or are not stored bitwise in the
+    ///         compact format. Nothing is read then, so the list can still be deserialized into an Array.
+    template <BitwiseSerializable T>
+    Optional<ArrayView<const T>> deserializeArrayView(const char* name) {
+        if (mFormat != BinaryFormat::FIXED) {
+            return {};
+        }
+        const int64            oldPtr = mPtr;
+        int64                  size;
+        const std::byte* const items = deserializeBitwiseView(size, sizeof(T), name);
+        if (reinterpret_cast<std::uintptr_t>(items) % alignof(T) != 0) {
+            mPtr = oldPtr;
+            return {};
+        }
+        return ArrayView<const T>(reinterpret_cast<const T*>(items), size);
+    }
 
 private:
+    void readHeader();
+
+    /// Reads the size of a list and skips its elements
+    /// \return Pointer to the elements in the buffer
+    const std::byte* deserializeBitwiseView(int64& size, int64 elementSize, const char* name);
+
+    virtual void pushObject() override;
+    virtual void popObject() override;
+    virtual bool setPropertyName(const char* name) override;
     virtual void deserializePrimitive(void*                                  data,
                                       int                                    size,
                                       Detail::PrimitiveSerializationCategory type) override;
     virtual void deserializeListImpl(const std::function<bool()>& itemFunctor) override;
+    virtual bool deserializeBitwiseList(void* data, int64 size, bool primitiveElements) override;
+};
+
+/// Writes the same bytes as BinarySerializer without virtual calls: primitives, strings and members of
+/// structs with enumerateStructMembers are resolved at compile time and can be fully inlined. Bitwise
+/// serializable structs and lists of them are copied at once. Other types with custom serialization go
+/// through BinarySerializer. Only the fixed format is supported.
+class StaticBinaryWriter : public Noncopyable {
+    BinarySerializer mSerializer;
+
+public:
+    template <Serializable T>
+    void serialize(const T& value, const char* name) {
+        using DecayedT = std::remove_const_t<T>;
+        if constexpr (BitwiseSerializable<DecayedT> && !IsSerializableDeserializablePrimitive<DecayedT>) {
+            writeBytes(&value, sizeof(value));
+        } else if constexpr (Detail::IS_SIZED_LIST<DecayedT>) {
+            using Element = std::remove_cvref_t<decltype(*value.begin())>;
+            serialize(int64(value.size()), "size");
+            if constexpr (Detail::BitwiseSerializableList<const DecayedT, Element>) {
+                writeBytes(value.data(), int64(value.size()) * int64(sizeof(Element)));
+            } else {
+                for (const Element& item : value) {
+                    serialize(item, nullptr);
+                }
+            }
+        } else if constexpr (HasCustomSerialization<T>) {
+            mSerializer.serialize(value, name);
+        } else if constexpr (HasSimpleStructSerializationDeserialization<T>) {
+            const_cast<T&>(value).enumerateStructMembers(
+                [this](auto& field, const char* fieldName) { this->serialize(field, fieldName); });
+        } else if constexpr (std::is_same_v<DecayedT, String>) {
+            serialize(value.size(), "size");
+            writeBytes(value.asCString(), value.size());
+        } else {
+            writeBytes(&value, sizeof(value));
+        }
+    }
+
+    const BinarySerializationState& getState() const {
+        return mSerializer.getState();
+    }
+
+private:
+    void writeBytes(const void* data, const int64 size) {
+        const auto* bytes = static_cast<const std::byte*>(data);
+        mSerializer.mBytes.insert(mSerializer.mBytes.end(), bytes, bytes + size);
+    }
+};
+
+/// Reads bytes written by BinarySerializer or StaticBinaryWriter, resolving types like StaticBinaryWriter
+class StaticBinaryReader : public Noncopyable {
+    BinaryDeserializer mDeserializer;
+
+public:
+    /// Throws Exception for data in the compact format
+    explicit StaticBinaryReader(BinarySerializationState serialized)
+        : mDeserializer(std::move(serialized)) {
+        checkFormat();
+    }
+
+    /// Reads directly from the buffer, which must outlive the reader
+    explicit StaticBinaryReader(ArrayView<const std::byte> serialized);
+
+    template <Deserializable T>
+    void deserialize(T& value, const char* name) {
+        if constexpr (BitwiseSerializable<T> && !IsSerializableDeserializablePrimitive<T>) {
+            readBytes(&value, sizeof(value));
+        } else if constexpr (Detail::IS_SIZED_LIST<T>) {
+            using Element = std::remove_cvref_t<decltype(*value.begin())>;
+            int64 size;
+            deserialize(size, "size");
+            if (size < 0) {
+                throwError("Negative size deserialization");
+            }
+            value.resize(size);
+            if constexpr (Detail::BitwiseSerializableList<T, Element>) {
+                readBytes(value.data(), size * int64(sizeof(Element)));
+            } else {
+                for (Element& item : value) {
+                    deserialize(item, nullptr);
+                }
+            }
+        } else if constexpr (HasCustomDeserialization<T>) {
+            mDeserializer.deserialize(value, name);
+        } else if constexpr (HasSimpleStructSerializationDeserialization<T>) {
+            value.enumerateStructMembers(
+                [this](auto& field, const char* fieldName) { this->deserialize(field, fieldName); });
+        } else if constexpr (std::is_same_v<T, String>) {
+            readString(value);
+        } else {
+            readBytes(&value, sizeof(value));
+        }
+    }
+
+private:
+    void readBytes(void* data, const int64 size) {
+        if (mDeserializer.mSize - mDeserializer.mPtr < size) {
+            throwError("Not enough data to deserialize");
+        }
+        if (size > 0) {
+            std::memcpy(data, mDeserializer.mData + mDeserializer.mPtr, size);
+        }
+        mDeserializer.mPtr += size;
+    }
+
+    void readString(String& value);
+
+    void checkFormat();
+
+    /// Out of line, so that the inlined reads stay small
+    [[noreturn]] static void throwError(const char* message);
 };
 
 // ===========================================================================================================
 // JsonSerializer/JsonDeserializer
 // ===========================================================================================================
 
+/// Receives the JSON text piece by piece. Throw Exception to report errors.
+using JsonSink = Function<void(StringView text)>;
+
+/// By default, builds a JsValue tree which is turned into text by getJson() or appendJson(). When constructed
+/// with an output, writes the text directly while the values are serialized instead, keeping members in the
+/// order they were serialized.
 class JsonSerializer final : public ISerializer {
     struct Impl;
     std::unique_ptr<Impl> mImpl;
 
 public:
     JsonSerializer();
+    /// Appends the text to the output as the values arrive. Call finish() after the last value.
+    JsonSerializer(StringBuilder& output, bool addNewlines);
+    /// Passes the text to the sink in pieces of roughly 64 kB. Call finish() after the last value.
+    JsonSerializer(JsonSink sink, bool addNewlines);
     virtual ~JsonSerializer() override;
+
+    /// Not available when writing into an output
     String getJson(bool addNewlines) const;
+    /// Writes the JSON into the builder, e.g. to save it with writeTextFile without assembling it in memory.
+    /// Not available when writing into an output.
+    void appendJson(StringBuilder& output, bool addNewlines) const;
+
+    /// Closes the JSON written into the output, passing the rest of it to the sink. No values can be
+    /// serialized afterwards.
+    void finish();
 
 private:
     virtual void pushObject() override;
@@ -250,13 +577,23 @@ class JsonDeserializer final : public IDeserializer {
     std::unique_ptr<Impl> mImpl;
 
 public:
+    /// Parses the whole input into a JsValue tree first
     explicit JsonDeserializer(const String& serialized);
+
+    /// Reads the values directly from the text when they are deserialized, so that only the deserialized
+    /// objects are allocated. The input has to outlive the deserializer. Members missing in the input are
+    /// left unchanged.
+    static JsonDeserializer pull(const String& serialized);
+    static JsonDeserializer pull(String&& serialized) = delete;
+
     virtual ~JsonDeserializer() override;
 
 private:
+    explicit JsonDeserializer(std::unique_ptr<Impl> impl);
+
     virtual void pushObject() override;
     virtual void popObject() override;
-    virtual void setPropertyName(const char* name) override;
+    virtual bool setPropertyName(const char* name) override;
     virtual void deserializePrimitive(void*                                  data,
                                       int                                    size,
                                       Detail::PrimitiveSerializationCategory type) override;
@@ -269,24 +606,38 @@ private:
 
 namespace Detail {
 
-void registerForPolymorphicSerializationImpl(const char* name,
+/// 32-bit FNV-1a hash of a name, the same on all platforms and compilers
+constexpr uint getSerializedNameHash(const char* name) {
+    uint hash = 2166136261u;
+    for (; *name; ++name) {
+        hash = (hash ^ uint8(*name)) * 16777619u;
+    }
+    return hash;
+}
+
+void registerForPolymorphicSerializationImpl(const char*           name,
+                                             const std::type_info& type,
                                              Polymorphic* (*constructor)(),
                                              void (*serializeT)(const Polymorphic*,
                                                                 ISerializer&,
                                                                 const char*),
                                              void (*deserializeT)(Polymorphic*, IDeserializer&, const char*));
 
-Polymorphic* instantiatePolymorphicClass(const char* name, IDeserializer& deserializer);
+/// Reads the type ID of the value and creates an instance of the registered class with that ID. Throws
+/// Exception for unknown IDs.
+Polymorphic* instantiatePolymorphicClass(IDeserializer& deserializer);
 
-void serializePolymorphicClass(const char* name, const Polymorphic& value, ISerializer& serializer);
+/// Writes the type ID of the dynamic type of the value, followed by the value itself
+void serializePolymorphicClass(const Polymorphic& value, ISerializer& serializer);
 
 template <typename T>
-bool registerForPolymorphicSerialization() {
+bool registerForPolymorphicSerialization(const char* className) {
     static_assert(std::is_base_of_v<Polymorphic, T>);
     static_assert(Serializable<T>);
     static_assert(Deserializable<T>);
     registerForPolymorphicSerializationImpl(
-        typeid(T).name(),
+        className,
+        typeid(T),
         []() -> Polymorphic* { return new T; },
         [](const Polymorphic* toSerialize, ISerializer& serializer, const char* name) {
             serializer.serialize(*dynamic_cast<const T*>(toSerialize), name);
@@ -298,8 +649,9 @@ bool registerForPolymorphicSerialization() {
 }
 }
 
-// Use inside polymorphic class
-#define BUFF_REGISTER_FOR_POLYMORPHIC_SERIALIZATION(T)                                                       \
-    static inline const auto dummy_ = Detail::registerForPolymorphicSerialization<T>()
+/// Use inside polymorphic class. Serialized data identify the class by a hash of the name, so it has to be
+/// unique among registered classes and must not change once the data are saved.
+#define BUFF_REGISTER_FOR_POLYMORPHIC_SERIALIZATION(T, name)                                                 \
+    static inline const auto dummy_ = Detail::registerForPolymorphicSerialization<T>(name)
 
 BUFF_NAMESPACE_END
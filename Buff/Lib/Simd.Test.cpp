@@ -0,0 +1,82 @@
+#include "Lib/Simd.h"
+#include "Lib/Bootstrap.Test.h"
+#include "Lib/containers/Array.h"
+#include "Lib/String.h"
+
+BUFF_NAMESPACE_BEGIN
+
+TEST_CASE("Simd::Bytes16") {
+    const char           text[]  = "abcabcabcabcabc\xFF";
+    const Simd::Bytes16  bytes   = Simd::Bytes16::load(text);
+    CHECK(bytes.equalMask('a') == 0b0001001001001001);
+    CHECK(bytes.equalMask('c') == 0b0100100100100100);
+    CHECK(bytes.equalMask('x') == 0);
+    CHECK(bytes.highBitMask() == 0b1000000000000000);
+    CHECK(Simd::lowestBit(bytes.equalMask('b')) == 1);
+}
+
+template <typename T>
+static void testFindEqual() {
+    for (const int64 size : {0, 1, 7, 16, 33, 100}) {
+        Array<T> data(size);
+        for (const int64 i : range(size)) {
+            data[i] = T(i + 1);
+        }
+        for (const int64 i : range(size)) {
+            CHECK(Simd::findEqual(data.data(), size, T(i + 1)) == i);
+        }
+        CHECK(Simd::findEqual(data.data(), size, T(0)) == size);
+    }
+}
+
+TEST_CASE("Simd::findEqual") {
+    testFindEqual<uint8>();
+    testFindEqual<int16>();
+    testFindEqual<int>();
+    testFindEqual<int64>();
+
+    // Only both halves of a 64-bit value may match
+    const int64 data[] = {0x1'0000'0002, 0x2'0000'0001, 0x1'0000'0001, 0x1'0000'0001};
+    CHECK(Simd::findEqual(data, 4, int64(0x1'0000'0001)) == 2);
+
+    Array<String*> pointers;
+    String         a, b;
+    for (const int i : range(40)) {
+        pointers.pushBack(i == 37 ? &b : &a);
+    }
+    CHECK(pointers.find(&b) == 37);
+    CHECK(!Array<int> {1, 2, 3}.contains(4));
+}
+
+static String repeat(const StringView value, const int count) {
+    String result;
+    for ([[maybe_unused]] const int i : range(count)) {
+        result << value;
+    }
+    return result;
+}
+
+TEST_CASE("Simd::findFirstOf") {
+    const String text = repeat("x", 50) + "\"abc\\";
+    CHECK(Simd::findFirstOf(text.asCString(), text.size(), "\"\\", 2) == 50);
+    CHECK(Simd::findFirstOf(text.asCString(), text.size(), "\\", 1) == 54);
+    CHECK(Simd::findFirstOf(text.asCString(), text.size(), "0123456789c", 11) == 53);
+    CHECK(Simd::findFirstOf(text.asCString(), text.size(), "yz", 2) == text.size());
+    CHECK(StringView(text).findFirstOf("cb") == 52);
+    CHECK(!StringView(text).findFirstOf("q"));
+}
+
+TEST_CASE("Simd::findSubstring") {
+    const String text = repeat("ab", 40) + "abc" + repeat("ab", 10);
+    CHECK(Simd::findSubstring(text.asCString(), text.size(), "abc", 3) == 80);
+    CHECK(Simd::findSubstring(text.asCString(), text.size(), "ba", 2) == 1);
+    CHECK(Simd::findSubstring(text.asCString(), text.size(), "cab", 3) == 82);
+    CHECK(Simd::findSubstring(text.asCString(), text.size(), "abab", 4) == 0);
+    CHECK(Simd::findSubstring(text.asCString(), text.size(), "aa", 2) == text.size());
+    CHECK(StringView(text).find("ab", 81) == 83);
+    CHECK(StringView(text).find("bab", 100) == 100);
+    CHECK(!StringView(text).find("bab", 101));
+    CHECK(!StringView(text).find("abc", 81));
+}
+
+BUFF_NAMESPACE_END
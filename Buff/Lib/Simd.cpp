@@ -0,0 +1,81 @@
+#include "Lib/Simd.h"
+
+BUFF_NAMESPACE_BEGIN
+
+namespace Simd {
+
+/// Sets up to this size are compared one character at a time within each block, larger ones use a table
+static constexpr int64 MAX_VECTOR_SET_SIZE = 8;
+
+int64 findFirstOf(const char* data, const int64 size, const char* set, const int64 setSize) {
+    if (setSize == 0) {
+        return size;
+    }
+    if (setSize == 1) {
+        return findEqual(data, size, set[0]);
+    }
+    int64 i = 0;
+    if (setSize <= MAX_VECTOR_SET_SIZE) {
+        Block needles[MAX_VECTOR_SET_SIZE];
+        for (int64 j = 0; j < setSize; ++j) {
+            needles[j] = Block::broadcast(set[j]);
+        }
+        for (; i + Block::SIZE <= size; i += Block::SIZE) {
+            const Block block = Block::load(data + i);
+            uint        mask  = 0;
+            for (int64 j = 0; j < setSize; ++j) {
+                mask |= block.equalMask<1>(needles[j]);
+            }
+            if (mask) {
+                return i + lowestBit(mask);
+            }
+        }
+    }
+    bool inSet[256] = {};
+    for (int64 j = 0; j < setSize; ++j) {
+        inSet[uint8(set[j])] = true;
+    }
+    for (; i < size; ++i) {
+        if (inSet[uint8(data[i])]) {
+            return i;
+        }
+    }
+    return size;
+}
+
+int64 findSubstring(const char* data, const int64 size, const char* pattern, const int64 patternSize) {
+    BUFF_ASSERT(patternSize > 0);
+    if (patternSize == 1) {
+        return findEqual(data, size, pattern[0]);
+    }
+    if (patternSize > size) {
+        return size;
+    }
+    // Candidates need to match both the first and the last character of the pattern, which filters out almost
+    // all false positives before the full comparison
+    const int64 lastStart = size - patternSize;
+    const Block first     = Block::broadcast(pattern[0]);
+    const Block last      = Block::broadcast(pattern[patternSize - 1]);
+    int64       i         = 0;
+    for (; i + Block::SIZE - 1 <= lastStart; i += Block::SIZE) {
+        uint mask = Block::load(data + i).equalMask<1>(first) &
+                    Block::load(data + i + patternSize - 1).equalMask<1>(last);
+        while (mask) {
+            const int64 candidate = i + lowestBit(mask);
+            if (std::memcmp(data + candidate + 1, pattern + 1, patternSize - 2) == 0) {
+                return candidate;
+            }
+            mask &= mask - 1;
+        }
+    }
+    for (; i <= lastStart; ++i) {
+        if (data[i] == pattern[0] && std::memcmp(data + i, pattern, patternSize) == 0) {
+            return i;
+        }
+    }
+    return size;
+}
+
+} // namespace Simd
+
+BUFF_NAMESPACE_END
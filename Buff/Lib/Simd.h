@@ -0,0 +1,295 @@
+#pragma once
+#include "Lib/Bootstrap.h"
+#include <bit>
+#include <cstring>
+
+#if defined(__AVX2__)
+#    define BUFF_SIMD_AVX2 1
+#    include <immintrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define BUFF_SIMD_SSE2 1
+#    include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#    define BUFF_SIMD_NEON 1
+#    include <arm_neon.h>
+#endif
+
+BUFF_NAMESPACE_BEGIN
+
+namespace Simd {
+
+#if BUFF_SIMD_NEON
+namespace Detail {
+/// NEON has no movemask instruction, so each lane keeps its own bit and the lanes are summed up
+inline uint toMask(const uint8x16_t comparison) {
+    static constexpr uint8_t BITS[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    const uint8x16_t         masked   = vandq_u8(comparison, vld1q_u8(BITS));
+    return uint(vaddv_u8(vget_low_u8(masked))) | (uint(vaddv_u8(vget_high_u8(masked))) << 8);
+}
+} // namespace Detail
+#endif
+
+/// 16 bytes processed at once. Uses SSE2 or NEON when available, otherwise plain loops which the compiler is
+/// free to vectorize.
+///
+/// Comparisons return a bitmask with bit i set when byte i matched, so results can be iterated with
+/// std::countr_zero.
+class Bytes16 {
+#if BUFF_SIMD_SSE2
+    __m128i mImpl;
+#elif BUFF_SIMD_NEON
+    uint8x16_t mImpl;
+#else
+    uint8 mImpl[16];
+#endif
+
+public:
+    static constexpr int SIZE = 16;
+
+    /// No alignment requirements
+    static Bytes16 load(const void* ptr) {
+        Bytes16 result;
+#if BUFF_SIMD_SSE2
+        result.mImpl = _mm_loadu_si128(static_cast<const __m128i*>(ptr));
+#elif BUFF_SIMD_NEON
+        result.mImpl = vld1q_u8(static_cast<const uint8_t*>(ptr));
+#else
+        std::memcpy(result.mImpl, ptr, SIZE);
+#endif
+        return result;
+    }
+
+    /// Bytes equal to value
+    uint equalMask(const uint8 value) const {
+#if BUFF_SIMD_SSE2
+        return uint(_mm_movemask_epi8(_mm_cmpeq_epi8(mImpl, _mm_set1_epi8(char(value)))));
+#elif BUFF_SIMD_NEON
+        return Detail::toMask(vceqq_u8(mImpl, vdupq_n_u8(value)));
+#else
+        uint result = 0;
+        for (int i = 0; i < SIZE; ++i) {
+            result |= uint(mImpl[i] == value) << i;
+        }
+        return result;
+#endif
+    }
+
+    /// Bytes with the highest bit set (i.e. negative as int8, or non-ASCII)
+    uint highBitMask() const {
+#if BUFF_SIMD_SSE2
+        return uint(_mm_movemask_epi8(mImpl));
+#elif BUFF_SIMD_NEON
+        return Detail::toMask(vcltzq_s8(vreinterpretq_s8_u8(mImpl)));
+#else
+        uint result = 0;
+        for (int i = 0; i < SIZE; ++i) {
+            result |= uint(mImpl[i] >> 7) << i;
+        }
+        return result;
+#endif
+    }
+};
+
+/// Index of the lowest set bit, mask must not be zero
+inline int lowestBit(const uint mask) {
+    return std::countr_zero(mask);
+}
+
+/// Types whose equality is the same as equality of their bytes
+template <typename T>
+concept BitwiseComparable = (std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>) &&
+                            (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+/// The widest register available: 32 bytes with AVX2, otherwise 16 bytes (SSE2, NEON or plain loops).
+///
+/// Comparisons return a mask with one bit per byte, so an element of N bytes which matched sets N bits.
+class Block {
+#if BUFF_SIMD_AVX2
+    __m256i mImpl;
+#elif BUFF_SIMD_SSE2
+    __m128i mImpl;
+#elif BUFF_SIMD_NEON
+    uint8x16_t mImpl;
+#else
+    uint8 mImpl[16];
+#endif
+
+    template <typename T>
+    using Bits = std::conditional_t<sizeof(T) == 1,
+                                    uint8,
+                                    std::conditional_t<sizeof(T) == 2,
+                                                       uint16,
+                                                       std::conditional_t<sizeof(T) == 4, uint, uint64>>>;
+
+public:
+#if BUFF_SIMD_AVX2
+    static constexpr int SIZE = 32;
+#else
+    static constexpr int SIZE = 16;
+#endif
+
+    /// No alignment requirements
+    static Block load(const void* ptr) {
+        Block result;
+#if BUFF_SIMD_AVX2
+        result.mImpl = _mm256_loadu_si256(static_cast<const __m256i*>(ptr));
+#elif BUFF_SIMD_SSE2
+        result.mImpl = _mm_loadu_si128(static_cast<const __m128i*>(ptr));
+#elif BUFF_SIMD_NEON
+        result.mImpl = vld1q_u8(static_cast<const uint8_t*>(ptr));
+#else
+        std::memcpy(result.mImpl, ptr, SIZE);
+#endif
+        return result;
+    }
+
+    /// All elements of size sizeof(T) set to value
+    template <BitwiseComparable T>
+    static Block broadcast(const T value) {
+        const Bits<T> bits = std::bit_cast<Bits<T>>(value);
+        Block         result;
+#if BUFF_SIMD_AVX2
+        if constexpr (sizeof(T) == 1) {
+            result.mImpl = _mm256_set1_epi8(char(bits));
+        } else if constexpr (sizeof(T) == 2) {
+            result.mImpl = _mm256_set1_epi16(short(bits));
+        } else if constexpr (sizeof(T) == 4) {
+            result.mImpl = _mm256_set1_epi32(int(bits));
+        } else {
+            result.mImpl = _mm256_set1_epi64x(int64(bits));
+        }
+#elif BUFF_SIMD_SSE2
+        if constexpr (sizeof(T) == 1) {
+            result.mImpl = _mm_set1_epi8(char(bits));
+        } else if constexpr (sizeof(T) == 2) {
+            result.mImpl = _mm_set1_epi16(short(bits));
+        } else if constexpr (sizeof(T) == 4) {
+            result.mImpl = _mm_set1_epi32(int(bits));
+        } else {
+            result.mImpl = _mm_set1_epi64x(int64(bits));
+        }
+#elif BUFF_SIMD_NEON
+        if constexpr (sizeof(T) == 1) {
+            result.mImpl = vdupq_n_u8(bits);
+        } else if constexpr (sizeof(T) == 2) {
+            result.mImpl = vreinterpretq_u8_u16(vdupq_n_u16(bits));
+        } else if constexpr (sizeof(T) == 4) {
+            result.mImpl = vreinterpretq_u8_u32(vdupq_n_u32(bits));
+        } else {
+            result.mImpl = vreinterpretq_u8_u64(vdupq_n_u64(bits));
+        }
+#else
+        for (int i = 0; i < SIZE; i += sizeof(T)) {
+            std::memcpy(result.mImpl + i, &bits, sizeof(T));
+        }
+#endif
+        return result;
+    }
+
+    /// Bytes with the highest bit set (i.e. negative as int8, or non-ASCII)
+    uint highBitMask() const {
+#if BUFF_SIMD_AVX2
+        return uint(_mm256_movemask_epi8(mImpl));
+#elif BUFF_SIMD_SSE2
+        return uint(_mm_movemask_epi8(mImpl));
+#elif BUFF_SIMD_NEON
+        return Detail::toMask(vcltzq_s8(vreinterpretq_s8_u8(mImpl)));
+#else
+        uint result = 0;
+        for (int i = 0; i < SIZE; ++i) {
+            result |= uint(mImpl[i] >> 7) << i;
+        }
+        return result;
+#endif
+    }
+
+    /// Compares elements of TElementSize bytes
+    template <int TElementSize>
+    uint equalMask(const Block& other) const {
+        static_assert(TElementSize == 1 || TElementSize == 2 || TElementSize == 4 || TElementSize == 8);
+#if BUFF_SIMD_AVX2
+        __m256i equal;
+        if constexpr (TElementSize == 1) {
+            equal = _mm256_cmpeq_epi8(mImpl, other.mImpl);
+        } else if constexpr (TElementSize == 2) {
+            equal = _mm256_cmpeq_epi16(mImpl, other.mImpl);
+        } else if constexpr (TElementSize == 4) {
+            equal = _mm256_cmpeq_epi32(mImpl, other.mImpl);
+        } else {
+            equal = _mm256_cmpeq_epi64(mImpl, other.mImpl);
+        }
+        return uint(_mm256_movemask_epi8(equal));
+#elif BUFF_SIMD_SSE2
+        __m128i equal;
+        if constexpr (TElementSize == 1) {
+            equal = _mm_cmpeq_epi8(mImpl, other.mImpl);
+        } else if constexpr (TElementSize == 2) {
+            equal = _mm_cmpeq_epi16(mImpl, other.mImpl);
+        } else {
+            equal = _mm_cmpeq_epi32(mImpl, other.mImpl);
+            if constexpr (TElementSize == 8) {
+                // No 64-bit comparison in SSE2, both halves need to match
+                equal = _mm_and_si128(equal, _mm_shuffle_epi32(equal, _MM_SHUFFLE(2, 3, 0, 1)));
+            }
+        }
+        return uint(_mm_movemask_epi8(equal));
+#elif BUFF_SIMD_NEON
+        uint8x16_t equal;
+        if constexpr (TElementSize == 1) {
+            equal = vceqq_u8(mImpl, other.mImpl);
+        } else if constexpr (TElementSize == 2) {
+            equal = vreinterpretq_u8_u16(
+                vceqq_u16(vreinterpretq_u16_u8(mImpl), vreinterpretq_u16_u8(other.mImpl)));
+        } else if constexpr (TElementSize == 4) {
+            equal = vreinterpretq_u8_u32(
+                vceqq_u32(vreinterpretq_u32_u8(mImpl), vreinterpretq_u32_u8(other.mImpl)));
+        } else {
+            equal = vreinterpretq_u8_u64(
+                vceqq_u64(vreinterpretq_u64_u8(mImpl), vreinterpretq_u64_u8(other.mImpl)));
+        }
+        return Detail::toMask(equal);
+#else
+        uint result = 0;
+        for (int i = 0; i < SIZE; i += TElementSize) {
+            if (std::memcmp(mImpl + i, other.mImpl + i, TElementSize) == 0) {
+                result |= ((1u << TElementSize) - 1) << i;
+            }
+        }
+        return result;
+#endif
+    }
+};
+
+// ===========================================================================================================
+// Search kernels
+// ===========================================================================================================
+
+/// Index of the first element equal to value, or size if there is none
+template <BitwiseComparable T>
+int64 findEqual(const T* data, const int64 size, const T value) {
+    constexpr int PER_BLOCK = Block::SIZE / int(sizeof(T));
+    const Block   needle    = Block::broadcast(value);
+    int64         i         = 0;
+    for (; i + PER_BLOCK <= size; i += PER_BLOCK) {
+        if (const uint mask = Block::load(data + i).template equalMask<sizeof(T)>(needle)) {
+            return i + lowestBit(mask) / int(sizeof(T));
+        }
+    }
+    for (; i < size; ++i) {
+        if (data[i] == value) {
+            return i;
+        }
+    }
+    return size;
+}
+
+/// Index of the first character present in set, or size if there is none
+int64 findFirstOf(const char* data, int64 size, const char* set, int64 setSize);
+
+/// Index of the first occurrence of pattern, or size if there is none. Pattern must not be empty.
+int64 findSubstring(const char* data, int64 size, const char* pattern, int64 patternSize);
+
+} // namespace Simd
+
+BUFF_NAMESPACE_END
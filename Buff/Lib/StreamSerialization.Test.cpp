@@ -0,0 +1,150 @@
+#include "Lib/StreamSerialization.h"
+#include "Lib/containers/Array.h"
+#include "Lib/Bootstrap.Test.h"
+#include "Lib/Exception.h"
+#include "Lib/Filesystem.h"
+#include "Lib/Path.h"
+#include "Lib/String.h"
+#include "Lib/Vector.h"
+
+BUFF_NAMESPACE_BEGIN
+
+namespace {
+struct Data {
+    String         name;
+    Array<int>     numbers;
+    Array<Vector2> points;
+    Array<String>  tags;
+    bool           flag = false;
+
+    void enumerateStructMembers(auto&& functor) {
+        functor(name, "name");
+        functor(numbers, "numbers");
+        functor(points, "points");
+        functor(tags, "tags");
+        functor(flag, "flag");
+    }
+};
+} // namespace
+
+static Data createData() {
+    Data data;
+    data.name = "a string longer than the buffer";
+    for (const int i : range(1000)) {
+        data.numbers.pushBack(i * i);
+        data.points.pushBack(Vector2(float(i), -float(i)));
+    }
+    data.tags = {"x", "", "yz"};
+    data.flag = true;
+    return data;
+}
+
+static void checkData(const Data& data) {
+    const Data expected = createData();
+    CHECK(data.name == expected.name);
+    CHECK(data.numbers == expected.numbers);
+    REQUIRE(data.points.size() == expected.points.size());
+    CHECK(data.points.back().x == expected.points.back().x);
+    CHECK(data.points.back().y == expected.points.back().y);
+    CHECK(data.tags == expected.tags);
+    CHECK(data.flag);
+}
+
+TEST_CASE("StreamBinarySerializer") {
+    for (const bool backgroundIo : {false, true}) {
+        const BinaryStreamSettings settings {.bufferSize = 7, .backgroundIo = backgroundIo};
+
+        // Same bytes as BinarySerializer
+        BinarySerializer reference;
+        reference.serialize(createData(), "data");
+        BinarySerializationState bytes;
+        int                      maxChunkSize = 0;
+        {
+            StreamBinarySerializer serializer(
+                [&](const ArrayView<const std::byte> chunk) {
+                    bytes.insert(bytes.end(), chunk.begin(), chunk.end());
+                    maxChunkSize = max(maxChunkSize, int(chunk.size()));
+                },
+                settings);
+            serializer.serialize(createData(), "data");
+            serializer.flush();
+        }
+        CHECK(bytes == reference.getState());
+        // Only the bitwise lists are passed through without buffering
+        CHECK(maxChunkSize == int(1000 * sizeof(Vector2)));
+
+        int64                    position = 0;
+        StreamBinaryDeserializer deserializer(
+            [&](const ArrayView<std::byte> buffer) -> int64 {
+                const int64 size = min(buffer.size(), int64(bytes.size()) - position);
+                std::memcpy(buffer.data(), bytes.data() + position, size);
+                position += size;
+                return size;
+            },
+            settings);
+        Data data;
+        deserializer.deserialize(data, "data");
+        checkData(data);
+        int dummy;
+        CHECK_THROWS(deserializer.deserialize(dummy, "dummy"));
+    }
+}
+
+TEST_CASE("StreamBinarySerializer errors") {
+    for (const bool backgroundIo : {false, true}) {
+        const BinaryStreamSettings settings {.bufferSize = 16, .backgroundIo = backgroundIo};
+        StreamBinarySerializer     serializer(
+            [](const ArrayView<const std::byte>) { throw Exception("Disk full"); }, settings);
+        // Without background I/O, the error is thrown as soon as the buffer is full
+        CHECK_THROWS([&] {
+            serializer.serialize(createData(), "data");
+            serializer.flush();
+        }());
+
+        StreamBinaryDeserializer deserializer(
+            [](const ArrayView<std::byte>) -> int64 { throw Exception("Disk not found"); }, settings);
+        int dummy;
+        CHECK_THROWS(deserializer.deserialize(dummy, "dummy"));
+    }
+}
+
+TEST_CASE("StreamBinaryDeserializer other formats") {
+    for (const BinaryFormat format : {BinaryFormat::COMPACT, BinaryFormat::TAGGED}) {
+        for (const bool backgroundIo : {false, true}) {
+            BinarySerializer serializer(format);
+            serializer.serialize(createData(), "data");
+            const BinarySerializationState& bytes    = serializer.getState();
+            int64                           position = 0;
+            StreamBinaryDeserializer        deserializer(
+                [&](const ArrayView<std::byte> buffer) -> int64 {
+                    const int64 size = min(buffer.size(), int64(bytes.size()) - position);
+                    std::memcpy(buffer.data(), bytes.data() + position, size);
+                    position += size;
+                    return size;
+                },
+                {.bufferSize = 1, .backgroundIo = backgroundIo});
+            // Reading even the first value would succeed without the header check
+            int dummy;
+            CHECK_THROWS(deserializer.deserialize(dummy, "dummy"));
+        }
+    }
+}
+
+TEST_CASE("StreamBinarySerializer file") {
+    const FilePath path("StreamBinarySerializer.tmp");
+    {
+        StreamBinarySerializer serializer(path, {.backgroundIo = true});
+        serializer.serialize(createData(), "data");
+        serializer.flush();
+    }
+    {
+        StreamBinaryDeserializer deserializer(path, {.bufferSize = 100, .backgroundIo = true});
+        Data                     data;
+        deserializer.deserialize(data, "data");
+        checkData(data);
+    }
+    CHECK(removeFile(path));
+    CHECK_THROWS(StreamBinaryDeserializer {path});
+}
+
+BUFF_NAMESPACE_END
@@ -0,0 +1,344 @@
+#include "Lib/StreamSerialization.h"
+#include "Lib/containers/Array.h"
+#include "Lib/Exception.h"
+#include "Lib/Path.h"
+#include "Lib/String.h"
+#include "Lib/Thread.h"
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+
+BUFF_NAMESPACE_BEGIN
+
+namespace {
+/// Runs one task at a time on its own thread
+class BackgroundTask : public Noncopyable {
+    std::mutex              mMutex;
+    std::condition_variable mCondition;
+    Function<void()>        mTask;
+    bool                    mHasTask = false;
+    bool                    mStop    = false;
+    std::exception_ptr      mError;
+    /// Declared last, so that the thread finishes before the other members are destroyed
+    Thread mThread;
+
+public:
+    BackgroundTask()
+        : mThread([this] { run(); }) {}
+
+    /// Lets the current task finish, its errors are ignored
+    ~BackgroundTask() {
+        {
+            std::unique_lock lock(mMutex);
+            mStop = true;
+        }
+        mCondition.notify_all();
+    }
+
+    /// Waits for the previous task first
+    void start(Function<void()> task) {
+        wait();
+        {
+            std::unique_lock lock(mMutex);
+            mTask    = std::move(task);
+            mHasTask = true;
+        }
+        mCondition.notify_all();
+    }
+
+    /// Rethrows the exception thrown by the last task
+    void wait() {
+        std::unique_lock lock(mMutex);
+        mCondition.wait(lock, [this] { return !mHasTask; });
+        if (mError) {
+            std::rethrow_exception(std::exchange(mError, nullptr));
+        }
+    }
+
+private:
+    void run() {
+        std::unique_lock lock(mMutex);
+        while (true) {
+            mCondition.wait(lock, [this] { return mHasTask || mStop; });
+            if (!mHasTask) {
+                return;
+            }
+            lock.unlock();
+            std::exception_ptr error;
+            try {
+                mTask();
+            } catch (...) {
+                error = std::current_exception();
+            }
+            lock.lock();
+            mError   = error;
+            mTask    = nullptr;
+            mHasTask = false;
+            mCondition.notify_all();
+        }
+    }
+};
+} // namespace
+
+static BinarySink createFileSink(const FilePath& file) {
+    std::ofstream stream(std::filesystem::path(file), std::ios::out | std::ios::binary);
+    if (!stream) {
+        throw Exception("Cannot open file " + file.getGeneric());
+    }
+    return [stream = std::move(stream)](const ArrayView<const std::byte> bytes) mutable {
+        stream.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        if (!stream) {
+            throw Exception("Cannot write to file");
+        }
+    };
+}
+
+static BinarySource createFileSource(const FilePath& file) {
+    std::ifstream stream(std::filesystem::path(file), std::ios::in | std::ios::binary);
+    if (!stream) {
+        throw Exception("Cannot open file " + file.getGeneric());
+    }
+    return [stream = std::move(stream)](const ArrayView<std::byte> buffer) mutable -> int64 {
+        stream.read(reinterpret_cast<char*>(buffer.data()), buffer.size());
+        if (stream.bad()) {
+            throw Exception("Cannot read from file");
+        }
+        return int64(stream.gcount());
+    };
+}
+
+// ===========================================================================================================
+// StreamBinarySerializer
+// ===========================================================================================================
+
+struct StreamBinarySerializer::Impl {
+    BinarySink       sink;
+    Array<std::byte> buffer;
+    int64            bufferUsed = 0;
+    /// Buffer which is being passed to the sink by the background task
+    Array<std::byte>                writtenBuffer;
+    std::unique_ptr<BackgroundTask> background;
+
+    void write(const std::byte* data, const int64 size) {
+        if (size > buffer.size() - bufferUsed) {
+            flushBuffer();
+            if (size >= buffer.size()) {
+                // Would not fit, passed to the sink directly
+                if (background) {
+                    background->wait();
+                }
+                sink(ArrayView(data, size));
+                return;
+            }
+        }
+        if (size > 0) {
+            std::memcpy(buffer.data() + bufferUsed, data, size);
+            bufferUsed += size;
+        }
+    }
+
+    void flushBuffer() {
+        if (bufferUsed == 0) {
+            return;
+        }
+        // Reset first, so that the bytes are not passed to the sink again after it throws
+        const int64 size = std::exchange(bufferUsed, 0);
+        if (background) {
+            background->wait();
+            std::swap(buffer, writtenBuffer);
+            background->start([this, size] { sink(ArrayView<const std::byte>(writtenBuffer.data(), size)); });
+        } else {
+            sink(ArrayView<const std::byte>(buffer.data(), size));
+        }
+    }
+};
+
+StreamBinarySerializer::StreamBinarySerializer(BinarySink sink, const BinaryStreamSettings settings)
+    : mImpl(std::make_unique<Impl>()) {
+    BUFF_ASSERT(settings.bufferSize > 0, settings.bufferSize);
+    mImpl->sink   = std::move(sink);
+    mImpl->buffer = Array<std::byte>(settings.bufferSize);
+    if (settings.backgroundIo) {
+        mImpl->writtenBuffer = Array<std::byte>(settings.bufferSize);
+        mImpl->background    = std::make_unique<BackgroundTask>();
+    }
+}
+
+StreamBinarySerializer::StreamBinarySerializer(const FilePath& file, const BinaryStreamSettings settings)
+    : StreamBinarySerializer(createFileSink(file), settings) {}
+
+StreamBinarySerializer::~StreamBinarySerializer() {
+    try {
+        flush();
+    } catch (...) {
+        // Errors are reported only by explicit flush()
+    }
+}
+
+void StreamBinarySerializer::flush() {
+    mImpl->flushBuffer();
+    if (mImpl->background) {
+        mImpl->background->wait();
+    }
+}
+
+void StreamBinarySerializer::serializePrimitive(const void*                                  data,
+                                                const int                                    size,
+                                                const Detail::PrimitiveSerializationCategory type) {
+    if (type == Detail::PrimitiveSerializationCategory::STRING) {
+        const String& string = *static_cast<const String*>(data);
+        serialize(string.size(), "size");
+        mImpl->write(reinterpret_cast<const std::byte*>(string.asCString()), string.size());
+    } else {
+        mImpl->write(static_cast<const std::byte*>(data), size);
+    }
+}
+void StreamBinarySerializer::serializeListImpl(const std::function<bool()>& itemFunctor) {
+    while (itemFunctor()) {
+    }
+}
+bool StreamBinarySerializer::serializeBitwiseList(const void* data,
+                                                  const int64 size,
+                                                  const bool  BUFF_UNUSED(primitiveElements)) {
+    mImpl->write(static_cast<const std::byte*>(data), size);
+    return true;
+}
+
+// ===========================================================================================================
+// StreamBinaryDeserializer
+// ===========================================================================================================
+
+struct StreamBinaryDeserializer::Impl {
+    BinarySource     source;
+    Array<std::byte> buffer;
+    /// Range of buffer which was not deserialized yet
+    int64 bufferBegin = 0;
+    int64 bufferEnd   = 0;
+    /// Set once the source returns less than a full buffer
+    bool sourceEnded = false;
+    /// Set once the first buffer was checked for the header of other than the fixed format
+    bool formatChecked = false;
+    /// Buffer which is being filled by the background task
+    Array<std::byte>                nextBuffer;
+    int64                           nextBufferSize = 0;
+    std::unique_ptr<BackgroundTask> background;
+
+    void readAhead() {
+        background->start([this] {
+            nextBufferSize = source(ArrayView<std::byte>(nextBuffer.data(), nextBuffer.size()));
+        });
+    }
+
+    /// \return False if there is nothing more to read
+    bool refill() {
+        BUFF_ASSERT(bufferBegin == bufferEnd);
+        if (sourceEnded) {
+            return false;
+        }
+        bufferBegin = 0;
+        if (background) {
+            background->wait();
+            std::swap(buffer, nextBuffer);
+            bufferEnd = nextBufferSize;
+        } else {
+            bufferEnd = source(ArrayView<std::byte>(buffer.data(), buffer.size()));
+        }
+        BUFF_ASSERT(bufferEnd >= 0 && bufferEnd <= buffer.size(), bufferEnd);
+        sourceEnded = bufferEnd < buffer.size();
+        if (background && !sourceEnded) {
+            readAhead();
+        }
+        if (!formatChecked) {
+            formatChecked = true;
+            checkFormat();
+        }
+        return bufferEnd > 0;
+    }
+
+    /// The buffer is never smaller than the header, so the first one contains it whole, if there is any
+    void checkFormat() {
+        const ArrayView<const std::byte> bytes(buffer.data(), bufferEnd);
+        if (Detail::getBinaryFormat(bytes) != BinaryFormat::FIXED) {
+            throw Exception("StreamBinaryDeserializer supports only the fixed binary format");
+        }
+    }
+
+    /// \return Pointer to at most size unread bytes in the buffer, their count is stored to size
+    const std::byte* readChunk(int64& size) {
+        if (bufferBegin == bufferEnd && !refill()) {
+            throw Exception("Not enough data to deserialize");
+        }
+        const std::byte* result = buffer.data() + bufferBegin;
+        size                    = min(size, bufferEnd - bufferBegin);
+        bufferBegin += size;
+        return result;
+    }
+
+    void read(std::byte* data, int64 size) {
+        while (size > 0) {
+            int64                  chunkSize = size;
+            const std::byte* const chunk     = readChunk(chunkSize);
+            std::memcpy(data, chunk, chunkSize);
+            data += chunkSize;
+            size -= chunkSize;
+        }
+    }
+};
+
+StreamBinaryDeserializer::StreamBinaryDeserializer(BinarySource source, const BinaryStreamSettings settings)
+    : mImpl(std::make_unique<Impl>()) {
+    BUFF_ASSERT(settings.bufferSize > 0, settings.bufferSize);
+    const int64 bufferSize = max(settings.bufferSize, Detail::BINARY_HEADER_SIZE);
+    mImpl->source          = std::move(source);
+    mImpl->buffer          = Array<std::byte>(bufferSize);
+    if (settings.backgroundIo) {
+        mImpl->nextBuffer = Array<std::byte>(bufferSize);
+        mImpl->background = std::make_unique<BackgroundTask>();
+        mImpl->readAhead();
+    }
+}
+
+StreamBinaryDeserializer::StreamBinaryDeserializer(const FilePath& file, const BinaryStreamSettings settings)
+    : StreamBinaryDeserializer(createFileSource(file), settings) {}
+
+StreamBinaryDeserializer::~StreamBinaryDeserializer() = default;
+
+void StreamBinaryDeserializer::deserializePrimitive(void*                                        data,
+                                                    const int                                    size,
+                                                    const Detail::PrimitiveSerializationCategory type) {
+    if (size < 0) {
+        throw Exception("Negative size deserialization");
+    }
+    if (type == Detail::PrimitiveSerializationCategory::STRING) {
+        String& string = *static_cast<String*>(data);
+        int     stringSize;
+        deserialize(stringSize, "size");
+        if (stringSize < 0) {
+            throw Exception("Negative size deserialization");
+        }
+        // Appended chunk by chunk, so that a corrupted size cannot allocate more than the data actually has
+        string.clear();
+        int64 remaining = stringSize;
+        while (remaining > 0) {
+            int64            chunkSize = remaining;
+            const std::byte* chunk     = mImpl->readChunk(chunkSize);
+            string += StringView(reinterpret_cast<const char*>(chunk), int(chunkSize));
+            remaining -= chunkSize;
+        }
+    } else {
+        mImpl->read(static_cast<std::byte*>(data), size);
+    }
+}
+void StreamBinaryDeserializer::deserializeListImpl(const std::function<bool()>& itemFunctor) {
+    while (itemFunctor()) {
+    }
+}
+bool StreamBinaryDeserializer::deserializeBitwiseList(void*       data,
+                                                      const int64 size,
+                                                      const bool  BUFF_UNUSED(primitiveElements)) {
+    mImpl->read(static_cast<std::byte*>(data), size);
+    return true;
+}
+
+BUFF_NAMESPACE_END
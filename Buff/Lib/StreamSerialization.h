@@ -0,0 +1,80 @@
+#pragma once
+#include "Lib/containers/ArrayView.h"
+#include "Lib/Function.h"
+#include "Lib/Serialization.h"
+#include <memory>
+
+BUFF_NAMESPACE_BEGIN
+
+class FilePath;
+
+/// Receives the serialized bytes chunk by chunk. Throw Exception to report errors.
+using BinarySink = Function<void(ArrayView<const std::byte> bytes)>;
+
+/// Fills the buffer with the next serialized bytes
+/// \return Number of bytes written to the buffer, less than its size only at the end of the data
+using BinarySource = Function<int64(ArrayView<std::byte> buffer)>;
+
+struct BinaryStreamSettings {
+    /// Bytes kept in memory before they are passed to the sink (or read from the source at once). With
+    /// background I/O, two buffers of this size are used. The deserializer rounds it up to the size of the
+    /// binary format header.
+    int64 bufferSize = 1024 * 1024;
+
+    /// Calls the sink (source) on a separate thread, overlapping I/O with (de)serialization
+    bool backgroundIo = false;
+};
+
+// ===========================================================================================================
+// StreamBinarySerializer/StreamBinaryDeserializer
+// ===========================================================================================================
+
+/// Writes the same bytes as BinarySerializer, but passes them to the sink whenever the buffer fills up
+/// instead of keeping the whole output in memory
+class StreamBinarySerializer final : public ISerializer {
+    struct Impl;
+    std::unique_ptr<Impl> mImpl;
+
+public:
+    explicit StreamBinarySerializer(BinarySink sink, BinaryStreamSettings settings = {});
+    /// Throws Exception when the file cannot be opened
+    explicit StreamBinarySerializer(const FilePath& file, BinaryStreamSettings settings = {});
+
+    /// Flushes the remaining bytes, but cannot report errors. Call flush() to get them.
+    virtual ~StreamBinarySerializer() override;
+
+    /// Passes all bytes serialized so far to the sink and waits until it has processed them
+    /// Rethrows exceptions thrown by the sink, including those from earlier background writes.
+    void flush();
+
+private:
+    virtual void serializePrimitive(const void*                            data,
+                                    int                                    size,
+                                    Detail::PrimitiveSerializationCategory type) override;
+    virtual void serializeListImpl(const std::function<bool()>& itemFunctor) override;
+    virtual bool serializeBitwiseList(const void* data, int64 size, bool primitiveElements) override;
+};
+
+/// Reads bytes written by StreamBinarySerializer, or by BinarySerializer in the fixed format, from the
+/// source, one buffer at a time. Throws Exception on the first read when the data starts with the header of
+/// another binary format. With background I/O, the next buffer is read ahead while the current one is being
+/// deserialized.
+class StreamBinaryDeserializer final : public IDeserializer {
+    struct Impl;
+    std::unique_ptr<Impl> mImpl;
+
+public:
+    explicit StreamBinaryDeserializer(BinarySource source, BinaryStreamSettings settings = {});
+    /// Throws Exception when the file cannot be opened
+    explicit StreamBinaryDeserializer(const FilePath& file, BinaryStreamSettings settings = {});
+    virtual ~StreamBinaryDeserializer() override;
+
+private:
+    virtual void deserializePrimitive(void*                                  data,
+                                      int                                    size,
+                                      Detail::PrimitiveSerializationCategory type) override;
+    virtual void deserializeListImpl(const std::function<bool()>& itemFunctor) override;
+    virtual bool deserializeBitwiseList(void* data, int64 size, bool primitiveElements) override;
+};
+
+BUFF_NAMESPACE_END
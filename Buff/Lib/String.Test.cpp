@@ -1,6 +1,7 @@
 #include "Lib/String.h"
 #include "Lib/Bootstrap.Test.h"
 #include "Lib/containers/Array.h"
+#include "Lib/Random.h"
 
 BUFF_NAMESPACE_BEGIN
 
@@ -278,13 +279,61 @@ TEST_CASE("fromStr") {
     CHECK(fromStr<int>("0") == 0);
     CHECK(fromStr<int>("10") == 10);
     CHECK(fromStr<int>("-10") == -10);
+    CHECK(fromStr<uint8>("255") == 255);
+    CHECK(fromStr<int64>("-9223372036854775808") == INT64_MIN);
+    CHECK(fromStr<double>("1.5") == 1.5);
+    CHECK(fromStr<double>("-2e-3") == -2e-3);
+    CHECK(fromStr<float>("0.1") == 0.1f);
+
+    CHECK(!fromStr<int>(""));
+    CHECK(!fromStr<int>("10a"));
+    CHECK(!fromStr<int>(" 10"));
+    CHECK(!fromStr<uint8>("256"));
+    CHECK(!fromStr<uint>("-1"));
+    CHECK(!fromStr<double>("1.5."));
+    CHECK(!fromStr<double>("abc"));
+}
+
+TEST_CASE("toStr numbers") {
+    CHECK_STREQ(toStr(0), "0");
+    CHECK_STREQ(toStr(-123), "-123");
+    CHECK_STREQ(toStr(uint8(200)), "200");
+    CHECK_STREQ(toStr(int8(-5)), "-5");
+    CHECK_STREQ(toStr(UINT64_MAX), "18446744073709551615");
+    CHECK_STREQ(toStr('x'), "x");
 }
 
 TEST_CASE("toStr doubles") {
-    // Testing exact print of decimal places beyond what streams print by default. The constant tested is
-    // 1/2^20 - a number that is exactly representable as double
-    CHECK_STREQ(toStr(1.00000095367431640625), "1.00000095367431640625");
+    // Shortest representation which reads back as the same number. The first constant is 1 + 1/2^20, which
+    // needs 17 significant digits
+    CHECK_STREQ(toStr(1.00000095367431640625), "1.0000009536743164");
+    CHECK(fromStr<double>(toStr(1.00000095367431640625)) == 1.00000095367431640625);
     CHECK_STREQ(toStr(14695031469503.0), "14695031469503");
+    CHECK_STREQ(toStr(0.1), "0.1");
+    CHECK_STREQ(toStr(0.1f), "0.1");
+    CHECK_STREQ(toStr(-1e300), "-1e+300");
+
+    for (const double value : {1.0 / 3.0, 2.0 / 3.0, 1e-320, 123456.789e10, -0.0}) {
+        CHECK(fromStr<double>(toStr(value)) == value);
+    }
+}
+
+TEST_CASE("formatBigNumber") {
+    CHECK(formatBigNumber(0) == "0");
+    CHECK(formatBigNumber(999) == "999");
+    CHECK(formatBigNumber(1000) == "1 000");
+    CHECK(formatBigNumber(-1234567) == "-1 234 567");
+    CHECK(formatBigNumber(INT64_MIN) == "-9 223 372 036 854 775 808");
+}
+
+TEST_CASE("toStrHexadecimal") {
+    CHECK(toStrHexadecimal(0) == "0");
+    CHECK(toStrHexadecimal(255) == "ff");
+    CHECK(toStrHexadecimal(-1) == "ffffffffffffffff");
+    CHECK(fromStrHexadecimal("fF") == 255);
+    CHECK(fromStrHexadecimal("001f") == 31);
+    CHECK(!fromStrHexadecimal("1g"));
+    CHECK(!fromStrHexadecimal(""));
 }
 
 TEST_CASE("parseNumber") {
@@ -326,6 +375,10 @@ TEST_CASE("formatFloat") {
     CHECK(formatFloat(-1.1234, {.maxDecimals = 10}) == "-1.1234");
     CHECK(formatFloat(-1.1234, {.maxDecimals = 6, .forceDecimals = true}) == "-1.123400");
     CHECK(formatFloat(-12345, {.maxDecimals = 6, .forceDecimals = true}) == "-12345.000000");
+
+    CHECK(formatFloat(420, {.maxDecimals = 0}) == "420");
+    CHECK(formatFloat(0.125, {.maxDecimals = 2}) == "0.12");
+    CHECK(formatFloat(1e300, {.maxDecimals = 1}).size() == 301);
 }
 
 TEST_CASE("String::explode") {
@@ -389,6 +442,36 @@ TEST_CASE("String getLevenshteinDistance") {
     CHECK(getLevenshteinDistance("aDaD", "a").distance == 3);
 }
 
+TEST_CASE("String getLevenshteinDistanceOnly") {
+    CHECK(getLevenshteinDistanceOnly("", "") == 0);
+    CHECK(getLevenshteinDistanceOnly("", "abc") == 3);
+    CHECK(getLevenshteinDistanceOnly("abc", "") == 3);
+    CHECK(getLevenshteinDistanceOnly("kitten", "sitting") == 3);
+    CHECK(getLevenshteinDistanceOnly("kitten", "sitting", 3) == 3);
+    CHECK(getLevenshteinDistanceOnly("kitten", "sitting", 2) == NULL_OPTIONAL);
+    CHECK(getLevenshteinDistanceOnly("a", "abcdef", 4) == NULL_OPTIONAL);
+
+    // Compare to the full algorithm, with patterns spanning 1 to 3 blocks of 64 characters
+    RandomNumberGenerator rng;
+    for ([[maybe_unused]] const int i : range(300)) {
+        String from, to;
+        for ([[maybe_unused]] const int j : range(rng.getRandomInt(150))) {
+            from << char('a' + rng.getRandomInt(3));
+        }
+        for ([[maybe_unused]] const int j : range(rng.getRandomInt(150))) {
+            to << char('a' + rng.getRandomInt(3));
+        }
+        const int distance = getLevenshteinDistance(from, to).distance;
+        CHECK(getLevenshteinDistanceOnly(from, to) == distance);
+        CHECK(getLevenshteinDistanceOnly(to, from) == distance);
+        CHECK(LevenshteinMatcher(from).getDistance(to) == distance);
+        CHECK(LevenshteinMatcher(from).getDistance(to, distance) == distance);
+        if (distance > 0) {
+            CHECK(LevenshteinMatcher(from).getDistance(to, distance - 1) == NULL_OPTIONAL);
+        }
+    }
+}
+
 TEST_CASE("String getLevenshteinDistance reconstruction") {
     struct Data {
         String        from;
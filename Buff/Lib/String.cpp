@@ -1,8 +1,8 @@
 #include "Lib/String.h"
 #include "Lib/containers/Array.h"
 #include "Lib/Exception.h"
+#include "Lib/Utf8.h"
 #include "Lib/Utils.h"
-#include <utf8cpp/utf8/checked.h>
 #ifdef __EMSCRIPTEN__
 #    include <iomanip>
 #endif
@@ -15,46 +15,27 @@ String::String(const std::wstring& str) {
             BUFF_ASSERT(i != L'\0');
         }
     }
-
-    if constexpr (BUFF_DEBUG) {
-        // TODO: std::ranges version not supported by emscripten yet
-        if (std::ranges::all_of(str, isascii)) { // Faster in debug...
-            mImpl.reserve(str.size() + 1);
-            for (const wchar_t i : str) {
-                BUFF_ASSERT(i <= 127); // iswascii does not work with emscripten
-                mImpl.pushBack(char(i));
-            }
-            afterModification();
-            return;
-        }
+    if (str.empty()) {
+        return;
     }
-    struct BackInserter {
-        Array<char>* array;
-        void         operator=(const char value) {
-            array->pushBack(value);
-        }
-        BackInserter& operator++(int) {
-            return *this;
-        }
-        BackInserter& operator*() {
-            return *this;
-        }
-    };
-    utf8::utf16to8(str.begin(), str.end(), BackInserter {&mImpl});
+    constexpr int MAX_BYTES_PER_UNIT = sizeof(wchar_t) == 2 ? 3 : 4;
+    const int64   length             = int64(str.size());
+    mImpl.resize(int(length * MAX_BYTES_PER_UNIT));
+    Optional<int64> size;
+    if constexpr (sizeof(wchar_t) == 2) {
+        size = Utf8::fromUtf16(reinterpret_cast<const char16_t*>(str.data()), length, mImpl.data());
+    } else {
+        size = Utf8::fromUtf32(reinterpret_cast<const char32_t*>(str.data()), length, mImpl.data());
+    }
+    if (!size) {
+        throw Exception("Invalid UTF-16 string");
+    }
+    mImpl.resize(int(*size));
     afterModification();
 }
 
 std::wstring String::asWString() const {
-    if (isEmpty()) {
-        return {};
-    }
-    std::wstring result;
-    try {
-        utf8::utf8to16(mImpl.begin(), mImpl.end() - 1, std::back_inserter(result));
-    } catch (...) {
-        throw Exception("Invalid UTF-8 string");
-    }
-    return result;
+    return StringView(*this).asWString();
 }
 
 String String::fromCp1252(const char* array, const int numChars) {
@@ -77,13 +58,14 @@ String String::fromCp1252(const char* array, const int numChars) {
 
     Array<char> result;
     result.reserve(numChars);
-    for (const int i : range(numChars)) {
-        const char in = array[i];
-        if (in >= 0) {
-            result.pushBack(in);
-        } else {
-            result.pushBackRange(ArrayView(UTF8_CONVERSIONS[static_cast<unsigned char>(in) - 128]));
+    for (int i = 0; i < numChars;) {
+        const int asciiEnd = int(i + Utf8::findNonAscii(array + i, numChars - i));
+        result.pushBackRange(ArrayView(array + i, asciiEnd - i));
+        if (asciiEnd < numChars) {
+            const int index = static_cast<unsigned char>(array[asciiEnd]) - 128;
+            result.pushBackRange(ArrayView(UTF8_CONVERSIONS[index]));
         }
+        i = asciiEnd + 1;
     }
     return fromArray(std::move(result));
 }
@@ -101,11 +83,11 @@ String& String::operator=(const StringView stringView) {
 }
 
 bool String::isAscii() const {
-    return std::ranges::all_of(mImpl, Buff::isAscii);
+    return Utf8::isAscii(mImpl.data(), size());
 }
 
 bool String::isValidUtf8() const {
-    return utf8::is_valid(mImpl.begin(), mImpl.end());
+    return Utf8::isValid(mImpl.data(), size());
 }
 
 String String::getQuoted() const {
@@ -125,53 +107,76 @@ String operator+(const String& a, const String& b) {
 }
 
 String formatBigNumber(const int64 number) {
-    struct SeparateThousands : std::numpunct<char> {
-        virtual char_type do_thousands_sep() const override {
-            return ' ';
-        } // separate with commas
-        virtual string_type do_grouping() const override {
-            return "\3";
-        } // groups of 3 digit
-    };
+    char      digits[MAX_FORMATTED_NUMBER_SIZE];
+    const int size       = formatNumber(digits, number);
+    const int firstDigit = number < 0 ? 1 : 0;
+    const int numDigits  = size - firstDigit;
 
-    std::stringstream tmp;
-    tmp.imbue(std::locale(tmp.getloc(), new SeparateThousands()));
-
-    tmp << number;
-    return tmp.str();
+    String result;
+    result.reserve(size + numDigits / 3);
+    result << StringView(digits, firstDigit);
+    for (const int i : range(numDigits)) {
+        if (i > 0 && (numDigits - i) % 3 == 0) {
+            result << ' ';
+        }
+        result << digits[firstDigit + i];
+    }
+    return result;
 }
 
 String toStrHexadecimal(const int64 number) {
-    std::stringstream tmp;
-    tmp << std::hex << number;
-    return tmp.str();
+    char                       buffer[MAX_FORMATTED_NUMBER_SIZE];
+    const std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), uint64(number), 16);
+    BUFF_ASSERT(result.ec == std::errc());
+    return String(buffer, int(result.ptr - buffer));
 }
 
 Optional<int64> fromStrHexadecimal(const StringView number) {
-    int64             result;
-    std::stringstream tmp;
-    tmp << number;
-    tmp >> std::hex >> result;
-    if (tmp.fail()) {
-        return {};
+    return Detail::fromChars<int64>(number, 16, true);
+}
+
+Optional<double> Detail::parseDoubleWithStrtod(const StringView value) {
+    // strtod would skip leading whitespace, from_chars does not
+    if (value.isEmpty() || isWhitespace(value[0])) {
+        return NULL_OPTIONAL;
+    }
+    const String copy(value); // Zero-terminated
+    char*        end    = nullptr;
+    const double result = std::strtod(copy.asCString(), &end);
+    if (end != copy.asCString() + copy.size()) {
+        return NULL_OPTIONAL;
     }
     return result;
 }
 
 String formatFloat(const double number, const FormatFloatParams& params) {
     BUFF_ASSERT(params.maxDecimals >= 0);
-    std::stringstream tmp;
-    tmp << std::fixed << std::setprecision(params.maxDecimals) << number;
-    String res = tmp.str();
-    if (!params.forceDecimals) {
-        while (res.endsWith("0")) {
-            res.erase(res.size() - 1);
+    // Fixed notation of huge numbers does not fit into the small buffer, which is rare enough to just retry
+    char                 smallBuffer[64];
+    Array<char>          bigBuffer;
+    char*                buffer     = smallBuffer;
+    int64                bufferSize = sizeof(smallBuffer);
+    std::to_chars_result result =
+        std::to_chars(buffer, buffer + bufferSize, number, std::chars_format::fixed, params.maxDecimals);
+    if (result.ec == std::errc::value_too_large) {
+        bigBuffer.resize(params.maxDecimals + 400);
+        buffer     = bigBuffer.data();
+        bufferSize = bigBuffer.size();
+        result     = std::to_chars(buffer, buffer + bufferSize, number, std::chars_format::fixed,
+                                   params.maxDecimals);
+    }
+    BUFF_ASSERT(result.ec == std::errc());
+
+    StringView formatted(buffer, int(result.ptr - buffer));
+    if (!params.forceDecimals && params.maxDecimals > 0) {
+        while (formatted.endsWith("0")) {
+            formatted = formatted.getSubstring(0, formatted.size() - 1);
         }
-        if (res.endsWith(".")) {
-            res.erase(res.size() - 1);
+        if (formatted.endsWith(".")) {
+            formatted = formatted.getSubstring(0, formatted.size() - 1);
         }
     }
-    return res;
+    return formatted;
 }
 
 String String::getToLower() const {
@@ -299,6 +304,100 @@ LevenshteinDistance getLevenshteinDistance(const StringView& from, const StringV
     return LevenshteinDistance(v0.back());
 }
 
+/// Advances one 64-character block of the pattern by one character of the text. Pv and mv are the positive
+/// and negative vertical differences between consecutive rows of the dynamic programming matrix.
+/// \param hIn Horizontal difference entering the block from above
+/// \return Horizontal difference at lastBit
+static int advanceMyersBlock(uint64& pv, uint64& mv, const uint64 eq, const int hIn, const uint64 lastBit) {
+    const uint64 hInNegative = hIn < 0 ? 1 : 0;
+    const uint64 xv          = eq | mv;
+    const uint64 eqIn        = eq | hInNegative;
+    const uint64 xh          = (((eqIn & pv) + pv) ^ pv) | eqIn;
+    uint64       ph          = mv | ~(xh | pv);
+    uint64       mh          = pv & xh;
+    const int    hOut        = (ph & lastBit) ? 1 : (mh & lastBit) ? -1 : 0;
+    ph                       = (ph << 1) | uint64(hIn > 0);
+    mh                       = (mh << 1) | hInNegative;
+    pv                       = mh | ~(xv | ph);
+    mv                       = ph & xv;
+    return hOut;
+}
+
+/// \param peq Bit masks of positions of each byte value in the pattern, [byte * numBlocks + block]
+/// \param vertical Working space for 2 * numBlocks words
+static Optional<int> getMyersDistance(const uint64*    peq,
+                                      const int        numBlocks,
+                                      const int        patternSize,
+                                      const StringView text,
+                                      const int        maxDistance,
+                                      uint64*          vertical) {
+    const int textSize = text.size();
+    if (abs(patternSize - textSize) > maxDistance) {
+        return NULL_OPTIONAL;
+    }
+    if (patternSize == 0) {
+        return textSize;
+    }
+    uint64* pv = vertical;
+    uint64* mv = vertical + numBlocks;
+    for (const int i : range(numBlocks)) {
+        // First column is the distance from the empty string, growing by one in each row
+        pv[i] = ~uint64(0);
+        mv[i] = 0;
+    }
+    const uint64 lastBit = uint64(1) << ((patternSize - 1) % 64);
+    int          score   = patternSize;
+    for (int j = 0; j < textSize; ++j) {
+        const uint64* eq = peq + uint8(text[j]) * numBlocks;
+        // First row is the distance to the empty string, growing by one in each column
+        int hIn = 1;
+        for (int i = 0; i < numBlocks - 1; ++i) {
+            hIn = advanceMyersBlock(pv[i], mv[i], eq[i], hIn, uint64(1) << 63);
+        }
+        score += advanceMyersBlock(pv[numBlocks - 1], mv[numBlocks - 1], eq[numBlocks - 1], hIn, lastBit);
+
+        // The distance decreases by at most one per remaining character
+        if (score - (textSize - 1 - j) > maxDistance) {
+            return NULL_OPTIONAL;
+        }
+    }
+    return score;
+}
+
+LevenshteinMatcher::LevenshteinMatcher(const StringView pattern)
+    : mNumBlocks(max((pattern.size() + 63) / 64, 1))
+    , mPatternSize(pattern.size()) {
+    mPeq.resize(256 * mNumBlocks); // Zero-initialized
+    for (const int i : range(mPatternSize)) {
+        mPeq[uint8(pattern[i]) * mNumBlocks + i / 64] |= uint64(1) << (i % 64);
+    }
+}
+
+Optional<int> LevenshteinMatcher::getDistance(const StringView text, const int maxDistance) const {
+    if (mNumBlocks == 1) {
+        uint64 vertical[2];
+        return getMyersDistance(mPeq.data(), 1, mPatternSize, text, maxDistance, vertical);
+    }
+    Array<uint64> vertical(2 * mNumBlocks);
+    return getMyersDistance(mPeq.data(), mNumBlocks, mPatternSize, text, maxDistance, vertical.data());
+}
+
+Optional<int> getLevenshteinDistanceOnly(StringView from, StringView to, const int maxDistance) {
+    // The distance is symmetric, use the shorter string as the pattern so that it needs fewer blocks
+    if (from.size() > to.size()) {
+        std::swap(from, to);
+    }
+    if (from.size() > 64) {
+        return LevenshteinMatcher(from).getDistance(to, maxDistance);
+    }
+    uint64 peq[256] = {};
+    for (const int i : range(from.size())) {
+        peq[uint8(from[i])] |= uint64(1) << i;
+    }
+    uint64 vertical[2];
+    return getMyersDistance(peq, 1, from.size(), to, maxDistance, vertical);
+}
+
 String leftPad(const StringView input, const int desiredLength, const char paddingChar) {
     BUFF_ASSERT(desiredLength >= 0);
     const int numPad = desiredLength - input.size();
@@ -3,12 +3,13 @@
 #include "Lib/containers/Array.h"
 #include "Lib/Optional.h"
 #include "Lib/StringView.h"
+#include <charconv>
 #include <sstream>
 #include <string>
 
 BUFF_NAMESPACE_BEGIN
 
-template <NonConst T>
+template <NonConst T, typename TAllocator>
 class Array;
 class String;
 
@@ -227,7 +228,7 @@ public:
     // =======================================================================================================
 
     size_t getHash() const {
-        return std::hash<std::string_view>()(std::string_view(StringView(*this)));
+        return StringView(*this).getHash();
     }
 
     void clear() {
@@ -328,6 +329,21 @@ public:
         return StringView(*this).explode(delimiter);
     }
 
+    /// See StringView::split. The string needs to outlive the range, so calling these on temporaries is
+    /// disabled.
+    StringSplitRange<Detail::SplitByDelimiter> split(const StringView delimiter) const& {
+        return StringView(*this).split(delimiter);
+    }
+    StringSplitRange<Detail::SplitByAnyOf> splitByAnyOf(const StringView chars) const& {
+        return StringView(*this).splitByAnyOf(chars);
+    }
+    StringSplitRange<Detail::SplitLines> splitLines() const& {
+        return StringView(*this).splitLines();
+    }
+    void split(StringView delimiter) const&&    = delete;
+    void splitByAnyOf(StringView chars) const&& = delete;
+    void splitLines() const&&                   = delete;
+
 private:
     void beforeModification() {
         BUFF_ASSERT(mImpl.size() != 1);
@@ -387,43 +403,96 @@ inline std::ostream& operator<<(std::ostream& stream, const String& string) {
     return stream;
 }
 
-template <typename T>
-String toStr(T&& value) requires SerializableWithStdStreams<T> {
-    std::stringstream tmp;
-    if constexpr (std::is_floating_point_v<std::decay_t<T>>) {
-        tmp.precision(99); // Increase precision for lossless print
+/// Buffer size sufficient for formatNumber
+inline constexpr int MAX_FORMATTED_NUMBER_SIZE = 32;
+
+/// Writes the decimal representation of the number into the buffer, using std::to_chars instead of iostreams.
+/// Floating point numbers use the shortest representation which reads back as exactly the same value.
+/// \param buffer Must have space for MAX_FORMATTED_NUMBER_SIZE characters
+/// \return Number of characters written
+template <Number T>
+int formatNumber(char* buffer, const T value) {
+    const std::to_chars_result result = std::to_chars(buffer, buffer + MAX_FORMATTED_NUMBER_SIZE, value);
+    BUFF_ASSERT(result.ec == std::errc());
+    return int(result.ptr - buffer);
+}
+
+namespace Detail {
+/// Fallback for platforms without std::from_chars for floating point numbers
+Optional<double> parseDoubleWithStrtod(StringView value);
+
+/// \param wholeString If false, only a prefix of the value needs to be a number
+template <Number T>
+Optional<T> fromChars(const StringView value, const int base, const bool wholeString) {
+    const char* begin = value.data();
+    const char* end   = begin + value.size();
+    T           result;
+    if constexpr (std::is_floating_point_v<T>) {
+        BUFF_ASSERT(base == 10 && wholeString);
+#ifdef __EMSCRIPTEN__
+        // 2024-06 Still missing std::from_chars for floating point numbers
+        const Optional<double> parsed = parseDoubleWithStrtod(value);
+        if (!parsed) {
+            return NULL_OPTIONAL;
+        }
+        result = T(*parsed);
+#else
+        const std::from_chars_result parsed = std::from_chars(begin, end, result);
+        if (parsed.ec != std::errc() || parsed.ptr != end) {
+            return NULL_OPTIONAL;
+        }
+#endif
+    } else {
+        const std::from_chars_result parsed = std::from_chars(begin, end, result, base);
+        if (parsed.ec != std::errc() || (wholeString && parsed.ptr != end)) {
+            return NULL_OPTIONAL;
+        }
     }
-    tmp << std::forward<T>(value);
-    return String(tmp.str());
+    return result;
 }
+} // namespace Detail
 
 template <typename T>
-Optional<T> fromStr(const String& value) {
-    std::stringstream tmp;
-    tmp << value;
-    T result;
-    tmp >> result;
-    if (!tmp.fail()) {
-        return result;
+String toStr(T&& value) requires SerializableWithStdStreams<T> {
+    if constexpr (Number<std::decay_t<T>>) {
+        char buffer[MAX_FORMATTED_NUMBER_SIZE];
+        return String(buffer, formatNumber(buffer, value));
     } else {
-        return NULL_OPTIONAL;
+        std::stringstream tmp;
+        tmp << std::forward<T>(value);
+        return String(tmp.str());
     }
 }
 
+/// Numbers are parsed with std::from_chars: the whole string needs to be a number, without leading whitespace
+/// or '+', and it needs to fit into T. Other types are read from a stringstream.
 template <typename T>
-Optional<T> parseNumber(const String& value, const int base) {
-    char*       begin  = const_cast<char*>(value.asCString()); // Necessary for C API
-    char*       end    = begin + value.size();
-    const int64 result = std::strtoull(begin, &end, base);
-    if (end != begin) {
-        return T(result);
+Optional<T> fromStr(const StringView value) {
+    if constexpr (Number<T>) {
+        return Detail::fromChars<T>(value, 10, true);
     } else {
-        return NULL_OPTIONAL;
+        std::stringstream tmp;
+        tmp << value;
+        T result;
+        tmp >> result;
+        if (!tmp.fail()) {
+            return result;
+        } else {
+            return NULL_OPTIONAL;
+        }
     }
 }
 
+/// Parses the integer at the start of the value, ignoring anything after it
+template <Integer T>
+Optional<T> parseNumber(const StringView value, const int base) {
+    return Detail::fromChars<T>(value, base, false);
+}
+
+/// Separates thousands with spaces, e.g. "1 234 567"
 String formatBigNumber(int64 number);
 
+/// Lowercase, without leading zeros. Negative numbers are printed as their two's complement.
 String toStrHexadecimal(int64 number);
 
 Optional<int64> fromStrHexadecimal(StringView number);
@@ -433,6 +502,7 @@ struct FormatFloatParams {
     bool forceDecimals = false;
     // bool separateThousands = false;
 };
+/// Fixed notation rounded to params.maxDecimals, formatted with std::to_chars
 String formatFloat(double number, const FormatFloatParams& params);
 
 inline bool isWhitespace(const char character) {
@@ -500,8 +570,30 @@ struct LevenshteinDistance {
     Array<Change> changes;
 };
 
+/// Also reconstructs the list of changes, O(n * m) time and memory. Use getLevenshteinDistanceOnly when only
+/// the distance is needed.
 LevenshteinDistance getLevenshteinDistance(const StringView& from, const StringView& to);
 
+/// Computes Levenshtein distances from a single pattern to many strings, with the bit-parallel algorithm of
+/// Myers (as extended to multiple words by Hyyrö): 64 characters of the pattern are processed at once, so
+/// the cost is O(n * ceil(m / 64)). Compares bytes, not code points.
+class LevenshteinMatcher {
+    /// For each byte value, bit masks of its positions in the pattern, one 64-bit word per block
+    Array<uint64> mPeq;
+    int           mNumBlocks;
+    int           mPatternSize;
+
+public:
+    explicit LevenshteinMatcher(StringView pattern);
+
+    /// \return NULL_OPTIONAL as soon as the distance is known to be larger than maxDistance
+    Optional<int> getDistance(StringView text, int maxDistance = INT_MAX) const;
+};
+
+/// Distance only, without the changes. Does not allocate when the shorter string has at most 64 characters.
+/// \return NULL_OPTIONAL as soon as the distance is known to be larger than maxDistance
+Optional<int> getLevenshteinDistanceOnly(StringView from, StringView to, int maxDistance = INT_MAX);
+
 /// \param toStrFunctor
 /// If specified, it is used to stringize each element of the list. Otherwise, the default toStr() is used.
 template <IterableContainer T, typename TFunctor = std::nullptr_t>
@@ -0,0 +1,96 @@
+#include "Lib/StringBuilder.h"
+#include "Lib/Bootstrap.Test.h"
+#include "Lib/Json.h"
+#include "Lib/Time.h"
+#include <iostream>
+
+BUFF_NAMESPACE_BEGIN
+
+TEST_CASE("StringBuilder append") {
+    StringBuilder builder;
+    CHECK(builder.isEmpty());
+    CHECK(builder.toString() == "");
+
+    builder << "abc" << 'd' << String("ef") << StringView("gh");
+    builder.appendRepeated('-', 3);
+    CHECK(builder.size() == 11);
+    CHECK(builder.toString() == "abcdefgh---");
+
+    builder.clear();
+    CHECK(builder.isEmpty());
+    builder << "x";
+    CHECK(builder.toString() == "x");
+}
+
+TEST_CASE("StringBuilder chunks") {
+    StringBuilder builder(16);
+    String        expected;
+    for (const int i : range(1000)) {
+        const String piece = String("item") + toStr(i) + ";";
+        builder << piece;
+        expected << piece;
+    }
+    builder.appendRepeated('.', 5000);
+    for ([[maybe_unused]] const int i : range(5000)) {
+        expected << '.';
+    }
+    CHECK(builder.size() == expected.size());
+    CHECK(builder.toString() == expected);
+
+    int64 chunks = 0;
+    int64 total  = 0;
+    builder.forEachChunk([&](const StringView chunk) {
+        ++chunks;
+        total += chunk.size();
+    });
+    CHECK(chunks > 1);
+    CHECK(total == expected.size());
+
+    // Bigger than a single chunk
+    StringBuilder big;
+    big.appendRepeated('a', StringBuilder::MAX_CHUNK_SIZE * 2 + 3);
+    big << "end";
+    const String bigString = big.toString();
+    CHECK(bigString.size() == StringBuilder::MAX_CHUNK_SIZE * 2 + 6);
+    CHECK(bigString.endsWith("aend"));
+}
+
+TEST_CASE("StringBuilder appendFormatted") {
+    StringBuilder builder;
+    builder << 0 << ' ' << -42 << ' ' << uint64(18446744073709551615ull) << ' ' << int64(INT64_MIN);
+    CHECK(builder.toString() == "0 -42 18446744073709551615 -9223372036854775808");
+
+    builder.clear();
+    builder << 1.5 << ' ' << 123.0 << ' ' << 0.1 << ' ' << -2.5e-10 << ' ' << 1.f;
+    CHECK(builder.toString() == "1.5 123 0.1 -2.5e-10 1");
+}
+
+TEST_CASE("StringBuilder JSON") {
+    const Optional<JsObject> json = parseJson(R"({"a": [1, 2.5, "x\"y"], "b": {"c": null}})");
+    REQUIRE(json);
+    CHECK(json->toJson() == R"({"a": [1, 2.5, "x\"y"], "b": {"c": null}})");
+    CHECK(json->toJson(0) == "{\n    \"a\": [1, 2.5, \"x\\\"y\"],\n    \"b\": {\n        \"c\": null\n    }\n}");
+
+    JsArray withHoles;
+    withHoles[2] = 1.;
+    CHECK(withHoles.toJson() == "[undefined, undefined, 1]");
+
+    CHECK(escapeJson("a\tb\x01") == "a\\tb\\u0001");
+}
+
+TEST_CASE("StringBuilder benchmark" * doctest::skip()) {
+    JsObject root;
+    for (const int i : range(200'000)) {
+        JsObject item;
+        item["name"]  = "item" + toStr(i);
+        item["value"] = double(i) * 0.5;
+
+        root["item" + toStr(i)] = std::move(item);
+    }
+    Timer timer;
+    const String json = root.toJson(0);
+    std::cout << "toJson of " << json.size() << " bytes took " << timer.getElapsed().getUserReadable()
+              << std::endl;
+}
+
+BUFF_NAMESPACE_END
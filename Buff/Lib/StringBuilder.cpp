@@ -0,0 +1,30 @@
+#include "Lib/StringBuilder.h"
+
+BUFF_NAMESPACE_BEGIN
+
+String StringBuilder::toString() const {
+    BUFF_ASSERT(mSize < INT_MAX, mSize);
+    if (mSize == 0) {
+        return {};
+    }
+    Array<char> result;
+    result.reserve(mSize + 1);
+    forEachChunk([&](const StringView chunk) { result.pushBackRange(ArrayView(chunk)); });
+    return String::fromArray(std::move(result));
+}
+
+void StringBuilder::clear() {
+    if (mChunks.notEmpty()) {
+        mChunks.resize(1);
+        mChunks[0].size = 0;
+    }
+    mSize = 0;
+}
+
+void StringBuilder::addChunk(const int64 needed) {
+    const int64 capacity = max(mNextCapacity, min(needed, MAX_CHUNK_SIZE));
+    mChunks.pushBack(Chunk {std::unique_ptr<char[]>(new char[capacity]), 0, capacity});
+    mNextCapacity = min(capacity * 2, MAX_CHUNK_SIZE);
+}
+
+BUFF_NAMESPACE_END
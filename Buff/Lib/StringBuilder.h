@@ -0,0 +1,136 @@
+#pragma once
+#include "Lib/Bootstrap.h"
+#include "Lib/containers/Array.h"
+#include "Lib/String.h"
+#include "Lib/StringView.h"
+#include <memory>
+
+BUFF_NAMESPACE_BEGIN
+
+/// Assembles a long string from many small pieces, e.g. a serialized document. Text is appended into a list of
+/// chunks which grow geometrically and are never reallocated, so appending never copies text written before.
+/// The contiguous result is assembled only once, by toString(), or the chunks are written out directly with
+/// forEachChunk() or writeTextFile().
+class StringBuilder : public NoncopyableMovable {
+    struct Chunk {
+        std::unique_ptr<char[]> data;
+        int64                   size;
+        int64                   capacity;
+    };
+
+    Array<Chunk> mChunks;
+    /// Sum of sizes of all chunks
+    int64 mSize = 0;
+    /// Capacity of the next chunk to allocate
+    int64 mNextCapacity;
+
+public:
+    static constexpr int64 DEFAULT_FIRST_CHUNK_SIZE = 256;
+    static constexpr int64 MAX_CHUNK_SIZE           = 1024 * 1024;
+
+    /// \param expectedSize Capacity of the first chunk. When the final size is known upfront, the whole
+    /// string fits into a single chunk.
+    explicit StringBuilder(const int64 expectedSize = DEFAULT_FIRST_CHUNK_SIZE)
+        : mNextCapacity(max<int64>(expectedSize, 16)) {}
+
+    int64 size() const {
+        return mSize;
+    }
+    bool isEmpty() const {
+        return mSize == 0;
+    }
+    bool notEmpty() const {
+        return mSize != 0;
+    }
+
+    // =======================================================================================================
+    // Appending
+    // =======================================================================================================
+
+    StringBuilder& append(const StringView text) {
+        const char* data      = text.data();
+        int64       remaining = text.size();
+        while (remaining > 0) {
+            const int64 count = min(remaining, freeSpace(remaining));
+            Chunk&      chunk = mChunks.back();
+            std::memcpy(chunk.data.get() + chunk.size, data, count);
+            chunk.size += count;
+            mSize += count;
+            data += count;
+            remaining -= count;
+        }
+        return *this;
+    }
+
+    StringBuilder& append(const char c) {
+        freeSpace(1);
+        Chunk& chunk             = mChunks.back();
+        chunk.data[chunk.size++] = c;
+        ++mSize;
+        return *this;
+    }
+
+    StringBuilder& appendRepeated(const char c, const int64 count) {
+        BUFF_ASSERT(count >= 0);
+        for (int64 remaining = count; remaining > 0;) {
+            const int64 written = min(remaining, freeSpace(remaining));
+            Chunk&      chunk   = mChunks.back();
+            std::memset(chunk.data.get() + chunk.size, c, written);
+            chunk.size += written;
+            mSize += written;
+            remaining -= written;
+        }
+        return *this;
+    }
+
+    /// See formatNumber
+    template <Number T>
+    StringBuilder& appendFormatted(const T value) {
+        char buffer[MAX_FORMATTED_NUMBER_SIZE];
+        return append(StringView(buffer, formatNumber(buffer, value)));
+    }
+
+    StringBuilder& operator<<(const StringView text) {
+        return append(text);
+    }
+    StringBuilder& operator<<(const char c) {
+        return append(c);
+    }
+    template <Number T>
+    StringBuilder& operator<<(const T value) {
+        return appendFormatted(value);
+    }
+
+    // =======================================================================================================
+    // Output
+    // =======================================================================================================
+
+    /// The only place where the text is copied into one contiguous buffer
+    String toString() const;
+
+    /// Calls functor(StringView) for each chunk, in order. Use to write the text out without assembling it.
+    template <typename TFunctor>
+    void forEachChunk(TFunctor&& functor) const {
+        for (const Chunk& chunk : mChunks) {
+            functor(StringView(chunk.data.get(), int(chunk.size)));
+        }
+    }
+
+    /// Keeps the first chunk for reuse
+    void clear();
+
+private:
+    /// Makes sure the last chunk has free space, allocating a new chunk when it is full. Returns the free
+    /// space.
+    /// \param needed Hint of how much space is needed, a new chunk is made big enough to fit it at once
+    int64 freeSpace(const int64 needed) {
+        if (mChunks.isEmpty() || mChunks.back().size == mChunks.back().capacity) [[unlikely]] {
+            addChunk(needed);
+        }
+        return mChunks.back().capacity - mChunks.back().size;
+    }
+
+    void addChunk(int64 needed);
+};
+
+BUFF_NAMESPACE_END
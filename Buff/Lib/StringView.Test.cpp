@@ -69,4 +69,42 @@ static_assert(IsEqualsComparable<StringView>);
 static_assert(IsEqualsComparable<StringView, const char*>);
 static_assert(IsEqualsComparable<StringView, String>);
 
+template <typename TRange>
+static Array<StringView> collect(const TRange& range) {
+    Array<StringView> result;
+    for (const StringView item : range) {
+        result.pushBack(item);
+    }
+    return result;
+}
+
+TEST_CASE("StringView::split") {
+    static_assert(std::ranges::forward_range<decltype(StringView().split(","))>);
+    static_assert(std::ranges::view<decltype(StringView().split(","))>);
+    for (const StringView text : {"", "aA", "aa", "a a", "ein zwei drei ", "aDELIMITa", " x  y "}) {
+        CHECK(collect(text.split(" ")) == text.explode(" "));
+        CHECK(collect(text.split("a")) == text.explode("a"));
+    }
+    CHECK(collect(StringView("a,b;c,").splitByAnyOf(",;")) ==
+          Array {StringView("a"), StringView("b"), StringView("c"), StringView {}});
+
+    // Stops early, works with std::ranges
+    int count = 0;
+    for (const StringView item : StringView("1 2 3 4 5").split(" ") | std::views::take(2)) {
+        CHECK(item.size() == 1);
+        ++count;
+    }
+    CHECK(count == 2);
+}
+
+TEST_CASE("StringView::splitLines") {
+    CHECK(collect(StringView("").splitLines()).isEmpty());
+    CHECK(collect(StringView("a").splitLines()) == Array {StringView("a")});
+    CHECK(collect(StringView("a\n").splitLines()) == Array {StringView("a")});
+    CHECK(collect(StringView("\n").splitLines()) == Array {StringView {}});
+    CHECK(collect(StringView("a\r\nb\rc\n\nd").splitLines()) ==
+          Array {StringView("a"), StringView("b"), StringView("c"), StringView {}, StringView("d")});
+    CHECK(collect(StringView("a\r\n\r\n").splitLines()) == Array {StringView("a"), StringView {}});
+}
+
 BUFF_NAMESPACE_END
@@ -1,7 +1,7 @@
 #include "Lib/StringView.h"
 #include "Lib/Exception.h"
 #include "Lib/String.h"
-#include <utf8cpp/utf8/checked.h>
+#include "Lib/Utf8.h"
 
 BUFF_NAMESPACE_BEGIN
 
@@ -14,12 +14,17 @@ String StringView::getToUpper() const {
 }
 
 std::wstring StringView::asWString() const {
-    std::wstring result;
-    try {
-        utf8::utf8to16(mImpl.begin(), mImpl.end(), std::back_inserter(result));
-    } catch (...) {
+    if (!Utf8::isValid(data(), size())) {
         throw Exception("Invalid UTF-8 string");
     }
+    std::wstring result(size(), L'\0');
+    int64        length;
+    if constexpr (sizeof(wchar_t) == 2) {
+        length = Utf8::toUtf16(data(), size(), reinterpret_cast<char16_t*>(result.data()));
+    } else {
+        length = Utf8::toUtf32(data(), size(), reinterpret_cast<char32_t*>(result.data()));
+    }
+    result.resize(length);
     return result;
 }
 
@@ -1,12 +1,23 @@
 #pragma once
 #include "Lib/Bootstrap.h"
+#include "Lib/Hash.h"
 #include "Lib/Optional.h"
+#include "Lib/Simd.h"
 #include "Lib/Utils.h"
+#include <ranges>
 #include <string>
 
 BUFF_NAMESPACE_BEGIN
 
 class String;
+template <typename TFinder>
+class StringSplitRange;
+
+namespace Detail {
+struct SplitByDelimiter;
+struct SplitByAnyOf;
+struct SplitLines;
+}
 
 class StringView {
     friend class String;
@@ -124,6 +135,11 @@ public:
     }
 
     constexpr Optional<int> findFirstOf(const StringView listOfChars) const {
+        if (!std::is_constant_evaluated()) {
+            const int64 result =
+                Simd::findFirstOf(mImpl.data(), size(), listOfChars.mImpl.data(), listOfChars.size());
+            return result != size() ? Optional(int(result)) : NULL_OPTIONAL;
+        }
         const auto result = mImpl.find_first_of(listOfChars.mImpl);
         return result != std::string::npos ? Optional(int(result)) : NULL_OPTIONAL;
     }
@@ -139,6 +155,11 @@ public:
     constexpr Optional<int> find(const StringView pattern, const int startPos = 0) const {
         BUFF_ASSERT(startPos <= size());
         BUFF_ASSERT(pattern.notEmpty());
+        if (!std::is_constant_evaluated()) {
+            const int64 i = Simd::findSubstring(
+                mImpl.data() + startPos, size() - startPos, pattern.mImpl.data(), pattern.size());
+            return i != size() - startPos ? Optional(safeIntegerCast<int>(startPos + i)) : NULL_OPTIONAL;
+        }
         const size_t i = mImpl.find(pattern.mImpl, startPos);
         return i != std::string_view::npos ? Optional(safeIntegerCast<int>(i)) : NULL_OPTIONAL;
     }
@@ -153,8 +174,9 @@ public:
     // Misc
     // =======================================================================================================
 
-    size_t getHash() const {
-        return std::hash<std::string_view>()(mImpl);
+    /// Stable across platforms, see hashBytes
+    constexpr size_t getHash() const {
+        return size_t(hashBytes(mImpl.data(), size()));
     }
 
     [[nodiscard]] constexpr StringView getSubstring(const int           begin,
@@ -181,6 +203,17 @@ public:
     /// future.
     Array<StringView> explode(StringView delimiter) const;
 
+    /// Lazy version of explode, does not allocate. Items are produced while iterating, so stopping early skips
+    /// searching the rest of the string.
+    StringSplitRange<Detail::SplitByDelimiter> split(StringView delimiter) const;
+
+    /// Splits at every character present in chars. Includes empty strings same as split().
+    StringSplitRange<Detail::SplitByAnyOf> splitByAnyOf(StringView chars) const;
+
+    /// Lines separated by \n, \r\n or \r, without the line endings. Newline at the end of the text does not start
+    /// a new empty line and empty text has no lines.
+    StringSplitRange<Detail::SplitLines> splitLines() const;
+
 private:
     constexpr void assertValidity() const {
         for (auto& i : mImpl) {
@@ -193,4 +226,140 @@ inline StringView operator""_Sv(const char* utf8, const size_t size) {
     return StringView(utf8, int(size));
 }
 
+// ===========================================================================================================
+// Splitting
+// ===========================================================================================================
+
+namespace Detail {
+
+/// Position of a separator in the text, begin is -1 if there is none
+struct SplitSeparator {
+    int begin;
+    int end;
+};
+
+struct SplitByDelimiter {
+    StringView delimiter;
+
+    static constexpr bool SKIP_EMPTY_LAST = false;
+
+    SplitSeparator find(const StringView text, const int from) const {
+        if (const Optional<int> found = text.find(delimiter, from)) {
+            return {*found, *found + delimiter.size()};
+        }
+        return {-1, -1};
+    }
+};
+
+struct SplitByAnyOf {
+    StringView chars;
+
+    static constexpr bool SKIP_EMPTY_LAST = false;
+
+    SplitSeparator find(const StringView text, const int from) const {
+        const int found =
+            from + int(Simd::findFirstOf(text.data() + from, text.size() - from, chars.data(), chars.size()));
+        return found < text.size() ? SplitSeparator {found, found + 1} : SplitSeparator {-1, -1};
+    }
+};
+
+struct SplitLines {
+    static constexpr bool SKIP_EMPTY_LAST = true;
+
+    SplitSeparator find(const StringView text, const int from) const {
+        const int found = from + int(Simd::findFirstOf(text.data() + from, text.size() - from, "\r\n", 2));
+        if (found == text.size()) {
+            return {-1, -1};
+        }
+        const bool crlf = text[found] == '\r' && found + 1 < text.size() && text[found + 1] == '\n';
+        return {found, found + (crlf ? 2 : 1)};
+    }
+};
+
+} // namespace Detail
+
+/// Range of StringViews into the original text, produced lazily while iterating. Usable in range-for and as a
+/// std::ranges view. The text needs to outlive the range.
+template <typename TFinder>
+class StringSplitRange : public std::ranges::view_interface<StringSplitRange<TFinder>> {
+    StringView mText;
+    TFinder    mFinder;
+
+public:
+    class Iterator {
+        const StringSplitRange* mRange        = nullptr;
+        int                     mBegin        = -1; // -1 for end iterator
+        int                     mEnd          = -1; // End of the current item
+        int                     mSeparatorEnd = -1; // Start of the next item, -1 if this is the last one
+
+    public:
+        using iterator_concept  = std::forward_iterator_tag;
+        using iterator_category = std::input_iterator_tag; // Items are returned by value
+        using value_type        = StringView;
+        using difference_type   = std::ptrdiff_t;
+
+        Iterator() = default;
+        Iterator(const StringSplitRange* range, const int begin)
+            : mRange(range) {
+            moveTo(begin);
+        }
+
+        StringView operator*() const {
+            BUFF_ASSERT(mBegin != -1);
+            return mRange->mText.getSubstring(mBegin, mEnd - mBegin);
+        }
+        Iterator& operator++() {
+            BUFF_ASSERT(mBegin != -1);
+            moveTo(mSeparatorEnd);
+            return *this;
+        }
+        Iterator operator++(int) {
+            Iterator result = *this;
+            ++*this;
+            return result;
+        }
+        bool operator==(const Iterator& other) const {
+            return mBegin == other.mBegin;
+        }
+
+    private:
+        void moveTo(const int begin) {
+            const StringView text = mRange->mText;
+            if (begin == -1 || (TFinder::SKIP_EMPTY_LAST && begin == text.size())) {
+                mBegin = -1;
+                return;
+            }
+            mBegin                                 = begin;
+            const Detail::SplitSeparator separator = mRange->mFinder.find(text, begin);
+            mEnd                                   = separator.begin == -1 ? text.size() : separator.begin;
+            mSeparatorEnd                          = separator.begin == -1 ? -1 : separator.end;
+        }
+    };
+
+    StringSplitRange(const StringView text, TFinder finder)
+        : mText(text)
+        , mFinder(std::move(finder)) {}
+
+    Iterator begin() const {
+        return Iterator(this, 0);
+    }
+    Iterator end() const {
+        return Iterator();
+    }
+};
+
+inline StringSplitRange<Detail::SplitByDelimiter> StringView::split(const StringView delimiter) const {
+    BUFF_ASSERT(delimiter.notEmpty());
+    return {*this, Detail::SplitByDelimiter {delimiter}};
+}
+
+inline StringSplitRange<Detail::SplitByAnyOf> StringView::splitByAnyOf(const StringView chars) const {
+    BUFF_ASSERT(chars.notEmpty());
+    return {*this, Detail::SplitByAnyOf {chars}};
+}
+
+inline StringSplitRange<Detail::SplitLines> StringView::splitLines() const {
+    return {*this, Detail::SplitLines {}};
+}
+
 BUFF_NAMESPACE_END
@@ -0,0 +1,97 @@
+#include "Lib/Symbol.h"
+#include "Lib/Bootstrap.Test.h"
+#include "Lib/containers/HashMap.h"
+#include "Lib/containers/Map.h"
+#include "Lib/Thread.h"
+
+BUFF_NAMESPACE_BEGIN
+
+TEST_CASE("Symbol basics") {
+    const Symbol empty;
+    CHECK(empty.isEmpty());
+    CHECK(empty == Symbol(""));
+    CHECK(StringView(empty) == "");
+    CHECK(std::strlen(empty.asCString()) == 0);
+
+    const Symbol a("symbolTestA");
+    const Symbol b("symbolTestB");
+    CHECK(a != b);
+    CHECK(a == Symbol(String("symbolTestA")));
+    CHECK(a.asCString() == Symbol("symbolTestA").asCString());
+    CHECK(a == StringView("symbolTestA"));
+    CHECK(a.size() == 11);
+    CHECK(a < b);
+    CHECK(a.getHash() == StringView("symbolTestA").getHash());
+
+    // The symbol owns its copy of the string
+    String temporary = "symbolTestTemporary";
+    const Symbol fromTemporary(temporary);
+    temporary = "overwritten";
+    CHECK(StringView(fromTemporary) == "symbolTestTemporary");
+}
+
+TEST_CASE("Symbol::find") {
+    CHECK(!Symbol::find("symbolTestNeverInterned"));
+    const int64 sizeBefore = Symbol::getTableSize();
+    CHECK(!Symbol::find("symbolTestNeverInterned"));
+    CHECK(Symbol::getTableSize() == sizeBefore);
+
+    const Symbol interned("symbolTestFind");
+    const Optional<Symbol> found = Symbol::find("symbolTestFind");
+    REQUIRE(found);
+    CHECK(*found == interned);
+    CHECK(Symbol::find("") == Symbol());
+}
+
+TEST_CASE("Symbol::internAll") {
+    const Array<StringView> names = {"symbolTestBulk1", "symbolTestBulk2", "symbolTestBulk1"};
+    Symbol::internAll(names);
+    CHECK(Symbol::find("symbolTestBulk1"));
+    CHECK(Symbol::find("symbolTestBulk2"));
+    CHECK(*Symbol::find("symbolTestBulk1") == Symbol("symbolTestBulk1"));
+}
+
+TEST_CASE("Symbol containers") {
+    HashMap<Symbol, int> hashMap;
+    hashMap[Symbol("one")] = 1;
+    hashMap[Symbol("two")] = 2;
+    CHECK(hashMap[Symbol("one")] == 1);
+    CHECK(hashMap.size() == 2);
+
+    Map<Symbol, int> map;
+    map[Symbol("symbolTestZ")] = 0;
+    map[Symbol("symbolTestA")] = 0;
+    CHECK(map.begin()->first == Symbol("symbolTestA"));
+}
+
+TEST_CASE("Symbol serialization") {
+    const Symbol     symbol("symbolTestSerialized");
+    BinarySerializer serializer;
+    serializer.serialize(symbol, "symbol");
+    Symbol             deserialized;
+    BinaryDeserializer deserializer(serializer.getState());
+    deserializer.deserialize(deserialized, "symbol");
+    CHECK(deserialized == symbol);
+}
+
+TEST_CASE("Symbol threads") {
+    constexpr int THREADS = 4;
+    constexpr int NAMES   = 200;
+    Array<Array<Symbol>> results(THREADS);
+    {
+        Array<Thread> threads;
+        for (const int t : range(THREADS)) {
+            threads.pushBack(Thread([&results, t]() {
+                for (const int i : range(NAMES)) {
+                    results[t].pushBack(Symbol("symbolTestThread"_S + toStr(i)));
+                }
+            }));
+        }
+    }
+    for (const int t : range(1, THREADS)) {
+        CHECK(results[t] == results[0]);
+    }
+    CHECK(StringView(results[0][5]) == "symbolTestThread5");
+}
+
+BUFF_NAMESPACE_END
@@ -0,0 +1,78 @@
+#include "Lib/Symbol.h"
+#include "Lib/Arena.h"
+#include "Lib/containers/HashMap.h"
+#include <mutex>
+#include <shared_mutex>
+
+BUFF_NAMESPACE_BEGIN
+
+struct SymbolTable {
+    std::shared_mutex                               mutex;
+    Arena                                           arena;
+    HashMap<StringView, const Detail::SymbolEntry*> entries;
+
+    SymbolTable() {
+        const StringView empty(Detail::EMPTY_SYMBOL_ENTRY.data, 0);
+        entries.insert(empty, &Detail::EMPTY_SYMBOL_ENTRY);
+    }
+
+    const Detail::SymbolEntry* find(const CachedHash<StringView>& key) {
+        const std::shared_lock            lock(mutex);
+        const Detail::SymbolEntry* const* found = entries.findWithCached(key);
+        return found ? *found : nullptr;
+    }
+
+    /// Must be called with the exclusive lock held
+    const Detail::SymbolEntry* insert(const CachedHash<StringView>& key) {
+        if (const Detail::SymbolEntry* const* found = entries.findWithCached(key)) {
+            return *found; // Interned by another thread in the meantime
+        }
+        const StringView     copy  = arena.copyString(*key.key);
+        Detail::SymbolEntry* entry = arena.construct<Detail::SymbolEntry>(
+            Detail::SymbolEntry {copy.data(), copy.size(), uint64(key.getHash())});
+        entries.insert(copy, entry);
+        return entry;
+    }
+};
+
+/// Never destroyed, so that symbols stay valid in destructors of other static objects
+static SymbolTable& symbolTable() {
+    static SymbolTable* sTable = new SymbolTable;
+    return *sTable;
+}
+
+Symbol::Symbol(const StringView string) {
+    SymbolTable&                 table = symbolTable();
+    const CachedHash<StringView> key(string);
+    if (const Detail::SymbolEntry* found = table.find(key)) {
+        mEntry = found;
+        return;
+    }
+    const std::unique_lock lock(table.mutex);
+    mEntry = table.insert(key);
+}
+
+Optional<Symbol> Symbol::find(const StringView string) {
+    if (const Detail::SymbolEntry* found = symbolTable().find(CachedHash<StringView>(string))) {
+        Symbol result;
+        result.mEntry = found;
+        return result;
+    }
+    return NULL_OPTIONAL;
+}
+
+void Symbol::internAll(const ArrayView<const StringView> strings) {
+    SymbolTable&           table = symbolTable();
+    const std::unique_lock lock(table.mutex);
+    for (const StringView& string : strings) {
+        table.insert(CachedHash<StringView>(string));
+    }
+}
+
+int64 Symbol::getTableSize() {
+    SymbolTable&           table = symbolTable();
+    const std::shared_lock lock(table.mutex);
+    return table.entries.size();
+}
+
+BUFF_NAMESPACE_END
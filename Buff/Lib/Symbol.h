@@ -0,0 +1,98 @@
+#pragma once
+#include "Lib/Bootstrap.h"
+#include "Lib/containers/ArrayView.h"
+#include "Lib/Hash.h"
+#include "Lib/Optional.h"
+#include "Lib/Serialization.h"
+#include "Lib/String.h"
+#include "Lib/StringView.h"
+
+BUFF_NAMESPACE_BEGIN
+
+namespace Detail {
+/// Interned string, allocated once and never freed
+struct SymbolEntry {
+    const char* data;
+    int64       size;
+    uint64      hash;
+};
+inline constexpr SymbolEntry EMPTY_SYMBOL_ENTRY = {"", 0, hashBytes("", 0)};
+} // namespace Detail
+
+/// Handle to a string stored in the global, thread-safe symbol table. Each distinct string is stored only
+/// once, so comparing two symbols for equality is a single pointer comparison, and the hash is precomputed.
+/// Use for names which are compared and looked up over and over again (class names, identifiers, ...).
+///
+/// Interned strings are never freed, so do not intern strings from untrusted or unbounded input - use find()
+/// to look those up instead.
+class Symbol {
+    const Detail::SymbolEntry* mEntry = &Detail::EMPTY_SYMBOL_ENTRY;
+
+public:
+    /// Empty string
+    constexpr Symbol() = default;
+
+    /// Interns the string. Only takes a shared lock when the string is already in the table.
+    explicit Symbol(StringView string);
+
+    /// Existing symbol for the string, does not add it to the table
+    static Optional<Symbol> find(StringView string);
+
+    /// Interns all strings at once, e.g. all known names during startup, so that later lookups never need to
+    /// take the exclusive lock
+    static void internAll(ArrayView<const StringView> strings);
+
+    /// Number of distinct strings interned so far
+    static int64 getTableSize();
+
+    // ReSharper disable once CppNonExplicitConversionOperator
+    constexpr operator StringView() const {
+        return StringView(mEntry->data, int(mEntry->size));
+    }
+
+    /// Zero-terminated, valid for the lifetime of the program
+    constexpr const char* asCString() const {
+        return mEntry->data;
+    }
+
+    constexpr int64 size() const {
+        return mEntry->size;
+    }
+    constexpr bool isEmpty() const {
+        return mEntry->size == 0;
+    }
+    constexpr bool notEmpty() const {
+        return mEntry->size != 0;
+    }
+
+    constexpr bool operator==(const Symbol& other) const {
+        return mEntry == other.mEntry;
+    }
+    bool operator==(const StringView& other) const {
+        return StringView(*this) == other;
+    }
+
+    /// Orders alphabetically, so containers of symbols iterate in the same order in every run
+    std::strong_ordering operator<=>(const Symbol& other) const {
+        if (mEntry == other.mEntry) {
+            return std::strong_ordering::equal;
+        }
+        return StringView(*this) <=> StringView(other);
+    }
+
+    /// Same as the hash of the equivalent StringView
+    constexpr size_t getHash() const {
+        return size_t(mEntry->hash);
+    }
+
+    void serializeCustom(ISerializer& serializer) const {
+        serializer.serialize(String(StringView(*this)), "value");
+    }
+    void deserializeCustom(IDeserializer& deserializer) {
+        String value;
+        deserializer.deserialize(value, "value");
+        *this = Symbol(value);
+    }
+};
+
+BUFF_NAMESPACE_END
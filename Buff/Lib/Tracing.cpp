@@ -13,15 +13,18 @@ void Detail::HitCountTracer::dumpTo(std::ostream& stream) {
     if (sHits.isEmpty()) {
         return;
     }
-    auto result = Array<std::pair<Record, int64>>(sHits);
+    Array<std::pair<Record, int64>> result;
+    for (const auto& [record, count] : sHits) {
+        result.pushBack({record, count});
+    }
     std::ranges::sort(result, [](const auto& x, const auto& y) { return x.second > y.second; });
     const int64 maximum = result[0].second;
     // get number of digits in maximum:
     const int maxDigits = getNumDigits(uint64(maximum));
     stream << "Hit count tracer:" << std::endl;
     for (const auto& [record, count] : result) {
-        stream << std::setw(maxDigits) << count << " hit: " << record.function << "    (" << record.file
-               << "(" << record.line << "))\n";
+        stream << std::setw(maxDigits) << count << " hit: " << record.function.asCString() << "    ("
+               << record.file.asCString() << "(" << record.line << "))\n";
     }
 }
 
@@ -1,7 +1,8 @@
 #pragma once
-#include "Lib/containers/Map.h"
+#include "Lib/containers/HashMap.h"
 #include "Lib/String.h"
 #include "Lib/StringView.h"
+#include "Lib/Symbol.h"
 #include "Lib/Time.h"
 #include <iostream>
 
@@ -21,32 +22,28 @@ public:
 };
 
 class HitCountTracer {
+public:
     struct Record {
-        const char*          function;
-        const char*          file;
-        int                  line;
-        std::strong_ordering operator<=>(const Record& other) const {
-            const std::strong_ordering lineCmp = line <=> other.line;
-            // ReSharper disable once CppZeroConstantCanBeReplacedWithNullptr - false positive
-            if (lineCmp != 0) {
-                return lineCmp;
-            } else if (const int functionCmp = strcmp(function, other.function)) {
-                return functionCmp <=> 0;
-            } else {
-                return strcmp(file, other.file) <=> 0;
-            }
+        Symbol function;
+        Symbol file;
+        int    line;
+
+        bool   operator==(const Record& other) const = default;
+        size_t getHash() const {
+            return size_t(Hasher().add(function).add(file).add(line).get());
         }
     };
 
-    inline static Map<Record, int64> sHits;
+private:
+    inline static HashMap<Record, int64> sHits;
 
 public:
-    static void record(const char* function, const char* filename, const int line) {
-        const Record record {function, filename, line};
+    /// Symbols of the call site are created only once, see BUFF_TRACE_NUM_HITS
+    static void record(const Record& record) {
         if (int64* found = sHits.find(record)) {
             ++*found;
         } else {
-            sHits[record] = 1;
+            sHits.insert(record, 1);
         }
     }
     static void dumpTo(std::ostream& stream);
@@ -55,6 +52,11 @@ public:
 } // namespace Detail
 
 #define BUFF_TRACE_DURATION(msg) Detail::TraceWithTimer traceDurationTimer_(msg)
-#define BUFF_TRACE_NUM_HITS()    Detail::HitCountTracer::record(__FUNCTION__, __FILE__, __LINE__)
+#define BUFF_TRACE_NUM_HITS()                                                                                \
+    do {                                                                                                     \
+        static const Detail::HitCountTracer::Record traceRecord_ {                                           \
+            Symbol(__FUNCTION__), Symbol(__FILE__), __LINE__};                                               \
+        Detail::HitCountTracer::record(traceRecord_);                                                        \
+    } while (false)
 
 BUFF_NAMESPACE_END
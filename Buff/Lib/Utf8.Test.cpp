@@ -0,0 +1,197 @@
+#include "Lib/Utf8.h"
+#include "Lib/Bootstrap.Test.h"
+#include "Lib/Random.h"
+#include "Lib/String.h"
+#include "Lib/Time.h"
+#include <iostream>
+
+BUFF_NAMESPACE_BEGIN
+
+/// Straightforward decoder to compare the block-based validator against
+static bool isValidReference(const std::string& text) {
+    const auto* data = reinterpret_cast<const uint8*>(text.data());
+    const int64 size = int64(text.size());
+    for (int64 i = 0; i < size;) {
+        const uint8 lead = data[i];
+        int         length;
+        uint        codePoint;
+        if (lead < 0x80) {
+            length    = 1;
+            codePoint = lead;
+        } else if ((lead & 0xE0) == 0xC0) {
+            length    = 2;
+            codePoint = lead & 0x1F;
+        } else if ((lead & 0xF0) == 0xE0) {
+            length    = 3;
+            codePoint = lead & 0x0F;
+        } else if ((lead & 0xF8) == 0xF0) {
+            length    = 4;
+            codePoint = lead & 0x07;
+        } else {
+            return false;
+        }
+        if (i + length > size) {
+            return false;
+        }
+        for (int j = 1; j < length; ++j) {
+            if ((data[i + j] & 0xC0) != 0x80) {
+                return false;
+            }
+            codePoint = codePoint << 6 | (data[i + j] & 0x3F);
+        }
+        static constexpr uint MIN_CODE_POINT[] = {0, 0, 0x80, 0x800, 0x10000};
+        if (codePoint < MIN_CODE_POINT[length] || codePoint > 0x10FFFF ||
+            (codePoint >= 0xD800 && codePoint <= 0xDFFF)) {
+            return false;
+        }
+        i += length;
+    }
+    return true;
+}
+
+static bool isValid(const std::string& text) {
+    return Utf8::isValid(text.data(), int64(text.size()));
+}
+
+TEST_CASE("Utf8::isValid") {
+    CHECK(isValid(""));
+    CHECK(isValid("hello"));
+    CHECK(isValid("P\xC5\x99\xC3\xAD\xC5\xA1" "ern\xC4\x9B \xE2\x82\xAC \xF0\x9F\x98\x80"));
+    CHECK(isValid("\xF4\x8F\xBF\xBF"));     // U+10FFFF
+    CHECK(isValid("\xED\x9F\xBF"));         // U+D7FF
+    CHECK(!isValid("\x80"));                // Lone continuation
+    CHECK(!isValid("\xC0\xAF"));            // Overlong
+    CHECK(!isValid("\xC1\xBF"));            // Overlong
+    CHECK(!isValid("\xE0\x9F\xBF"));        // Overlong
+    CHECK(!isValid("\xF0\x8F\xBF\xBF"));    // Overlong
+    CHECK(!isValid("\xED\xA0\x80"));        // Surrogate
+    CHECK(!isValid("\xF4\x90\x80\x80"));    // Above U+10FFFF
+    CHECK(!isValid("\xF5\x80\x80\x80"));    // Above U+10FFFF
+    CHECK(!isValid("\xFF"));                // Never valid
+    CHECK(!isValid("\xE2\x82"));            // Truncated
+    CHECK(!isValid("\xC3\xA9\xA9"));        // Too many continuations
+    CHECK(!isValid("\xF0\x9F\x98\x80\x80")); // Too many continuations
+
+    // Sequences crossing and truncated at every block boundary
+    for (const int prefix : range(70)) {
+        const std::string ascii(prefix, 'a');
+        CHECK(isValid(ascii + "\xF0\x9F\x98\x80" + ascii));
+        CHECK(isValid(ascii + "\xE2\x82\xAC"));
+        CHECK(!isValid(ascii + "\xF0\x9F\x98"));
+        CHECK(!isValid(ascii + "\xF0\x9F\x98" + ascii));
+        CHECK(!isValid(ascii + "\xE2" + ascii));
+        CHECK(!isValid(ascii + "\xED\xA0\x80" + ascii));
+    }
+}
+
+TEST_CASE("Utf8::isValid random") {
+    // Bytes around all the boundaries of the encoding
+    static constexpr uint8 INTERESTING[] = {'a',  0x7F, 0x80, 0x8F, 0x90, 0x9F, 0xA0, 0xBF, 0xC0, 0xC1, 0xC2,
+                                            0xDF, 0xE0, 0xE1, 0xED, 0xEE, 0xEF, 0xF0, 0xF1, 0xF4, 0xF5, 0xFF};
+    RandomNumberGenerator rng;
+    int                   numValid = 0;
+    for ([[maybe_unused]] const int iteration : range(20'000)) {
+        std::string text;
+        const int   size = rng.getRandomInt(100);
+        for ([[maybe_unused]] const int i : range(size)) {
+            const int choice = rng.getRandomInt(9);
+            if (choice < 3) {
+                text += char(rng.getRandomInt(0x7F));
+            } else if (choice < 6) {
+                text += char(INTERESTING[rng.getRandomInt(int(std::size(INTERESTING)) - 1)]);
+            } else {
+                // Mostly valid code point, so that long valid sequences are generated too
+                char32_t   codePoint = char32_t(rng.getRandomInt(0x10FFFF));
+                char       buffer[4];
+                const auto length = Utf8::fromUtf32(&codePoint, 1, buffer);
+                if (length) {
+                    text.append(buffer, *length);
+                }
+            }
+        }
+        const bool expected = isValidReference(text);
+        CHECK(isValid(text) == expected);
+        numValid += expected;
+    }
+    // Both outcomes were tested
+    CHECK(numValid > 100);
+    CHECK(numValid < 19'900);
+}
+
+TEST_CASE("Utf8::findNonAscii") {
+    CHECK(Utf8::findNonAscii("", 0) == 0);
+    CHECK(Utf8::isAscii("hello", 5));
+    for (const int position : range(70)) {
+        std::string text(80, 'x');
+        text[position] = char(0xC3);
+        CHECK(Utf8::findNonAscii(text.data(), int64(text.size())) == position);
+        CHECK(!Utf8::isAscii(text.data(), int64(text.size())));
+    }
+}
+
+TEST_CASE("Utf8 transcoding") {
+    const std::string texts[] = {
+        "",
+        "hello",
+        "P\xC5\x99\xC3\xAD\xC5\xA1" "ern\xC4\x9B \xE2\x82\xAC \xF0\x9F\x98\x80",
+        std::string(40, 'a') + "\xF0\x9F\x98\x80" + std::string(40, 'b') + "\xC3\xA9",
+        "\xF4\x8F\xBF\xBF\xEF\xBF\xBF\xC2\x80\x7F",
+    };
+    for (const std::string& text : texts) {
+        const int64 size = int64(text.size());
+
+        std::u16string utf16(size, u'\0');
+        utf16.resize(Utf8::toUtf16(text.data(), size, utf16.data()));
+        std::string back(3 * utf16.size(), '\0');
+        back.resize(*Utf8::fromUtf16(utf16.data(), int64(utf16.size()), back.data()));
+        CHECK(back == text);
+
+        std::u32string utf32(size, U'\0');
+        utf32.resize(Utf8::toUtf32(text.data(), size, utf32.data()));
+        back.assign(4 * utf32.size(), '\0');
+        back.resize(*Utf8::fromUtf32(utf32.data(), int64(utf32.size()), back.data()));
+        CHECK(back == text);
+    }
+
+    std::u16string utf16(40, u'a');
+    utf16 += u"\U0001F600é";
+    std::u32string utf32(40, U'a');
+    utf32 += U"\U0001F600é";
+    char buffer[256];
+    CHECK(Utf8::fromUtf16(utf16.data(), int64(utf16.size()), buffer) == 46);
+    CHECK(Utf8::fromUtf32(utf32.data(), int64(utf32.size()), buffer) == 46);
+    CHECK(std::string(buffer + 40, 6) == "\xF0\x9F\x98\x80\xC3\xA9");
+
+    const char16_t unpairedHigh[] = {u'a', 0xD83D, u'b'};
+    const char16_t unpairedLow[]  = {0xDE00};
+    CHECK(!Utf8::fromUtf16(unpairedHigh, 3, buffer));
+    CHECK(!Utf8::fromUtf16(unpairedHigh, 2, buffer));
+    CHECK(!Utf8::fromUtf16(unpairedLow, 1, buffer));
+    const char32_t surrogate[] = {0xD800};
+    const char32_t tooLarge[]  = {0x110000};
+    CHECK(!Utf8::fromUtf32(surrogate, 1, buffer));
+    CHECK(!Utf8::fromUtf32(tooLarge, 1, buffer));
+}
+
+TEST_CASE("String wstring conversion") {
+    const String text = "P\xC5\x99\xC3\xAD\xC5\xA1" "ern\xC4\x9B \xF0\x9F\x98\x80";
+    CHECK(text.asWString() == L"Příšerně \U0001F600");
+    CHECK(String(text.asWString()) == text);
+    CHECK(String(std::wstring(L"")) == "");
+    CHECK_THROWS(StringView("\xC0\xAF").asWString());
+}
+
+TEST_CASE("Utf8::isValid benchmark" * doctest::skip()) {
+    std::string text;
+    while (text.size() < 100'000'000) {
+        text += "Lorem ipsum dolor sit amet, P\xC5\x99\xC3\xAD\xC5\xA1"
+                "ern\xC4\x9B \xE2\x82\xAC \xF0\x9F\x98\x80 ";
+    }
+    Timer      timer;
+    const bool valid = isValid(text);
+    std::cout << "Validating " << text.size() << " bytes took " << timer.getElapsed().getUserReadable()
+              << std::endl;
+    CHECK(valid);
+}
+
+BUFF_NAMESPACE_END
@@ -0,0 +1,533 @@
+#include "Lib/Utf8.h"
+#include "Lib/Simd.h"
+#if !BUFF_SIMD_AVX2 && defined(__SSSE3__)
+#    define BUFF_UTF8_SSSE3 1
+#    include <tmmintrin.h>
+#endif
+
+BUFF_NAMESPACE_BEGIN
+
+namespace Utf8 {
+
+// ===========================================================================================================
+// Validation
+// ===========================================================================================================
+
+// Each pair of consecutive bytes is classified by the high nibble of the first byte, the low nibble of the
+// first byte and the high nibble of the second byte. Each of the three table lookups returns the set of
+// errors the pair could have, and the pair is invalid when all three agree on some error.
+static constexpr uint8 TOO_SHORT      = 1 << 0; // 11______ 0_______ or 11______ 11______
+static constexpr uint8 TOO_LONG       = 1 << 1; // 0_______ 10______
+static constexpr uint8 OVERLONG_3     = 1 << 2; // 11100000 100_____
+static constexpr uint8 TOO_LARGE      = 1 << 3; // 11110100 1001____ and above
+static constexpr uint8 SURROGATE      = 1 << 4; // 11101101 101_____
+static constexpr uint8 OVERLONG_2     = 1 << 5; // 1100000_ 10______
+static constexpr uint8 TOO_LARGE_1000 = 1 << 6; // 11110101 1000____ and above
+static constexpr uint8 OVERLONG_4     = 1 << 6; // 11110000 1000____
+static constexpr uint8 TWO_CONTS      = 1 << 7; // 10______ 10______, unless in a 3 or 4 byte sequence
+static constexpr uint8 CARRY          = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+alignas(16) static constexpr uint8 BYTE_1_HIGH[16] = {
+    // 0_______ ________ (ASCII)
+    TOO_LONG,
+    TOO_LONG,
+    TOO_LONG,
+    TOO_LONG,
+    TOO_LONG,
+    TOO_LONG,
+    TOO_LONG,
+    TOO_LONG,
+    // 10______ ________ (continuation)
+    TWO_CONTS,
+    TWO_CONTS,
+    TWO_CONTS,
+    TWO_CONTS,
+    // 1100____ ________ (2 byte lead)
+    TOO_SHORT | OVERLONG_2,
+    // 1101____ ________ (2 byte lead)
+    TOO_SHORT,
+    // 1110____ ________ (3 byte lead)
+    TOO_SHORT | OVERLONG_3 | SURROGATE,
+    // 1111____ ________ (4 byte lead)
+    TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4,
+};
+
+alignas(16) static constexpr uint8 BYTE_1_LOW[16] = {
+    CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4, // ____0000 ________
+    CARRY | OVERLONG_2,                           // ____0001 ________
+    CARRY,                                        // ____001_ ________
+    CARRY,
+    CARRY | TOO_LARGE,                  // ____0100 ________
+    CARRY | TOO_LARGE | TOO_LARGE_1000, // ____0101 ________
+    CARRY | TOO_LARGE | TOO_LARGE_1000, // ____011_ ________
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000, // ____1___ ________
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE, // ____1101 ________
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+};
+
+alignas(16) static constexpr uint8 BYTE_2_HIGH[16] = {
+    // ________ 0_______ (ASCII)
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+    // ________ 1000____
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+    // ________ 1001____
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+    // ________ 101_____
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+    // ________ 11______
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+    TOO_SHORT,
+};
+
+/// A block ending with bytes above these values ends inside a multibyte sequence
+alignas(32) static constexpr uint8 INCOMPLETE_MAX[32] = {
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1,
+};
+
+#if BUFF_SIMD_AVX2
+struct Vector {
+    using Type                = __m256i;
+    static constexpr int SIZE = 32;
+
+    static Type load(const void* ptr) {
+        return _mm256_loadu_si256(static_cast<const __m256i*>(ptr));
+    }
+    static Type table(const uint8* values) {
+        return _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(values)));
+    }
+    static Type broadcast(const uint8 value) {
+        return _mm256_set1_epi8(char(value));
+    }
+    static Type zero() {
+        return _mm256_setzero_si256();
+    }
+    /// indices need to be in range [0, 16)
+    static Type lookup(const Type table, const Type indices) {
+        return _mm256_shuffle_epi8(table, indices);
+    }
+    static Type highNibbles(const Type value) {
+        return _mm256_and_si256(_mm256_srli_epi16(value, 4), broadcast(0x0F));
+    }
+    static Type lowNibbles(const Type value) {
+        return _mm256_and_si256(value, broadcast(0x0F));
+    }
+    /// Input shifted by N bytes, with the last N bytes of previous shifted in
+    template <int N>
+    static Type previous(const Type input, const Type previous) {
+        return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(previous, input, 0x21), 16 - N);
+    }
+    static Type subtractSaturated(const Type a, const Type b) {
+        return _mm256_subs_epu8(a, b);
+    }
+    static Type bitAnd(const Type a, const Type b) {
+        return _mm256_and_si256(a, b);
+    }
+    static Type bitOr(const Type a, const Type b) {
+        return _mm256_or_si256(a, b);
+    }
+    static Type bitXor(const Type a, const Type b) {
+        return _mm256_xor_si256(a, b);
+    }
+    static bool anyNonZero(const Type value) {
+        return !_mm256_testz_si256(value, value);
+    }
+    static bool anyHighBit(const Type value) {
+        return _mm256_movemask_epi8(value) != 0;
+    }
+};
+#elif BUFF_UTF8_SSSE3
+struct Vector {
+    using Type                = __m128i;
+    static constexpr int SIZE = 16;
+
+    static Type load(const void* ptr) {
+        return _mm_loadu_si128(static_cast<const __m128i*>(ptr));
+    }
+    static Type table(const uint8* values) {
+        return _mm_load_si128(reinterpret_cast<const __m128i*>(values));
+    }
+    static Type broadcast(const uint8 value) {
+        return _mm_set1_epi8(char(value));
+    }
+    static Type zero() {
+        return _mm_setzero_si128();
+    }
+    static Type lookup(const Type table, const Type indices) {
+        return _mm_shuffle_epi8(table, indices);
+    }
+    static Type highNibbles(const Type value) {
+        return _mm_and_si128(_mm_srli_epi16(value, 4), broadcast(0x0F));
+    }
+    static Type lowNibbles(const Type value) {
+        return _mm_and_si128(value, broadcast(0x0F));
+    }
+    template <int N>
+    static Type previous(const Type input, const Type previous) {
+        return _mm_alignr_epi8(input, previous, 16 - N);
+    }
+    static Type subtractSaturated(const Type a, const Type b) {
+        return _mm_subs_epu8(a, b);
+    }
+    static Type bitAnd(const Type a, const Type b) {
+        return _mm_and_si128(a, b);
+    }
+    static Type bitOr(const Type a, const Type b) {
+        return _mm_or_si128(a, b);
+    }
+    static Type bitXor(const Type a, const Type b) {
+        return _mm_xor_si128(a, b);
+    }
+    static bool anyNonZero(const Type value) {
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(value, zero())) != 0xFFFF;
+    }
+    static bool anyHighBit(const Type value) {
+        return _mm_movemask_epi8(value) != 0;
+    }
+};
+#elif BUFF_SIMD_NEON
+struct Vector {
+    using Type                = uint8x16_t;
+    static constexpr int SIZE = 16;
+
+    static Type load(const void* ptr) {
+        return vld1q_u8(static_cast<const uint8_t*>(ptr));
+    }
+    static Type table(const uint8* values) {
+        return vld1q_u8(values);
+    }
+    static Type broadcast(const uint8 value) {
+        return vdupq_n_u8(value);
+    }
+    static Type zero() {
+        return vdupq_n_u8(0);
+    }
+    static Type lookup(const Type table, const Type indices) {
+        return vqtbl1q_u8(table, indices);
+    }
+    static Type highNibbles(const Type value) {
+        return vshrq_n_u8(value, 4);
+    }
+    static Type lowNibbles(const Type value) {
+        return vandq_u8(value, broadcast(0x0F));
+    }
+    template <int N>
+    static Type previous(const Type input, const Type previous) {
+        return vextq_u8(previous, input, 16 - N);
+    }
+    static Type subtractSaturated(const Type a, const Type b) {
+        return vqsubq_u8(a, b);
+    }
+    static Type bitAnd(const Type a, const Type b) {
+        return vandq_u8(a, b);
+    }
+    static Type bitOr(const Type a, const Type b) {
+        return vorrq_u8(a, b);
+    }
+    static Type bitXor(const Type a, const Type b) {
+        return veorq_u8(a, b);
+    }
+    static bool anyNonZero(const Type value) {
+        return vmaxvq_u8(value) != 0;
+    }
+    static bool anyHighBit(const Type value) {
+        return vmaxvq_u8(value) >= 0x80;
+    }
+};
+#endif
+
+#if BUFF_SIMD_AVX2 || BUFF_UTF8_SSSE3 || BUFF_SIMD_NEON
+#    define BUFF_UTF8_VECTOR 1
+
+static bool isValidVector(const char* data, const int64 size) {
+    using V = Vector::Type;
+    const V byte1High     = Vector::table(BYTE_1_HIGH);
+    const V byte1Low      = Vector::table(BYTE_1_LOW);
+    const V byte2High     = Vector::table(BYTE_2_HIGH);
+    const V incompleteMax = Vector::load(INCOMPLETE_MAX + 32 - Vector::SIZE);
+
+    V error              = Vector::zero();
+    V previous           = Vector::zero();
+    V previousIncomplete = Vector::zero();
+
+    auto processBlock = [&](const V input) {
+        if (!Vector::anyHighBit(input)) {
+            // Only a sequence left unfinished by the previous block can make an ASCII block invalid
+            error              = Vector::bitOr(error, previousIncomplete);
+            previousIncomplete = Vector::zero();
+        } else {
+            const V prev1        = Vector::previous<1>(input, previous);
+            const V specialCases = Vector::bitAnd(
+                Vector::bitAnd(Vector::lookup(byte1High, Vector::highNibbles(prev1)),
+                               Vector::lookup(byte1Low, Vector::lowNibbles(prev1))),
+                Vector::lookup(byte2High, Vector::highNibbles(input)));
+
+            // Continuations 2 and 3 bytes after a 3 or 4 byte lead are expected, which flips their TWO_CONTS
+            const V isThirdByte  = Vector::subtractSaturated(Vector::previous<2>(input, previous),
+                                                            Vector::broadcast(0xE0 - 0x80));
+            const V isFourthByte = Vector::subtractSaturated(Vector::previous<3>(input, previous),
+                                                             Vector::broadcast(0xF0 - 0x80));
+            const V expectedContinuation =
+                Vector::bitAnd(Vector::bitOr(isThirdByte, isFourthByte), Vector::broadcast(0x80));
+
+            error              = Vector::bitOr(error, Vector::bitXor(expectedContinuation, specialCases));
+            previousIncomplete = Vector::subtractSaturated(input, incompleteMax);
+        }
+        previous = input;
+    };
+
+    int64 i = 0;
+    for (; i + Vector::SIZE <= size; i += Vector::SIZE) {
+        processBlock(Vector::load(data + i));
+    }
+    if (i < size) {
+        // Padded with zeros, which are ASCII
+        alignas(32) char tail[Vector::SIZE] = {};
+        std::memcpy(tail, data + i, size - i);
+        processBlock(Vector::load(tail));
+    }
+    return !Vector::anyNonZero(Vector::bitOr(error, previousIncomplete));
+}
+#endif
+
+/// Well-formed byte sequences as listed in table 3-7 of the Unicode standard
+static bool isValidScalar(const uint8* data, const int64 size) {
+    int64 i = 0;
+    while (i < size) {
+        if (i + 8 <= size) {
+            uint64 word;
+            std::memcpy(&word, data + i, 8);
+            if ((word & 0x8080808080808080ull) == 0) {
+                i += 8;
+                continue;
+            }
+        }
+        const uint8 lead = data[i];
+        if (lead < 0x80) {
+            ++i;
+            continue;
+        }
+        int   length;
+        uint8 secondMin = 0x80;
+        uint8 secondMax = 0xBF;
+        if (lead >= 0xC2 && lead <= 0xDF) {
+            length = 2;
+        } else if (lead >= 0xE0 && lead <= 0xEF) {
+            length    = 3;
+            secondMin = lead == 0xE0 ? 0xA0 : 0x80;
+            secondMax = lead == 0xED ? 0x9F : 0xBF;
+        } else if (lead >= 0xF0 && lead <= 0xF4) {
+            length    = 4;
+            secondMin = lead == 0xF0 ? 0x90 : 0x80;
+            secondMax = lead == 0xF4 ? 0x8F : 0xBF;
+        } else {
+            return false;
+        }
+        if (i + length > size || data[i + 1] < secondMin || data[i + 1] > secondMax) {
+            return false;
+        }
+        for (int j = 2; j < length; ++j) {
+            if ((data[i + j] & 0xC0) != 0x80) {
+                return false;
+            }
+        }
+        i += length;
+    }
+    return true;
+}
+
+int64 findNonAscii(const char* data, const int64 size) {
+    int64 i = 0;
+    for (; i + Simd::Block::SIZE <= size; i += Simd::Block::SIZE) {
+        if (const uint mask = Simd::Block::load(data + i).highBitMask()) {
+            return i + Simd::lowestBit(mask);
+        }
+    }
+    for (; i < size; ++i) {
+        if (uint8(data[i]) >= 0x80) {
+            return i;
+        }
+    }
+    return size;
+}
+
+bool isValid(const char* data, const int64 size) {
+#if BUFF_UTF8_VECTOR
+    return isValidVector(data, size);
+#else
+    return isValidScalar(reinterpret_cast<const uint8*>(data), size);
+#endif
+}
+
+// ===========================================================================================================
+// Transcoding
+// ===========================================================================================================
+
+/// Decodes a single code point from valid UTF-8
+static char32_t decode(const uint8* data, int& length) {
+    const uint8 lead = data[0];
+    if (lead < 0x80) {
+        length = 1;
+        return lead;
+    } else if (lead < 0xE0) {
+        length = 2;
+        return char32_t((lead & 0x1F) << 6 | (data[1] & 0x3F));
+    } else if (lead < 0xF0) {
+        length = 3;
+        return char32_t((lead & 0x0F) << 12 | (data[1] & 0x3F) << 6 | (data[2] & 0x3F));
+    } else {
+        length = 4;
+        return char32_t((lead & 0x07) << 18 | (data[1] & 0x3F) << 12 | (data[2] & 0x3F) << 6 |
+                        (data[3] & 0x3F));
+    }
+}
+
+static char* encode(const char32_t codePoint, char* output) {
+    if (codePoint < 0x80) {
+        *output++ = char(codePoint);
+    } else if (codePoint < 0x800) {
+        *output++ = char(0xC0 | (codePoint >> 6));
+        *output++ = char(0x80 | (codePoint & 0x3F));
+    } else if (codePoint < 0x10000) {
+        *output++ = char(0xE0 | (codePoint >> 12));
+        *output++ = char(0x80 | ((codePoint >> 6) & 0x3F));
+        *output++ = char(0x80 | (codePoint & 0x3F));
+    } else {
+        *output++ = char(0xF0 | (codePoint >> 18));
+        *output++ = char(0x80 | ((codePoint >> 12) & 0x3F));
+        *output++ = char(0x80 | ((codePoint >> 6) & 0x3F));
+        *output++ = char(0x80 | (codePoint & 0x3F));
+    }
+    return output;
+}
+
+/// Shared by toUtf16 and toUtf32: blocks of ASCII are widened at once, other code points are decoded one by
+/// one
+template <typename TUnit, typename TWriteCodePoint>
+static int64 decodeAll(const char* data, const int64 size, TUnit* output, TWriteCodePoint&& writeCodePoint) {
+    constexpr int BLOCK = Simd::Block::SIZE;
+    const uint8*  input = reinterpret_cast<const uint8*>(data);
+    TUnit*        out   = output;
+    int64         i     = 0;
+    while (i < size) {
+        if (i + BLOCK <= size) {
+            const uint mask  = Simd::Block::load(input + i).highBitMask();
+            const int  ascii = mask ? Simd::lowestBit(mask) : BLOCK;
+            if (ascii == BLOCK) {
+                for (int j = 0; j < BLOCK; ++j) {
+                    out[j] = TUnit(input[i + j]);
+                }
+                out += BLOCK;
+                i += BLOCK;
+                continue;
+            }
+            for (int j = 0; j < ascii; ++j) {
+                out[j] = TUnit(input[i + j]);
+            }
+            out += ascii;
+            i += ascii;
+        }
+        int            length;
+        const char32_t codePoint = decode(input + i, length);
+        out                      = writeCodePoint(codePoint, out);
+        i += length;
+    }
+    return out - output;
+}
+
+int64 toUtf16(const char* data, const int64 size, char16_t* output) {
+    return decodeAll(data, size, output, [](const char32_t codePoint, char16_t* out) {
+        if (codePoint < 0x10000) {
+            *out++ = char16_t(codePoint);
+        } else {
+            const char32_t offset = codePoint - 0x10000;
+            *out++                = char16_t(0xD800 + (offset >> 10));
+            *out++                = char16_t(0xDC00 + (offset & 0x3FF));
+        }
+        return out;
+    });
+}
+
+int64 toUtf32(const char* data, const int64 size, char32_t* output) {
+    return decodeAll(data, size, output, [](const char32_t codePoint, char32_t* out) {
+        *out++ = codePoint;
+        return out;
+    });
+}
+
+/// Shared by fromUtf16 and fromUtf32: blocks of ASCII are narrowed at once, readCodePoint reads the others
+template <typename TUnit, typename TReadCodePoint>
+static Optional<int64> encodeAll(const TUnit*     data,
+                                 const int64      size,
+                                 char*            output,
+                                 TReadCodePoint&& readCodePoint) {
+    constexpr int BLOCK = 16;
+    char*         out   = output;
+    int64         i     = 0;
+    while (i < size) {
+        if (i + BLOCK <= size) {
+            TUnit combined = 0;
+            for (int j = 0; j < BLOCK; ++j) {
+                combined |= data[i + j];
+            }
+            if (combined < 0x80) {
+                for (int j = 0; j < BLOCK; ++j) {
+                    out[j] = char(data[i + j]);
+                }
+                out += BLOCK;
+                i += BLOCK;
+                continue;
+            }
+        }
+        const Optional<char32_t> codePoint = readCodePoint(i);
+        if (!codePoint) {
+            return NULL_OPTIONAL;
+        }
+        out = encode(*codePoint, out);
+    }
+    return out - output;
+}
+
+Optional<int64> fromUtf16(const char16_t* data, const int64 size, char* output) {
+    return encodeAll(data, size, output, [&](int64& i) -> Optional<char32_t> {
+        const char16_t unit = data[i++];
+        if (unit < 0xD800 || unit > 0xDFFF) {
+            return char32_t(unit);
+        }
+        if (unit > 0xDBFF || i == size || data[i] < 0xDC00 || data[i] > 0xDFFF) {
+            return NULL_OPTIONAL; // Unpaired surrogate
+        }
+        const char16_t low = data[i++];
+        return char32_t(0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00));
+    });
+}
+
+Optional<int64> fromUtf32(const char32_t* data, const int64 size, char* output) {
+    return encodeAll(data, size, output, [&](int64& i) -> Optional<char32_t> {
+        const char32_t codePoint = data[i++];
+        if ((codePoint >= 0xD800 && codePoint <= 0xDFFF) || codePoint > 0x10FFFF) {
+            return NULL_OPTIONAL;
+        }
+        return codePoint;
+    });
+}
+
+} // namespace Utf8
+
+BUFF_NAMESPACE_END
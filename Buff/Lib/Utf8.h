@@ -0,0 +1,44 @@
+#pragma once
+#include "Lib/Bootstrap.h"
+#include "Lib/Optional.h"
+
+BUFF_NAMESPACE_BEGIN
+
+/// UTF-8 validation and conversion to and from UTF-16 and UTF-32.
+///
+/// Validation checks whole blocks of bytes at once with the lookup table algorithm from Keiser & Lemire,
+/// "Validating UTF-8 In Less Than One Instruction Per Byte" (AVX2, SSSE3 or NEON, plain code otherwise). Runs
+/// of ASCII are skipped, or widened and narrowed, a block at a time.
+namespace Utf8 {
+
+/// Index of the first byte which is not ASCII, or size if there is none
+int64 findNonAscii(const char* data, int64 size);
+
+inline bool isAscii(const char* data, const int64 size) {
+    return findNonAscii(data, size) == size;
+}
+
+/// Rejects overlong encodings, surrogates, code points above U+10FFFF and truncated sequences
+bool isValid(const char* data, int64 size);
+
+/// Converts valid UTF-8, code points outside the Basic Multilingual Plane become surrogate pairs
+/// \param output Needs space for size code units
+/// \return Number of code units written
+int64 toUtf16(const char* data, int64 size, char16_t* output);
+
+/// Converts valid UTF-8
+/// \param output Needs space for size code points
+/// \return Number of code points written
+int64 toUtf32(const char* data, int64 size, char32_t* output);
+
+/// \param output Needs space for 3 * size bytes
+/// \return Number of bytes written, NULL_OPTIONAL if the input contains an unpaired surrogate
+Optional<int64> fromUtf16(const char16_t* data, int64 size, char* output);
+
+/// \param output Needs space for 4 * size bytes
+/// \return Number of bytes written, NULL_OPTIONAL if the input contains a surrogate or a value above U+10FFFF
+Optional<int64> fromUtf32(const char32_t* data, int64 size, char* output);
+
+} // namespace Utf8
+
+BUFF_NAMESPACE_END
@@ -6,8 +6,10 @@
 
 BUFF_NAMESPACE_BEGIN
 
+/// Serializes the components in order, so a derived class holding only the float components is bitwise
+/// serializable
 template <typename TActualClass, int TDimension>
-class Vector {
+class Vector : public BitwiseSerialization {
 
     template <typename TVector>
     struct Iterator {
@@ -5,14 +5,17 @@
 #include "Lib/containers/Iterator.h"
 #include "Lib/Optional.h"
 #include "Lib/Serialization.h"
+#include "Lib/Simd.h"
 #include "Lib/Utils.h"
 #include <vector>
 
 BUFF_NAMESPACE_BEGIN
 
-template <NonConst T>
+/// \param TAllocator Standard library compatible allocator, e.g. ArenaAllocator. Defaults to std::allocator
+template <NonConst T, typename TAllocator /*= std::allocator<T>*/>
 class Array {
-    std::vector<T> mImpl;
+    using Impl = std::vector<T, TAllocator>;
+    Impl mImpl;
 
 public:
     // =======================================================================================================
@@ -33,6 +36,10 @@ public:
     Array(std::initializer_list<T> items) requires std::copyable<T>
         : mImpl(std::move(items)) {}
 
+    /// Creates an empty array which draws its memory from the given allocator
+    explicit Array(const TAllocator& allocator)
+        : mImpl(allocator) {}
+
     template <IterableContainer T2>
     explicit Array(T2&& container) requires std::assignable_from<T&, decltype(*std::declval<T2>().begin())>
         : mImpl(std::begin(container), std::end(container)) {}
@@ -65,28 +72,28 @@ public:
     // Front, back, element access, iterators
     // =======================================================================================================
 
-    typename std::vector<T>::reference front() {
+    typename Impl::reference front() {
         BUFF_ASSERT(notEmpty());
         return mImpl.front();
     }
-    typename std::vector<T>::const_reference front() const {
+    typename Impl::const_reference front() const {
         BUFF_ASSERT(notEmpty());
         return mImpl.front();
     }
-    typename std::vector<T>::reference back() {
+    typename Impl::reference back() {
         BUFF_ASSERT(notEmpty());
         return mImpl.back();
     }
-    typename std::vector<T>::const_reference back() const {
+    typename Impl::const_reference back() const {
         BUFF_ASSERT(notEmpty());
         return mImpl.back();
     }
 
-    typename std::vector<T>::const_reference operator[](const int64 index) const {
+    typename Impl::const_reference operator[](const int64 index) const {
         assertValidIndex(index);
         return mImpl[index];
     }
-    typename std::vector<T>::reference operator[](const int64 index) {
+    typename Impl::reference operator[](const int64 index) {
         assertValidIndex(index);
         return mImpl[index];
     }
@@ -154,12 +161,22 @@ public:
 
     template <typename T2> // heterogeneous lookup
     Optional<int64> find(T2&& value) const requires EqualsComparable<T, T2> {
-        for (const int64 i : range(size())) {
-            if (mImpl[i] == value) {
-                return i;
+        // std::vector<bool> has no contiguous storage
+        if constexpr (Simd::BitwiseComparable<T> && !std::is_same_v<T, bool> &&
+                      std::is_same_v<std::remove_cvref_t<T2>, T>) {
+            const int64 index = Simd::findEqual(mImpl.data(), size(), value);
+            if (index == size()) {
+                return NULL_OPTIONAL;
+            }
+            return index;
+        } else {
+            for (const int64 i : range(size())) {
+                if (mImpl[i] == value) {
+                    return i;
+                }
             }
+            return NULL_OPTIONAL;
         }
-        return NULL_OPTIONAL;
     }
 
     // =======================================================================================================
@@ -309,4 +326,9 @@ private:
     }
 };
 
+namespace Detail {
+template <typename T, typename TAllocator>
+constexpr bool IS_SIZED_LIST<Array<T, TAllocator>> = true;
+}
+
 BUFF_NAMESPACE_END
@@ -1,6 +1,10 @@
 #include "Lib/containers/Array2D.h"
 #include "Lib/Bootstrap.Test.h"
+#include "Lib/Json.h"
+#include "Lib/Rgb8Bit.h"
 #include "Lib/String.h"
+#include "Lib/Time.h"
+#include <iostream>
 
 BUFF_NAMESPACE_BEGIN
 
@@ -10,5 +14,97 @@ template class Array2D<float>;
 template class Array2D<String>;
 template class Array2D<String*>;
 template class Array2D<NoncopyableMovable>;
+template class Array2D<int, TiledLayout<>>;
+template class Array2D<String, MortonLayout<>>;
+
+template <typename TLayout>
+static void testLayout(const Pixel size) {
+    Array2D<int, TLayout> array(size);
+    for (const int y : range(size.y)) {
+        for (const int x : range(size.x)) {
+            array(x, y) = x + y * size.x;
+        }
+    }
+    // Every pixel maps to a unique index, which maps back
+    Array<bool> seen(array.getPixelCount(), false);
+    for (const int64 i : range(array.getPixelCount())) {
+        const Pixel pos = array.getNthPixelPosition(i);
+        CHECK(array.getNthPixel(i) == pos.x + pos.y * size.x);
+        CHECK(!seen[array[pos]]);
+        seen[array[pos]] = true;
+    }
+
+    const Array2D<int> rowMajor = array.template toLayout<RowMajorLayout>();
+    for (const int64 i : range(rowMajor.getPixelCount())) {
+        CHECK(rowMajor.getNthPixel(i) == i);
+    }
+    const Array2D<int, TLayout> back = rowMajor.template toLayout<TLayout>();
+    CHECK(std::ranges::equal(back, array));
+}
+
+TEST_CASE("Array2D layouts") {
+    for (const Pixel size : {Pixel(1, 1), Pixel(8, 8), Pixel(13, 5), Pixel(37, 70), Pixel(64, 3)}) {
+        testLayout<RowMajorLayout>(size);
+        testLayout<TiledLayout<>>(size);
+        testLayout<TiledLayout<4>>(size);
+        testLayout<MortonLayout<8>>(size);
+        testLayout<MortonLayout<>>(size);
+    }
+}
+
+TEST_CASE("Array2D Morton order") {
+    Array2D<int, MortonLayout<4>> array(4, 4);
+    CHECK(array.getNthPixelPosition(0) == Pixel(0, 0));
+    CHECK(array.getNthPixelPosition(1) == Pixel(1, 0));
+    CHECK(array.getNthPixelPosition(2) == Pixel(0, 1));
+    CHECK(array.getNthPixelPosition(3) == Pixel(1, 1));
+    CHECK(array.getNthPixelPosition(4) == Pixel(2, 0));
+    CHECK(array.getNthPixelPosition(15) == Pixel(3, 3));
+}
+
+TEST_CASE("Array2D serialize") {
+    Array2D<int, TiledLayout<>> array(10, 10);
+    array(3, 9) = 5;
+    JsonSerializer serializer;
+    serializer.serialize(array, "array");
+    JsonDeserializer            deserializer(serializer.getJson(true));
+    Array2D<int, TiledLayout<>> array2;
+    deserializer.deserialize(array2, "array");
+    CHECK(array2.size() == Pixel(10, 10));
+    CHECK(array2(3, 9) == 5);
+}
+
+template <typename TLayout>
+static void benchmarkLayout(const char* name) {
+    Array2D<Rgba8Bit, TLayout> image(3840, 2160);
+    for (const int64 i : range(image.getPixelCount())) {
+        image.getNthPixel(i) = Rgba8Bit(uint8(i), uint8(i >> 8), uint8(i >> 16));
+    }
+    int64       sum = 0;
+    const Timer timer;
+    for (const int y : range(image.size().y)) {
+        for (const int x : range(image.size().x)) {
+            sum += image(x, y)[0];
+        }
+    }
+    const Duration horizontal = timer.getElapsed();
+    for (const int x : range(image.size().x)) {
+        for (const int y : range(image.size().y)) {
+            sum += image(x, y)[0];
+        }
+    }
+    Duration vertical = timer.getElapsed();
+    vertical -= horizontal;
+    CHECK(sum > 0);
+    std::cout << name << ": horizontal " << horizontal.getUserReadable() << ", vertical "
+              << vertical.getUserReadable() << std::endl;
+}
+
+TEST_CASE("Array2D layout benchmark" * doctest::skip()) {
+    benchmarkLayout<RowMajorLayout>("RowMajorLayout");
+    benchmarkLayout<TiledLayout<8>>("TiledLayout<8>");
+    benchmarkLayout<TiledLayout<32>>("TiledLayout<32>");
+    benchmarkLayout<MortonLayout<>>("MortonLayout<256>");
+}
 
 BUFF_NAMESPACE_END
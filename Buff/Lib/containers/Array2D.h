@@ -5,11 +5,126 @@
 
 BUFF_NAMESPACE_BEGIN
 
-template <typename T>
+// ===========================================================================================================
+// Layouts
+// ===========================================================================================================
+
+/// Rows stored one after another. Fastest for horizontal walks, and the only layout compatible with APIs
+/// expecting a plain bitmap (SDL surfaces, textures, ...).
+struct RowMajorLayout {
+    static int64 map(const Pixel size, const int x, const int y) {
+        return x + y * int64(size.x);
+    }
+    static Pixel unmap(const Pixel size, const int64 index) {
+        return Pixel(int(index % size.x), int(index / size.x));
+    }
+};
+
+namespace Detail {
+
+/// Square tiles stored row by row, each tile stored contiguously. Tiles on the right and bottom edge are
+/// cropped to the image, so there is no padding and any image size works. Full tiles are ordered by
+/// TInTile, cropped tiles always row-major.
+template <int TTileSize, typename TInTile>
+struct TiledLayoutImpl {
+    static_assert(TTileSize > 0 && (TTileSize & (TTileSize - 1)) == 0, "Tile size must be a power of 2");
+    static constexpr int TILE_MASK = TTileSize - 1;
+
+    static int64 map(const Pixel size, const int x, const int y) {
+        const int   tileX      = x & ~TILE_MASK;
+        const int   tileY      = y & ~TILE_MASK;
+        const int   tileWidth  = std::min(TTileSize, size.x - tileX);
+        const int   tileHeight = std::min(TTileSize, size.y - tileY);
+        const int64 tileStart  = tileY * int64(size.x) + tileX * int64(tileHeight);
+        const int   localX     = x & TILE_MASK;
+        const int   localY     = y & TILE_MASK;
+        if (tileWidth == TTileSize && tileHeight == TTileSize) {
+            return tileStart + TInTile::map(localX, localY);
+        }
+        return tileStart + localX + localY * tileWidth;
+    }
+
+    static Pixel unmap(const Pixel size, int64 index) {
+        const int64 bandSize = TTileSize * int64(size.x);
+        const int   tileY    = int(index / bandSize) * TTileSize;
+        index -= tileY * int64(size.x);
+        const int tileHeight = std::min(TTileSize, size.y - tileY);
+        const int tileX      = int(index / (TTileSize * int64(tileHeight))) * TTileSize;
+        index -= tileX * int64(tileHeight);
+        const int tileWidth = std::min(TTileSize, size.x - tileX);
+        if (tileWidth == TTileSize && tileHeight == TTileSize) {
+            return Pixel(tileX, tileY) + TInTile::unmap(int(index));
+        }
+        return Pixel(tileX + int(index % tileWidth), tileY + int(index / tileWidth));
+    }
+};
+
+template <int TTileSize>
+struct RowMajorInTile {
+    static int map(const int x, const int y) {
+        return x + y * TTileSize;
+    }
+    static Pixel unmap(const int index) {
+        return Pixel(index % TTileSize, index / TTileSize);
+    }
+};
+
+/// Z-order curve: bits of x and y interleaved, x in the even bits
+struct MortonInTile {
+    static int map(const int x, const int y) {
+        return int(spreadBits(uint(x)) | (spreadBits(uint(y)) << 1));
+    }
+    static Pixel unmap(const int index) {
+        return Pixel(int(compactBits(uint(index))), int(compactBits(uint(index) >> 1)));
+    }
+
+private:
+    /// Moves bit i of the lower 16 bits to bit 2i
+    static uint spreadBits(uint value) {
+        value = (value | (value << 8)) & 0x00FF00FF;
+        value = (value | (value << 4)) & 0x0F0F0F0F;
+        value = (value | (value << 2)) & 0x33333333;
+        value = (value | (value << 1)) & 0x55555555;
+        return value;
+    }
+    static uint compactBits(uint value) {
+        value &= 0x55555555;
+        value = (value | (value >> 1)) & 0x33333333;
+        value = (value | (value >> 2)) & 0x0F0F0F0F;
+        value = (value | (value >> 4)) & 0x00FF00FF;
+        value = (value | (value >> 8)) & 0x0000FFFF;
+        return value;
+    }
+};
+
+} // namespace Detail
+
+/// TTileSize x TTileSize blocks stored contiguously. Neighborhood filters and vertical walks stay within a few
+/// cache lines.
+template <int TTileSize = 8>
+struct TiledLayout : Detail::TiledLayoutImpl<TTileSize, Detail::RowMajorInTile<TTileSize>> {};
+
+/// Z-order (Morton) curve within TTileSize x TTileSize tiles, tiles stored row by row. Keeps locality at all
+/// scales up to the tile size, without padding the image to a power of 2 square.
+template <int TTileSize = 256>
+struct MortonLayout : Detail::TiledLayoutImpl<TTileSize, Detail::MortonInTile> {
+    static_assert(TTileSize <= (1 << 15));
+};
+
+// ===========================================================================================================
+// Array2D
+// ===========================================================================================================
+
+/// \param TLayout Order of pixels in memory, one of RowMajorLayout, TiledLayout, MortonLayout. Iteration,
+/// data() and getNthPixel() all follow this order.
+template <typename T, typename TLayout = RowMajorLayout>
 class Array2D {
     Array<T> mImpl;
     Pixel    mSize;
 
+    template <typename, typename>
+    friend class Array2D;
+
 public:
     Array2D()
         : mSize(0, 0) {}
@@ -52,6 +167,7 @@ public:
     //     return mImpl[map(x, y)];
     // }
 
+    /// Index in memory order, see TLayout
     const T& getNthPixel(const int64 index) const {
         return mImpl[index];
     }
@@ -59,6 +175,12 @@ public:
         return mImpl[index];
     }
 
+    /// Position of the index-th pixel in memory order
+    Pixel getNthPixelPosition(const int64 index) const {
+        BUFF_ASSERT(index >= 0 && index < getPixelCount());
+        return TLayout::unmap(mSize, index);
+    }
+
     Pixel size() const {
         return mSize;
     }
@@ -88,6 +210,18 @@ public:
         mImpl.fill(value);
     }
 
+    /// Copy of the array with pixels reordered to another layout
+    template <typename TOtherLayout>
+    Array2D<T, TOtherLayout> toLayout() const requires std::copyable<T> {
+        Array2D<T, TOtherLayout> result(mSize);
+        for (const int64 i : range(getPixelCount())) {
+            const Pixel pos                        = TLayout::unmap(mSize, i);
+            result.mImpl[result.map(pos.x, pos.y)] = mImpl[i];
+        }
+        return result;
+    }
+
+    /// Pixels are stored in memory order, deserialize into the same layout
     void serializeCustom(ISerializer& serializer) const requires Serializable<T> {
         serializer.serialize(mSize, "size");
         serializer.serializeList(mImpl, "data");
@@ -101,7 +235,7 @@ public:
 private:
     int64 map(const int x, const int y) const {
         BUFF_ASSERT(x >= 0 && y >= 0 && x < mSize.x && y < mSize.y);
-        return x + y * int64(mSize.x);
+        return TLayout::map(mSize, x, y);
     }
 };
 
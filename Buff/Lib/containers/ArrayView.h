@@ -3,6 +3,7 @@
 #include "Lib/Concepts.h"
 #include "Lib/containers/Iterator.h"
 #include "Lib/Optional.h"
+#include <memory>
 
 BUFF_NAMESPACE_BEGIN
 
@@ -11,7 +12,7 @@ template <typename T, int64 TSize, typename TIndex = int64>
 class StaticArray;
 template <typename T, int TSmallSize>
 class SmallArray;
-template <NonConst T>
+template <NonConst T, typename TAllocator = std::allocator<T>>
 class Array;
 
 template <typename T>
@@ -136,10 +137,10 @@ ArrayView(const SmallArray<T, TSmallSize>&) -> ArrayView<const T>;
 template <typename T, int TSmallSize>
 ArrayView(SmallArray<T, TSmallSize>&) -> ArrayView<T>;
 
-template <typename T>
-ArrayView(const Array<T>&) -> ArrayView<const T>;
-template <typename T>
-ArrayView(Array<T>&) -> ArrayView<T>;
+template <typename T, typename TAllocator>
+ArrayView(const Array<T, TAllocator>&) -> ArrayView<const T>;
+template <typename T, typename TAllocator>
+ArrayView(Array<T, TAllocator>&) -> ArrayView<T>;
 
 ArrayView(const StringView&) -> ArrayView<const char>;
 // ReSharper restore CppInconsistentNaming
@@ -0,0 +1,128 @@
+#include "Lib/containers/BTreeMap.h"
+#include "Lib/Bootstrap.Test.h"
+#include "Lib/Json.h"
+#include "Lib/Pixel.h"
+#include "Lib/Random.h"
+
+BUFF_NAMESPACE_BEGIN
+
+// Test compilation:
+template class BTreeMap<int, int>;
+template class BTreeMap<float, String>;
+template class BTreeMap<String, String>;
+template class BTreeMap<String*, int>;
+template class BTreeMap<int, NoncopyableMovable>;
+
+TEST_CASE("BTreeMap simple") {
+    BTreeMap<String, int> map;
+    CHECK(map.isEmpty());
+    CHECK(map.begin() == map.end());
+    map["b"] = 2;
+    map.insert("a", 1);
+    map["c"] = 3;
+    CHECK(map.size() == 3);
+    CHECK(*map.find("a") == 1);
+    CHECK(!map.find("d"));
+    CHECK(map.contains(StringView("c")));
+    map.erase("b");
+    CHECK(map.size() == 2);
+    CHECK(!map.contains("b"));
+    map.erase("a");
+    map.erase("c");
+    CHECK(map.isEmpty());
+    map["x"] = 10;
+    CHECK(map.begin()->first == "x");
+}
+
+TEST_CASE("BTreeMap random operations") {
+    BTreeMap<int, int>    map;
+    std::map<int, int>    reference;
+    RandomNumberGenerator rng;
+    for (const int i : range(200'000)) {
+        const int key = rng.getRandomInt(19'999);
+        if (rng.getRandomInt(2) == 0) {
+            if (reference.erase(key)) {
+                map.erase(key);
+            } else {
+                CHECK(!map.contains(key));
+            }
+        } else {
+            map[key]       = i;
+            reference[key] = i;
+        }
+        CHECK(map.size() == int64(reference.size()));
+    }
+    auto it = reference.begin();
+    for (auto& [key, value] : map) {
+        REQUIRE(it != reference.end());
+        CHECK(key == it->first);
+        CHECK(value == it->second);
+        ++it;
+    }
+    CHECK(it == reference.end());
+    for (const int key : range(20'000)) {
+        const auto found = reference.find(key);
+        CHECK((map.find(key) ? *map.find(key) : -1) == (found != reference.end() ? found->second : -1));
+    }
+    for (const int key : range(20'000)) {
+        if (reference.contains(key)) {
+            map.erase(key);
+        }
+    }
+    CHECK(map.isEmpty());
+}
+
+TEST_CASE("BTreeMap bulk load and range") {
+    Array<std::pair<int, int>> items;
+    for (const int i : range(10'000)) {
+        items.pushBack({i * 2, i});
+    }
+    BTreeMap<int, int> map(items);
+    CHECK(map.size() == 10'000);
+    CHECK(*map.find(500) == 250);
+    CHECK(!map.find(501));
+
+    int count = 0;
+    for (auto& [key, value] : map.getRange(101, 121)) {
+        CHECK(key == 102 + count * 2);
+        ++count;
+    }
+    CHECK(count == 10);
+    CHECK(map.lowerBound(19'999) == map.end());
+    CHECK(map.getRange(-10, 0).begin() == map.getRange(-10, 0).end());
+
+    BTreeMap<int, int> unsorted(Array<std::pair<int, int>> {{3, 0}, {1, 0}, {2, 0}, {1, 1}});
+    CHECK(unsorted.size() == 3);
+    CHECK(*unsorted.find(1) == 0);
+    CHECK(unsorted.begin()->first == 1);
+
+    BTreeMap<int, int> copy = map;
+    map.clear();
+    CHECK(copy.size() == 10'000);
+    CHECK(*copy.find(19'998) == 9'999);
+}
+
+TEST_CASE("BTreeMap serialize") {
+    BTreeMap<String, Pixel> map; // Try non-trivial type and compound type
+    map["abc"] = Pixel(1, 2);
+    map["cde"] = Pixel(3, 4);
+
+    JsonSerializer serializer;
+    serializer.serialize(map, "map");
+    const String state = serializer.getJson(true);
+    CHECK(parseJson(state));
+
+    JsonDeserializer        deserializer(state);
+    BTreeMap<String, Pixel> map2;
+    deserializer.deserialize(map2, "map");
+    CHECK(map == map2);
+
+    // Interchangeable with Map
+    JsonDeserializer   deserializer2(state);
+    Map<String, Pixel> map3;
+    deserializer2.deserialize(map3, "map");
+    CHECK(map3.size() == 2);
+    CHECK(*map3.find("cde") == Pixel(3, 4));
+}
+
+BUFF_NAMESPACE_END
@@ -0,0 +1,742 @@
+#pragma once
+#include "Lib/Bootstrap.h"
+#include "Lib/containers/Array.h"
+#include "Lib/containers/Map.h"
+#include "Lib/Serialization.h"
+#include <memory>
+
+BUFF_NAMESPACE_BEGIN
+
+/// Ordered map for large data sets, drop-in replacement of Map. Implemented as a B+ tree: items are stored
+/// in leaves of a few cache lines each, linked for ordered iteration, and inner nodes hold only keys.
+/// Compared to the one-allocation-per-item red-black tree of Map, this needs a fraction of the memory and
+/// touches far fewer cache lines per lookup.
+///
+/// Keys need to be copyable, because copies are used as separators in the inner nodes. Pointers to items are
+/// invalidated by insertion and erasure. Keys must not be modified through the iterators.
+template <LessThanComparable TKey, typename TValue>
+class BTreeMap {
+public:
+    using Key   = TKey;
+    using Value = TValue;
+    using Item  = std::pair<TKey, TValue>;
+
+private:
+    static constexpr int NODE_BYTES = 4 * 64; // 4 cache lines
+
+    static constexpr int LEAF_CAPACITY  = std::clamp(int(NODE_BYTES / sizeof(Item)), 8, 64);
+    static constexpr int INNER_CAPACITY = std::clamp(int(NODE_BYTES / sizeof(TKey)), 8, 64);
+    static constexpr int LEAF_MIN       = LEAF_CAPACITY / 2;
+    static constexpr int INNER_MIN      = INNER_CAPACITY / 2 - 1;
+
+    /// Array of objects with manual lifetime, only the first count elements are alive
+    template <typename T, int TCapacity>
+    struct Storage {
+        alignas(T) std::byte bytes[TCapacity * sizeof(T)];
+
+        T* get() {
+            return std::launder(reinterpret_cast<T*>(bytes));
+        }
+        const T* get() const {
+            return std::launder(reinterpret_cast<const T*>(bytes));
+        }
+    };
+
+    struct Node : Noncopyable {
+        bool isLeaf;
+        int  count = 0; // Number of items in leaf, number of keys in inner node
+
+        explicit Node(const bool isLeaf)
+            : isLeaf(isLeaf) {}
+    };
+    struct Leaf : Node {
+        Storage<Item, LEAF_CAPACITY> items;
+        Leaf*                        previous = nullptr;
+        Leaf*                        next     = nullptr;
+
+        Leaf()
+            : Node(true) {}
+        ~Leaf() {
+            std::destroy_n(items.get(), this->count);
+        }
+    };
+    /// Child i holds keys in range [keys[i - 1], keys[i])
+    struct Inner : Node {
+        Storage<TKey, INNER_CAPACITY> keys;
+        Node*                         children[INNER_CAPACITY + 1];
+
+        Inner()
+            : Node(false) {}
+        ~Inner() {
+            std::destroy_n(keys.get(), this->count);
+        }
+    };
+
+    Node* mRoot  = nullptr;
+    Leaf* mFirst = nullptr;
+    int64 mSize  = 0;
+
+    struct SerializedItem {
+        TKey   key;
+        TValue value;
+        void   enumerateStructMembers(auto&& functor) {
+            functor(key, "key");
+            functor(value, "value");
+        }
+    };
+
+    template <bool TConst>
+    class IteratorImpl {
+        friend class BTreeMap;
+        using LeafType = std::conditional_t<TConst, const Leaf, Leaf>;
+        using ItemType = std::conditional_t<TConst, const Item, Item>;
+
+        LeafType* mLeaf  = nullptr;
+        int       mIndex = 0;
+
+    public:
+        using value_type      = Item;
+        using difference_type = std::ptrdiff_t;
+
+        IteratorImpl() = default;
+        IteratorImpl(LeafType* leaf, const int index)
+            : mLeaf(leaf)
+            , mIndex(index) {
+            if (mLeaf && mIndex == mLeaf->count) {
+                mLeaf  = mLeaf->next;
+                mIndex = 0;
+            }
+        }
+
+        ItemType& operator*() const {
+            return mLeaf->items.get()[mIndex];
+        }
+        ItemType* operator->() const {
+            return &mLeaf->items.get()[mIndex];
+        }
+        IteratorImpl& operator++() {
+            if (++mIndex == mLeaf->count) {
+                mLeaf  = mLeaf->next;
+                mIndex = 0;
+            }
+            return *this;
+        }
+        IteratorImpl operator++(int) {
+            IteratorImpl result = *this;
+            ++*this;
+            return result;
+        }
+        bool operator==(const IteratorImpl& other) const = default;
+    };
+
+    template <typename TIterator>
+    class RangeImpl {
+        TIterator mBegin;
+        TIterator mEnd;
+
+    public:
+        RangeImpl(const TIterator begin, const TIterator end)
+            : mBegin(begin)
+            , mEnd(end) {}
+        TIterator begin() const {
+            return mBegin;
+        }
+        TIterator end() const {
+            return mEnd;
+        }
+    };
+
+public:
+    using Iterator      = IteratorImpl<false>;
+    using ConstIterator = IteratorImpl<true>;
+
+    BTreeMap() = default;
+
+    BTreeMap(const BTreeMap& other) requires std::copyable<TValue> {
+        Array<Item> items;
+        items.reserve(other.size());
+        for (const Item& item : other) {
+            items.pushBack(item);
+        }
+        buildFromSorted(items);
+    }
+
+    BTreeMap(BTreeMap&& other) noexcept
+        : mRoot(std::exchange(other.mRoot, nullptr))
+        , mFirst(std::exchange(other.mFirst, nullptr))
+        , mSize(std::exchange(other.mSize, 0)) {}
+
+    BTreeMap& operator=(const BTreeMap& other) requires std::copyable<TValue> {
+        if (this != &other) {
+            *this = BTreeMap(other);
+        }
+        return *this;
+    }
+
+    BTreeMap& operator=(BTreeMap&& other) noexcept {
+        std::swap(mRoot, other.mRoot);
+        std::swap(mFirst, other.mFirst);
+        std::swap(mSize, other.mSize);
+        return *this;
+    }
+
+    /// The container does not need to be sorted, but sorted input is loaded directly without any searching.
+    /// If a key is present multiple times, its first occurrence is used, same as in Map.
+    template <IterableContainer TContainer>
+    explicit BTreeMap(TContainer&& container)
+        requires Detail::MapItemConstructible<decltype(*std::begin(container)), BTreeMap> {
+        Array<Item> items;
+        for (auto&& item : container) {
+            if constexpr (std::is_rvalue_reference_v<TContainer&&>) {
+                items.emplaceBack(std::move(item.first), std::move(item.second));
+            } else {
+                items.emplaceBack(item.first, item.second);
+            }
+        }
+        const auto less = [](const Item& a, const Item& b) { return a.first < b.first; };
+        if (!std::is_sorted(items.begin(), items.end(), less)) {
+            std::ranges::stable_sort(items, less);
+        }
+        const auto equal  = [](const Item& a, const Item& b) { return !(a.first < b.first); };
+        Item*      newEnd = std::unique(items.data(), items.data() + items.size(), equal);
+        items.eraseRange(newEnd - items.data(), items.data() + items.size() - newEnd);
+        buildFromSorted(items);
+    }
+
+    ~BTreeMap() {
+        destroy(mRoot);
+    }
+
+    /// Same format as Map, the two can be used interchangeably
+    void serializeCustom(ISerializer& serializer) const requires Serializable<TKey> && Serializable<TValue> {
+        Array<SerializedItem> flat;
+        flat.reserve(size());
+        for (auto&& [key, value] : *this) {
+            flat.emplaceBack(key, value);
+        }
+        serializer.serialize(size(), "size");
+        serializer.serializeList(flat, "items");
+    }
+    void deserializeCustom(IDeserializer& deserializer)
+        requires std::copyable<TValue> && Deserializable<TKey> && Deserializable<TValue> {
+        int64 newSize;
+        deserializer.deserialize(newSize, "size");
+        Array<SerializedItem> flat(newSize);
+        deserializer.deserializeList(flat, "items");
+        Array<Item> items;
+        items.reserve(newSize);
+        for (auto&& [key, value] : flat) {
+            items.emplaceBack(std::move(key), std::move(value));
+        }
+        *this = BTreeMap(std::move(items));
+    }
+
+    bool operator==(const BTreeMap& other) const requires EqualsComparable<TKey> && EqualsComparable<TValue> {
+        return size() == other.size() && std::equal(begin(), end(), other.begin());
+    }
+
+    // =======================================================================================================
+    // Iterators
+    // =======================================================================================================
+
+    ConstIterator begin() const {
+        return ConstIterator(mFirst, 0);
+    }
+    ConstIterator end() const {
+        return ConstIterator();
+    }
+    Iterator begin() {
+        return Iterator(mFirst, 0);
+    }
+    Iterator end() {
+        return Iterator();
+    }
+
+    /// First item with key not less than the given key
+    template <typename T2>
+    ConstIterator lowerBound(const T2& key) const requires LessThanComparable<TKey, T2> {
+        const Leaf* leaf = findLeaf(key);
+        return leaf ? ConstIterator(leaf, leafLowerBound(leaf, key)) : end();
+    }
+    template <typename T2>
+    Iterator lowerBound(const T2& key) requires LessThanComparable<TKey, T2> {
+        Leaf* leaf = findLeaf(key);
+        return leaf ? Iterator(leaf, leafLowerBound(leaf, key)) : end();
+    }
+
+    /// Items with from <= key < to, in order
+    template <typename T2, typename T3>
+    RangeImpl<ConstIterator> getRange(const T2& from, const T3& to) const
+        requires LessThanComparable<TKey, T2> && LessThanComparable<TKey, T3> {
+        return RangeImpl<ConstIterator>(lowerBound(from), lowerBound(to));
+    }
+    template <typename T2, typename T3>
+    RangeImpl<Iterator> getRange(const T2& from, const T3& to)
+        requires LessThanComparable<TKey, T2> && LessThanComparable<TKey, T3> {
+        return RangeImpl<Iterator>(lowerBound(from), lowerBound(to));
+    }
+
+    // =======================================================================================================
+    // Queries
+    // =======================================================================================================
+
+    bool isEmpty() const {
+        return mSize == 0;
+    }
+    bool notEmpty() const {
+        return mSize != 0;
+    }
+
+    int64 size() const {
+        return mSize;
+    }
+
+    template <typename T2>
+    bool contains(T2&& key) const requires LessThanComparable<T2, TKey> {
+        return find(key) != nullptr;
+    }
+
+    template <typename T2>
+    const TValue* find(T2&& key) const requires LessThanComparable<T2, TKey> {
+        const Leaf* leaf = findLeaf(key);
+        if (!leaf) {
+            return nullptr;
+        }
+        const int   index = leafLowerBound(leaf, key);
+        const Item* item  = leaf->items.get() + index;
+        return index < leaf->count && !(key < item->first) ? &item->second : nullptr;
+    }
+    template <typename T2>
+    TValue* find(T2&& key) requires LessThanComparable<T2, TKey> {
+        return const_cast<TValue*>(std::as_const(*this).find(key));
+    }
+
+    /// Creates an element if the key is not already present!
+    template <typename T2>
+    TValue& operator[](T2&& key)
+        requires LessThanComparable<T2, TKey> && std::is_default_constructible_v<TValue> {
+        if (TValue* found = find(key)) {
+            return *found;
+        }
+        return insertNew(Item(TKey(std::forward<T2>(key)), TValue())).second;
+    }
+
+    // =======================================================================================================
+    // Modification
+    // =======================================================================================================
+
+    /// Keys already present in the map are skipped
+    template <IterableContainer T>
+    void insertRange(T&& range)
+        requires Detail::MapItemConstructible<decltype(*std::begin(range)), BTreeMap> {
+        if (isEmpty()) {
+            *this = BTreeMap(std::forward<T>(range));
+            return;
+        }
+        for (auto&& item : range) {
+            if (!contains(item.first)) {
+                insertNew(Item(item.first, item.second));
+            }
+        }
+    }
+
+    void insert(TKey key, TValue value) {
+        BUFF_ASSERT(!contains(key));
+        insertNew(Item(std::move(key), std::move(value)));
+    }
+
+    void clear() {
+        destroy(mRoot);
+        mRoot  = nullptr;
+        mFirst = nullptr;
+        mSize  = 0;
+    }
+
+    template <typename T2>
+    void erase(T2&& key) requires LessThanComparable<T2, TKey> {
+        BUFF_ASSERT(mRoot);
+        eraseRecursive(mRoot, key);
+        --mSize;
+        if (mRoot->count == 0) {
+            Node* oldRoot = mRoot;
+            if (mRoot->isLeaf) {
+                mRoot  = nullptr;
+                mFirst = nullptr;
+            } else {
+                mRoot = static_cast<Inner*>(mRoot)->children[0];
+            }
+            deleteNode(oldRoot);
+        }
+    }
+
+private:
+    // =======================================================================================================
+    // Array helpers
+    // =======================================================================================================
+
+    /// Inserts into alive elements [0, count), count + 1 must fit
+    template <typename T>
+    static void insertAt(T* array, const int count, const int index, T&& value) {
+        if (index == count) {
+            std::construct_at(array + count, std::move(value));
+        } else {
+            std::construct_at(array + count, std::move(array[count - 1]));
+            std::move_backward(array + index, array + count - 1, array + count);
+            array[index] = std::move(value);
+        }
+    }
+
+    template <typename T>
+    static T removeAt(T* array, const int count, const int index) {
+        T result = std::move(array[index]);
+        std::move(array + index + 1, array + count, array + index);
+        std::destroy_at(array + count - 1);
+        return result;
+    }
+
+    /// Moves elements into uninitialized memory and destroys the originals
+    template <typename T>
+    static void relocate(T* from, const int count, T* to) {
+        std::uninitialized_move_n(from, count, to);
+        std::destroy_n(from, count);
+    }
+
+    // =======================================================================================================
+    // Search
+    // =======================================================================================================
+
+    template <typename T2>
+    static int innerUpperBound(const Inner* node, const T2& key) {
+        const TKey* keys = node->keys.get();
+        return int(std::upper_bound(keys, keys + node->count, key, [](const T2& value, const TKey& nodeKey) {
+                       return value < nodeKey;
+                   }) -
+                   keys);
+    }
+
+    template <typename T2>
+    static int leafLowerBound(const Leaf* leaf, const T2& key) {
+        const Item* items = leaf->items.get();
+        return int(std::lower_bound(items, items + leaf->count, key, [](const Item& item, const T2& value) {
+                       return item.first < value;
+                   }) -
+                   items);
+    }
+
+    template <typename T2>
+    Leaf* findLeaf(const T2& key) const {
+        Node* node = mRoot;
+        if (!node) {
+            return nullptr;
+        }
+        while (!node->isLeaf) {
+            const Inner* inner = static_cast<const Inner*>(node);
+            node               = inner->children[innerUpperBound(inner, key)];
+        }
+        return static_cast<Leaf*>(node);
+    }
+
+    // =======================================================================================================
+    // Insertion
+    // =======================================================================================================
+
+    struct Split {
+        Optional<TKey> separator;
+        Node*          right = nullptr;
+    };
+
+    /// The key must not be present in the map
+    Item& insertNew(Item&& item) {
+        if (!mRoot) {
+            mFirst = new Leaf;
+            mRoot  = mFirst;
+        }
+        Split split;
+        Item& result = insertRecursive(mRoot, std::move(item), split);
+        if (split.right) {
+            Inner* newRoot = new Inner;
+            std::construct_at(newRoot->keys.get(), std::move(*split.separator));
+            newRoot->children[0] = mRoot;
+            newRoot->children[1] = split.right;
+            newRoot->count       = 1;
+            mRoot                = newRoot;
+        }
+        ++mSize;
+        return result;
+    }
+
+    Item& insertRecursive(Node* node, Item&& item, Split& split) {
+        if (node->isLeaf) {
+            Leaf*     leaf  = static_cast<Leaf*>(node);
+            const int index = leafLowerBound(leaf, item.first);
+            if (leaf->count < LEAF_CAPACITY) {
+                insertAt(leaf->items.get(), leaf->count, index, std::move(item));
+                ++leaf->count;
+                return leaf->items.get()[index];
+            }
+            Leaf* right = splitLeaf(leaf);
+            Item* result;
+            if (index <= leaf->count) {
+                insertAt(leaf->items.get(), leaf->count, index, std::move(item));
+                ++leaf->count;
+                result = &leaf->items.get()[index];
+            } else {
+                const int rightIndex = index - leaf->count;
+                insertAt(right->items.get(), right->count, rightIndex, std::move(item));
+                ++right->count;
+                result = &right->items.get()[rightIndex];
+            }
+            split.separator = right->items.get()[0].first;
+            split.right     = right;
+            return *result;
+        }
+
+        Inner*    inner = static_cast<Inner*>(node);
+        const int index = innerUpperBound(inner, item.first);
+        Split     childSplit;
+        Item&     result = insertRecursive(inner->children[index], std::move(item), childSplit);
+        if (childSplit.right) {
+            if (inner->count < INNER_CAPACITY) {
+                insertChild(inner, index, std::move(*childSplit.separator), childSplit.right);
+            } else {
+                // Middle key moves up, the new child goes to the half where it belongs
+                const int mid   = INNER_CAPACITY / 2;
+                Inner*    right = new Inner;
+                split.separator = std::move(inner->keys.get()[mid]);
+                relocate(inner->keys.get() + mid + 1, INNER_CAPACITY - mid - 1, right->keys.get());
+                std::destroy_at(inner->keys.get() + mid);
+                std::copy_n(inner->children + mid + 1, INNER_CAPACITY - mid, right->children);
+                inner->count = mid;
+                right->count = INNER_CAPACITY - mid - 1;
+                if (index <= mid) {
+                    insertChild(inner, index, std::move(*childSplit.separator), childSplit.right);
+                } else {
+                    insertChild(right, index - mid - 1, std::move(*childSplit.separator), childSplit.right);
+                }
+                split.right = right;
+            }
+        }
+        return result;
+    }
+
+    /// Inserts key at index and child after it
+    static void insertChild(Inner* inner, const int index, TKey&& key, Node* child) {
+        insertAt(inner->keys.get(), inner->count, index, std::move(key));
+        std::copy_backward(inner->children + index + 1,
+                           inner->children + inner->count + 1,
+                           inner->children + inner->count + 2);
+        inner->children[index + 1] = child;
+        ++inner->count;
+    }
+
+    /// Moves upper half of a full leaf to a new leaf linked after it
+    Leaf* splitLeaf(Leaf* leaf) {
+        constexpr int MID   = LEAF_CAPACITY / 2;
+        Leaf*         right = new Leaf;
+        relocate(leaf->items.get() + MID, LEAF_CAPACITY - MID, right->items.get());
+        leaf->count     = MID;
+        right->count    = LEAF_CAPACITY - MID;
+        right->previous = leaf;
+        right->next     = leaf->next;
+        if (leaf->next) {
+            leaf->next->previous = right;
+        }
+        leaf->next = right;
+        return right;
+    }
+
+    // =======================================================================================================
+    // Erasure
+    // =======================================================================================================
+
+    /// Returns true if the node has too few items afterwards
+    template <typename T2>
+    bool eraseRecursive(Node* node, const T2& key) {
+        if (node->isLeaf) {
+            Leaf*     leaf  = static_cast<Leaf*>(node);
+            const int index = leafLowerBound(leaf, key);
+            BUFF_ASSERT(index < leaf->count && !(key < leaf->items.get()[index].first));
+            removeAt(leaf->items.get(), leaf->count, index);
+            --leaf->count;
+            return leaf->count < LEAF_MIN;
+        }
+        Inner*    inner = static_cast<Inner*>(node);
+        const int index = innerUpperBound(inner, key);
+        if (eraseRecursive(inner->children[index], key)) {
+            rebalanceChild(inner, index);
+        }
+        return inner->count < INNER_MIN;
+    }
+
+    /// Borrows an item from a sibling of the child, or merges it with a sibling
+    void rebalanceChild(Inner* parent, const int index) {
+        Node* child = parent->children[index];
+        Node* left  = index > 0 ? parent->children[index - 1] : nullptr;
+        Node* right = index < parent->count ? parent->children[index + 1] : nullptr;
+        if (child->isLeaf) {
+            Leaf* leaf = static_cast<Leaf*>(child);
+            if (left && left->count > LEAF_MIN) {
+                Leaf* from = static_cast<Leaf*>(left);
+                Item borrowed = removeAt(from->items.get(), from->count, from->count - 1);
+                insertAt(leaf->items.get(), leaf->count, 0, std::move(borrowed));
+                --from->count;
+                ++leaf->count;
+                parent->keys.get()[index - 1] = leaf->items.get()[0].first;
+            } else if (right && right->count > LEAF_MIN) {
+                Leaf* from = static_cast<Leaf*>(right);
+                Item borrowed = removeAt(from->items.get(), from->count, 0);
+                std::construct_at(leaf->items.get() + leaf->count, std::move(borrowed));
+                --from->count;
+                ++leaf->count;
+                parent->keys.get()[index] = from->items.get()[0].first;
+            } else if (left) {
+                mergeLeaves(parent, index - 1);
+            } else {
+                mergeLeaves(parent, index);
+            }
+        } else {
+            Inner* inner = static_cast<Inner*>(child);
+            if (left && left->count > INNER_MIN) {
+                Inner* from = static_cast<Inner*>(left);
+                // Separator goes down, last key of the sibling goes up
+                TKey separator = std::move(parent->keys.get()[index - 1]);
+                parent->keys.get()[index - 1] = removeAt(from->keys.get(), from->count, from->count - 1);
+                insertAt(inner->keys.get(), inner->count, 0, std::move(separator));
+                std::copy_backward(inner->children,
+                                   inner->children + inner->count + 1,
+                                   inner->children + inner->count + 2);
+                inner->children[0] = from->children[from->count];
+                --from->count;
+                ++inner->count;
+            } else if (right && right->count > INNER_MIN) {
+                Inner* from = static_cast<Inner*>(right);
+                std::construct_at(inner->keys.get() + inner->count, std::move(parent->keys.get()[index]));
+                inner->children[inner->count + 1] = from->children[0];
+                parent->keys.get()[index] = removeAt(from->keys.get(), from->count, 0);
+                std::copy(from->children + 1, from->children + from->count + 1, from->children);
+                --from->count;
+                ++inner->count;
+            } else if (left) {
+                mergeInners(parent, index - 1);
+            } else {
+                mergeInners(parent, index);
+            }
+        }
+    }
+
+    /// Removes separator at index and child after it from the parent
+    static void removeChild(Inner* parent, const int index) {
+        removeAt(parent->keys.get(), parent->count, index);
+        std::copy(parent->children + index + 2,
+                  parent->children + parent->count + 1,
+                  parent->children + index + 1);
+        --parent->count;
+    }
+
+    /// Merges child index + 1 into child index
+    void mergeLeaves(Inner* parent, const int index) {
+        Leaf* left  = static_cast<Leaf*>(parent->children[index]);
+        Leaf* right = static_cast<Leaf*>(parent->children[index + 1]);
+        BUFF_ASSERT(left->count + right->count <= LEAF_CAPACITY);
+        relocate(right->items.get(), right->count, left->items.get() + left->count);
+        left->count += right->count;
+        right->count = 0;
+        left->next   = right->next;
+        if (right->next) {
+            right->next->previous = left;
+        }
+        delete right;
+        removeChild(parent, index);
+    }
+
+    void mergeInners(Inner* parent, const int index) {
+        Inner* left  = static_cast<Inner*>(parent->children[index]);
+        Inner* right = static_cast<Inner*>(parent->children[index + 1]);
+        BUFF_ASSERT(left->count + right->count + 1 <= INNER_CAPACITY);
+        std::construct_at(left->keys.get() + left->count, std::move(parent->keys.get()[index]));
+        relocate(right->keys.get(), right->count, left->keys.get() + left->count + 1);
+        std::copy_n(right->children, right->count + 1, left->children + left->count + 1);
+        left->count += right->count + 1;
+        right->count = 0;
+        delete right;
+        removeChild(parent, index);
+    }
+
+    // =======================================================================================================
+    // Bulk operations
+    // =======================================================================================================
+
+    /// Builds the tree bottom up from sorted unique items. Nodes are filled evenly, so each is at least half
+    /// full.
+    void buildFromSorted(Array<Item>& items) {
+        clear();
+        if (items.isEmpty()) {
+            return;
+        }
+        struct LevelNode {
+            Node*       node;
+            const TKey* firstKey;
+        };
+        Array<LevelNode> level;
+        const int64      leafCount = (items.size() + LEAF_CAPACITY - 1) / LEAF_CAPACITY;
+        Leaf*            previous  = nullptr;
+        for (const int64 i : range(leafCount)) {
+            const int64 begin = items.size() * i / leafCount;
+            const int64 end   = items.size() * (i + 1) / leafCount;
+            Leaf*       leaf  = new Leaf;
+            std::uninitialized_move_n(items.data() + begin, end - begin, leaf->items.get());
+            leaf->count    = int(end - begin);
+            leaf->previous = previous;
+            if (previous) {
+                previous->next = leaf;
+            } else {
+                mFirst = leaf;
+            }
+            previous = leaf;
+            level.pushBack(LevelNode {leaf, &leaf->items.get()[0].first});
+        }
+        while (level.size() > 1) {
+            Array<LevelNode> parents;
+            const int64      parentCount = (level.size() + INNER_CAPACITY) / (INNER_CAPACITY + 1);
+            for (const int64 i : range(parentCount)) {
+                const int64 begin = level.size() * i / parentCount;
+                const int64 end   = level.size() * (i + 1) / parentCount;
+                Inner*      inner = new Inner;
+                for (int64 j = begin; j < end; ++j) {
+                    if (j > begin) {
+                        std::construct_at(inner->keys.get() + inner->count, *level[j].firstKey);
+                        ++inner->count;
+                    }
+                    inner->children[j - begin] = level[j].node;
+                }
+                parents.pushBack(LevelNode {inner, level[begin].firstKey});
+            }
+            level = std::move(parents);
+        }
+        mRoot = level[0].node;
+        mSize = items.size();
+    }
+
+    static void deleteNode(Node* node) {
+        if (node->isLeaf) {
+            delete static_cast<Leaf*>(node);
+        } else {
+            delete static_cast<Inner*>(node);
+        }
+    }
+
+    static void destroy(Node* node) {
+        if (!node) {
+            return;
+        }
+        if (!node->isLeaf) {
+            Inner* inner = static_cast<Inner*>(node);
+            for (const int i : range(inner->count + 1)) {
+                destroy(inner->children[i]);
+            }
+        }
+        deleteNode(node);
+    }
+};
+
+BUFF_NAMESPACE_END
@@ -0,0 +1,127 @@
+#include "Lib/containers/BitArray.h"
+#include "Lib/Bootstrap.Test.h"
+#include "Lib/Json.h"
+#include "Lib/Random.h"
+
+BUFF_NAMESPACE_BEGIN
+
+TEST_CASE("BitArray simple") {
+    BitArray bits(130);
+    CHECK(bits.size() == 130);
+    CHECK(!bits.anySet());
+    bits.set(0);
+    bits.set(64);
+    bits.set(129);
+    CHECK(bits[0]);
+    CHECK(!bits[1]);
+    CHECK(bits[64]);
+    CHECK(bits[129]);
+    CHECK(bits.countSet() == 3);
+    bits.flip(64);
+    CHECK(!bits[64]);
+    CHECK(!bits.testAndSet(5));
+    CHECK(bits.testAndSet(5));
+    bits.reset(5);
+    CHECK(bits.countSet() == 2);
+
+    bits.fill(true);
+    CHECK(bits.allSet());
+    CHECK(bits.countSet() == 130);
+    bits.resize(200);
+    CHECK(bits.countSet() == 130);
+    bits.resize(70, true);
+    CHECK(bits.countSet() == 70);
+    bits.invert();
+    CHECK(!bits.anySet());
+}
+
+TEST_CASE("BitArray setRange") {
+    BitArray bits(300);
+    bits.setRange(3, 200, true);
+    CHECK(bits.countSet() == 200);
+    CHECK(!bits[2]);
+    CHECK(bits[3]);
+    CHECK(bits[202]);
+    CHECK(!bits[203]);
+    bits.setRange(64, 64, false);
+    CHECK(bits.countSet() == 136);
+    CHECK(bits.findNextUnset(3) == 64);
+    CHECK(bits.findNextSet(64) == 128);
+}
+
+TEST_CASE("BitArray bulk operations") {
+    RandomNumberGenerator rng;
+    BitArray              a(1000);
+    BitArray              b(1000);
+    Array<bool>           refA(1000, false);
+    Array<bool>           refB(1000, false);
+    for (const int i : range(1000)) {
+        refA[i] = rng.getRandomInt(2) == 0;
+        refB[i] = rng.getRandomInt(2) == 0;
+        a.set(i, refA[i]);
+        b.set(i, refB[i]);
+    }
+    const BitArray andResult    = a & b;
+    const BitArray orResult     = a | b;
+    const BitArray xorResult    = a ^ b;
+    BitArray       andNotResult = a;
+    andNotResult.andNot(b);
+    for (const int i : range(1000)) {
+        CHECK(andResult[i] == (refA[i] && refB[i]));
+        CHECK(orResult[i] == (refA[i] || refB[i]));
+        CHECK(xorResult[i] == (refA[i] != refB[i]));
+        CHECK(andNotResult[i] == (refA[i] && !refB[i]));
+    }
+
+    Array<int64> visited;
+    a.forEachSet([&](const int64 index) { visited.pushBack(index); });
+    Array<int64> found;
+    for (Optional<int64> i = a.findNextSet(); i; i = a.findNextSet(*i + 1)) {
+        found.pushBack(*i);
+    }
+    CHECK(visited == found);
+    CHECK(visited.size() == a.countSet());
+    for (const int64 i : visited) {
+        CHECK(refA[i]);
+    }
+}
+
+TEST_CASE("BitArray find") {
+    BitArray bits(200);
+    CHECK(!bits.findNextSet());
+    CHECK(bits.findNextUnset() == 0);
+    bits.set(150);
+    CHECK(bits.findNextSet() == 150);
+    CHECK(bits.findNextSet(150) == 150);
+    CHECK(!bits.findNextSet(151));
+    bits.fill(true);
+    CHECK(!bits.findNextUnset());
+    CHECK(!bits.findNextSet(200));
+}
+
+TEST_CASE("BitArray serialize") {
+    BitArray sparse(100);
+    sparse.set(0);
+    sparse.set(1);
+    sparse.set(63);
+    sparse.set(99);
+    const BitArray full(130, true);
+
+    for (const BitArray& bits : {sparse, full}) {
+        JsonSerializer serializer;
+        serializer.serialize(bits, "bits");
+        JsonDeserializer deserializer(serializer.getJson(true));
+        BitArray         bits2;
+        deserializer.deserialize(bits2, "bits");
+        CHECK(bits == bits2);
+
+        BinarySerializer binarySerializer;
+        binarySerializer.serialize(bits, "bits");
+        BinaryDeserializer binaryDeserializer(binarySerializer.getState());
+        BitArray           bits3;
+        binaryDeserializer.deserialize(bits3, "bits");
+        CHECK(bits == bits3);
+    }
+}
+
+BUFF_NAMESPACE_END
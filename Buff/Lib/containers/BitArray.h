@@ -0,0 +1,275 @@
+#pragma once
+#include "Lib/containers/Array.h"
+#include "Lib/Optional.h"
+#include "Lib/Serialization.h"
+#include <bit>
+
+BUFF_NAMESPACE_BEGIN
+
+/// Dense array of bools, one bit per item. Bulk operations work on whole 64-bit words, so combining, counting
+/// and searching a large bit set is a handful of instructions per 64 items.
+///
+/// Bits past size() in the last word are always kept zero, so the bulk operations never need to mask them.
+class BitArray {
+    using Word = uint64;
+
+    static constexpr int WORD_BITS = 64;
+
+    Array<Word> mWords;
+    int64       mSize = 0;
+
+public:
+    BitArray() = default;
+
+    explicit BitArray(const int64 size, const bool initialValue = false) {
+        resize(size, initialValue);
+    }
+
+    int64 size() const {
+        return mSize;
+    }
+    bool isEmpty() const {
+        return mSize == 0;
+    }
+    bool notEmpty() const {
+        return mSize != 0;
+    }
+
+    /// New bits are set to value
+    void resize(const int64 size, const bool value = false) {
+        BUFF_ASSERT(size >= 0);
+        const int64 oldSize = mSize;
+        mWords.resize(wordCount(size));
+        mSize = size;
+        if (size > oldSize && value) {
+            setRange(oldSize, size - oldSize, true);
+        }
+        clearTail();
+    }
+
+    void clear() {
+        mWords.clear();
+        mSize = 0;
+    }
+
+    bool operator==(const BitArray& other) const {
+        return mSize == other.mSize && std::ranges::equal(mWords, other.mWords);
+    }
+
+    // =======================================================================================================
+    // Single bits
+    // =======================================================================================================
+
+    bool operator[](const int64 index) const {
+        assertValidIndex(index);
+        return (mWords[index / WORD_BITS] >> (index % WORD_BITS)) & 1;
+    }
+
+    void set(const int64 index, const bool value = true) {
+        assertValidIndex(index);
+        const Word mask = Word(1) << (index % WORD_BITS);
+        Word&      word = mWords[index / WORD_BITS];
+        word            = value ? word | mask : word & ~mask;
+    }
+    void reset(const int64 index) {
+        set(index, false);
+    }
+    void flip(const int64 index) {
+        assertValidIndex(index);
+        mWords[index / WORD_BITS] ^= Word(1) << (index % WORD_BITS);
+    }
+
+    /// Sets the bit and returns its previous value. Useful for visited flags: if (!visited.testAndSet(i)) {...}
+    bool testAndSet(const int64 index) {
+        assertValidIndex(index);
+        const Word mask = Word(1) << (index % WORD_BITS);
+        Word&      word = mWords[index / WORD_BITS];
+        const bool old  = word & mask;
+        word |= mask;
+        return old;
+    }
+
+    // =======================================================================================================
+    // Bulk operations
+    // =======================================================================================================
+
+    void fill(const bool value) {
+        std::ranges::fill(mWords, value ? ~Word(0) : 0);
+        clearTail();
+    }
+
+    /// Sets count bits starting at start to value
+    void setRange(const int64 start, const int64 count, const bool value) {
+        BUFF_ASSERT(start >= 0 && count >= 0 && start + count <= mSize);
+        const int64 end = start + count;
+        for (int64 i = start; i < end;) {
+            const int  bit  = int(i % WORD_BITS);
+            const int  bits = int(std::min<int64>(WORD_BITS - bit, end - i));
+            const Word mask = (bits == WORD_BITS ? ~Word(0) : (Word(1) << bits) - 1) << bit;
+            Word&      word = mWords[i / WORD_BITS];
+            word            = value ? word | mask : word & ~mask;
+            i += bits;
+        }
+    }
+
+    BitArray& operator&=(const BitArray& other) {
+        return combine(other, [](const Word a, const Word b) { return a & b; });
+    }
+    BitArray& operator|=(const BitArray& other) {
+        return combine(other, [](const Word a, const Word b) { return a | b; });
+    }
+    BitArray& operator^=(const BitArray& other) {
+        return combine(other, [](const Word a, const Word b) { return a ^ b; });
+    }
+    /// Clears all bits which are set in other
+    BitArray& andNot(const BitArray& other) {
+        return combine(other, [](const Word a, const Word b) { return a & ~b; });
+    }
+    /// Flips all bits
+    void invert() {
+        for (Word& word : mWords) {
+            word = ~word;
+        }
+        clearTail();
+    }
+
+    friend BitArray operator&(BitArray a, const BitArray& b) {
+        return a &= b;
+    }
+    friend BitArray operator|(BitArray a, const BitArray& b) {
+        return a |= b;
+    }
+    friend BitArray operator^(BitArray a, const BitArray& b) {
+        return a ^= b;
+    }
+
+    // =======================================================================================================
+    // Queries
+    // =======================================================================================================
+
+    /// Number of set bits
+    int64 countSet() const {
+        int64 result = 0;
+        for (const Word word : mWords) {
+            result += std::popcount(word);
+        }
+        return result;
+    }
+
+    bool anySet() const {
+        return std::ranges::any_of(mWords, [](const Word word) { return word != 0; });
+    }
+    bool allSet() const {
+        return countSet() == mSize;
+    }
+
+    /// Index of the first set bit at or after start. Skips whole zero words, so iterating sparse bit sets is
+    /// cheap.
+    Optional<int64> findNextSet(const int64 start = 0) const {
+        BUFF_ASSERT(start >= 0);
+        if (start >= mSize) {
+            return NULL_OPTIONAL;
+        }
+        int64 wordIndex = start / WORD_BITS;
+        Word  word      = mWords[wordIndex] & (~Word(0) << (start % WORD_BITS));
+        while (word == 0) {
+            if (++wordIndex == mWords.size()) {
+                return NULL_OPTIONAL;
+            }
+            word = mWords[wordIndex];
+        }
+        return wordIndex * WORD_BITS + std::countr_zero(word);
+    }
+
+    /// Index of the first unset bit at or after start
+    Optional<int64> findNextUnset(const int64 start = 0) const {
+        BUFF_ASSERT(start >= 0);
+        if (start >= mSize) {
+            return NULL_OPTIONAL;
+        }
+        int64 wordIndex = start / WORD_BITS;
+        Word  word      = ~mWords[wordIndex] & (~Word(0) << (start % WORD_BITS));
+        while (word == 0) {
+            if (++wordIndex == mWords.size()) {
+                return NULL_OPTIONAL;
+            }
+            word = ~mWords[wordIndex];
+        }
+        const int64 result = wordIndex * WORD_BITS + std::countr_zero(word);
+        if (result >= mSize) {
+            return NULL_OPTIONAL; // Zeroed tail of the last word
+        }
+        return result;
+    }
+
+    /// Calls functor(int64 index) for each set bit, in increasing order
+    template <typename TFunctor>
+    void forEachSet(TFunctor&& functor) const {
+        for (const int64 wordIndex : range(mWords.size())) {
+            Word word = mWords[wordIndex];
+            while (word != 0) {
+                functor(wordIndex * WORD_BITS + std::countr_zero(word));
+                word &= word - 1;
+            }
+        }
+    }
+
+    // =======================================================================================================
+    // Misc
+    // =======================================================================================================
+
+    /// Raw storage, 64 bits per word, lowest bit first. Bits past size() are zero.
+    ArrayView<const uint64> getWords() const {
+        return mWords;
+    }
+
+    /// Words are stored as pairs of 32-bit halves, lower half first. JSON keeps numbers as doubles, which cannot
+    /// hold 64-bit words exactly.
+    void serializeCustom(ISerializer& serializer) const {
+        serializer.serialize(mSize, "size");
+        Array<uint> halves(mWords.size() * 2);
+        for (const int64 i : range(mWords.size())) {
+            halves[2 * i]     = uint(mWords[i]);
+            halves[2 * i + 1] = uint(mWords[i] >> 32);
+        }
+        serializer.serializeList(halves, "words");
+    }
+    void deserializeCustom(IDeserializer& deserializer) {
+        deserializer.deserialize(mSize, "size");
+        mWords.resize(wordCount(mSize));
+        Array<uint> halves(mWords.size() * 2);
+        deserializer.deserializeList(halves, "words");
+        for (const int64 i : range(mWords.size())) {
+            mWords[i] = Word(halves[2 * i]) | Word(halves[2 * i + 1]) << 32;
+        }
+        clearTail();
+    }
+
+private:
+    static int64 wordCount(const int64 bits) {
+        return (bits + WORD_BITS - 1) / WORD_BITS;
+    }
+
+    void clearTail() {
+        if (const int used = int(mSize % WORD_BITS)) {
+            mWords.back() &= (Word(1) << used) - 1;
+        }
+    }
+
+    template <typename TOperation>
+    BitArray& combine(const BitArray& other, TOperation&& operation) {
+        BUFF_ASSERT(mSize == other.mSize);
+        Word*       a = mWords.data();
+        const Word* b = other.mWords.data();
+        for (const int64 i : range(mWords.size())) {
+            a[i] = operation(a[i], b[i]);
+        }
+        return *this;
+    }
+
+    void assertValidIndex([[maybe_unused]] const int64 index) const {
+        BUFF_ASSERT(index >= 0 && index < mSize, index, mSize);
+    }
+};
+
+BUFF_NAMESPACE_END
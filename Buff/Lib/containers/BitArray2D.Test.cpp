@@ -0,0 +1,38 @@
+#include "Lib/containers/BitArray2D.h"
+#include "Lib/Bootstrap.Test.h"
+#include "Lib/Json.h"
+
+BUFF_NAMESPACE_BEGIN
+
+TEST_CASE("BitArray2D") {
+    BitArray2D grid(10, 7);
+    CHECK(grid.size() == Pixel(10, 7));
+    CHECK(!grid.findNextSet());
+    grid.set(Pixel(3, 2));
+    grid.setRow(5, 2, 9, true);
+    CHECK(grid(3, 2));
+    CHECK(grid[Pixel(8, 5)]);
+    CHECK(!grid[Pixel(9, 5)]);
+    CHECK(grid.countSet() == 8);
+    CHECK(grid.findNextSet() == Pixel(3, 2));
+    CHECK(grid.findNextSet(Pixel(4, 2)) == Pixel(2, 5));
+
+    Array<Pixel> pixels;
+    grid.forEachSet([&](const Pixel pixel) { pixels.pushBack(pixel); });
+    CHECK(pixels.size() == 8);
+    CHECK(pixels.back() == Pixel(8, 5));
+
+    BitArray2D mask(10, 7, true);
+    mask.reset(Pixel(3, 2));
+    grid &= mask;
+    CHECK(grid.countSet() == 7);
+
+    JsonSerializer serializer;
+    serializer.serialize(grid, "grid");
+    JsonDeserializer deserializer(serializer.getJson(true));
+    BitArray2D       grid2;
+    deserializer.deserialize(grid2, "grid");
+    CHECK(grid == grid2);
+}
+
+BUFF_NAMESPACE_END
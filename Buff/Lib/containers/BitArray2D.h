@@ -0,0 +1,157 @@
+#pragma once
+#include "Lib/containers/BitArray.h"
+#include "Lib/Pixel.h"
+#include "Lib/Serialization.h"
+
+BUFF_NAMESPACE_BEGIN
+
+/// Array2D of bools stored as a BitArray, row by row. Bulk operations work on the whole grid at once.
+class BitArray2D {
+    BitArray mImpl;
+    Pixel    mSize;
+
+public:
+    BitArray2D()
+        : mSize(0, 0) {}
+    BitArray2D(const int width, const int height, const bool initialValue = false) {
+        resize(width, height, initialValue);
+    }
+    explicit BitArray2D(const Pixel size, const bool initialValue = false) {
+        resize(size, initialValue);
+    }
+
+    /// Existing bits are not preserved in their positions when the width changes
+    void resize(const int width, const int height, const bool value = false) {
+        mSize = Pixel(width, height);
+        mImpl.resize(getPixelCount(), value);
+    }
+    void resize(const Pixel size, const bool value = false) {
+        resize(size.x, size.y, value);
+    }
+
+    int64 getPixelCount() const {
+        return mSize.x * int64(mSize.y);
+    }
+
+    Pixel size() const {
+        return mSize;
+    }
+
+    bool operator==(const BitArray2D& other) const = default;
+
+    // =======================================================================================================
+    // Single bits
+    // =======================================================================================================
+
+    bool operator()(const int x, const int y) const {
+        return mImpl[map(x, y)];
+    }
+    bool operator[](const Pixel& pos) const {
+        return mImpl[map(pos.x, pos.y)];
+    }
+
+    void set(const Pixel& pos, const bool value = true) {
+        mImpl.set(map(pos.x, pos.y), value);
+    }
+    void reset(const Pixel& pos) {
+        mImpl.reset(map(pos.x, pos.y));
+    }
+    void flip(const Pixel& pos) {
+        mImpl.flip(map(pos.x, pos.y));
+    }
+    /// Sets the bit and returns its previous value
+    bool testAndSet(const Pixel& pos) {
+        return mImpl.testAndSet(map(pos.x, pos.y));
+    }
+
+    // =======================================================================================================
+    // Bulk operations
+    // =======================================================================================================
+
+    void fill(const bool value) {
+        mImpl.fill(value);
+    }
+
+    /// Sets a whole row span [fromX, toX) of row y at once
+    void setRow(const int y, const int fromX, const int toX, const bool value) {
+        BUFF_ASSERT(fromX <= toX);
+        if (fromX < toX) {
+            mImpl.setRange(map(fromX, y), toX - fromX, value);
+        }
+    }
+
+    BitArray2D& operator&=(const BitArray2D& other) {
+        BUFF_ASSERT(mSize == other.mSize);
+        mImpl &= other.mImpl;
+        return *this;
+    }
+    BitArray2D& operator|=(const BitArray2D& other) {
+        BUFF_ASSERT(mSize == other.mSize);
+        mImpl |= other.mImpl;
+        return *this;
+    }
+    BitArray2D& operator^=(const BitArray2D& other) {
+        BUFF_ASSERT(mSize == other.mSize);
+        mImpl ^= other.mImpl;
+        return *this;
+    }
+    BitArray2D& andNot(const BitArray2D& other) {
+        BUFF_ASSERT(mSize == other.mSize);
+        mImpl.andNot(other.mImpl);
+        return *this;
+    }
+    void invert() {
+        mImpl.invert();
+    }
+
+    // =======================================================================================================
+    // Queries
+    // =======================================================================================================
+
+    int64 countSet() const {
+        return mImpl.countSet();
+    }
+    bool anySet() const {
+        return mImpl.anySet();
+    }
+
+    /// First set pixel at or after start in row-major order
+    Optional<Pixel> findNextSet(const Pixel start = Pixel(0, 0)) const {
+        if (const Optional<int64> index = mImpl.findNextSet(start.x + start.y * int64(mSize.x))) {
+            return unmap(*index);
+        }
+        return NULL_OPTIONAL;
+    }
+
+    /// Calls functor(Pixel) for each set pixel in row-major order
+    template <typename TFunctor>
+    void forEachSet(TFunctor&& functor) const {
+        mImpl.forEachSet([&](const int64 index) { functor(unmap(index)); });
+    }
+
+    /// Row-major bits
+    const BitArray& getBits() const {
+        return mImpl;
+    }
+
+    void serializeCustom(ISerializer& serializer) const {
+        serializer.serialize(mSize, "size");
+        serializer.serialize(mImpl, "data");
+    }
+    void deserializeCustom(IDeserializer& deserializer) {
+        deserializer.deserialize(mSize, "size");
+        deserializer.deserialize(mImpl, "data");
+        BUFF_ASSERT(mImpl.size() == getPixelCount());
+    }
+
+private:
+    int64 map(const int x, const int y) const {
+        BUFF_ASSERT(x >= 0 && y >= 0 && x < mSize.x && y < mSize.y);
+        return x + y * int64(mSize.x);
+    }
+    Pixel unmap(const int64 index) const {
+        return Pixel(int(index % mSize.x), int(index / mSize.x));
+    }
+};
+
+BUFF_NAMESPACE_END
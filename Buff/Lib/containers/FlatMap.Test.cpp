@@ -0,0 +1,100 @@
+#include "Lib/containers/FlatMap.h"
+#include "Lib/Bootstrap.Test.h"
+#include "Lib/Json.h"
+#include "Lib/Pixel.h"
+
+BUFF_NAMESPACE_BEGIN
+
+struct NoncopyableMovableFlatMapKey : NoncopyableMovable {
+    int  value;
+    bool operator<(const NoncopyableMovableFlatMapKey& other) const {
+        return value < other.value;
+    }
+};
+
+// Test compilation:
+template class FlatMap<int, int>;
+template class FlatMap<float, String>;
+template class FlatMap<String, String>;
+template class FlatMap<String*, int>;
+template class FlatMap<NoncopyableMovableFlatMapKey, int>;
+template class FlatMap<int, NoncopyableMovable>;
+
+struct CountedFlatMapKey : NoncopyableMovable {
+    inline static int sCount = 0;
+    int               value;
+    CountedFlatMapKey(const int value)
+        : value(value) {
+        ++sCount;
+    }
+    auto operator<=>(const CountedFlatMapKey& other) const {
+        return value <=> other.value;
+    }
+    auto operator<=>(const int v) const {
+        return value <=> v;
+    }
+};
+
+TEST_CASE("FlatMap heterogeneous lookup") {
+    FlatMap<CountedFlatMapKey, int> map;
+    CHECK(CountedFlatMapKey::sCount == 0);
+    map.insert(CountedFlatMapKey(10), 100);
+    CHECK(CountedFlatMapKey::sCount == 1);
+    map[20] = 200;
+    CHECK(CountedFlatMapKey::sCount == 2);
+
+    CHECK(map.contains(10));
+    CHECK(!map.contains(30));
+    CHECK(CountedFlatMapKey::sCount == 2);
+
+    CHECK(*map.find(20) == 200);
+    CHECK(CountedFlatMapKey::sCount == 2);
+    CHECK(*map.find(10) == 100);
+    CHECK(CountedFlatMapKey::sCount == 2);
+
+    map.erase(10);
+    map.erase(20);
+    CHECK(map.isEmpty());
+    CHECK(CountedFlatMapKey::sCount == 2);
+}
+
+TEST_CASE("FlatMap bulk construction") {
+    FlatMap<int, String> map(Array<std::pair<int, String>> {{5, "five"}, {1, "one"}, {3, "three"}, {1, "uno"}});
+    CHECK(map.size() == 3);
+    CHECK(*map.find(1) == "one");
+    map.insertRange(Array<std::pair<int, String>> {{4, "four"}, {3, "tres"}, {0, "zero"}});
+    CHECK(map.size() == 5);
+    CHECK(*map.find(3) == "three");
+    Array<int> keys;
+    for (auto& [key, value] : map) {
+        keys.pushBack(key);
+    }
+    CHECK(keys == Array<int> {0, 1, 3, 4, 5});
+    map[2] = "two";
+    CHECK(map.begin()[2].second == "two");
+}
+
+TEST_CASE("FlatMap serialize") {
+    FlatMap<String, Pixel> map; // Try non-trivial type and compound type
+    map["cde"] = Pixel(3, 4);
+    map["abc"] = Pixel(1, 2);
+
+    JsonSerializer serializer;
+    serializer.serialize(map, "map");
+    const String state = serializer.getJson(true);
+    CHECK(parseJson(state));
+
+    JsonDeserializer       deserializer(state);
+    FlatMap<String, Pixel> map2;
+    deserializer.deserialize(map2, "map");
+    CHECK(map == map2);
+
+    // Interchangeable with Map
+    JsonDeserializer   deserializer2(state);
+    Map<String, Pixel> map3;
+    deserializer2.deserialize(map3, "map");
+    CHECK(map3.size() == 2);
+    CHECK(*map3.find("abc") == Pixel(1, 2));
+}
+
+BUFF_NAMESPACE_END
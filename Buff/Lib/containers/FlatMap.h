@@ -0,0 +1,212 @@
+#pragma once
+#include "Lib/Bootstrap.h"
+#include "Lib/containers/Array.h"
+#include "Lib/containers/Map.h"
+#include "Lib/Serialization.h"
+
+BUFF_NAMESPACE_BEGIN
+
+/// Drop-in replacement of Map storing the items in a sorted Array. Lookups are binary searches over contiguous
+/// memory and there is no allocation per item, but insertion and erasure move the items after the position,
+/// so it is best suited for small or mostly-read tables, ideally constructed in bulk.
+///
+/// Unlike Map, pointers to values are invalidated by insertion and erasure. Keys must not be modified through
+/// the iterators.
+template <LessThanComparable TKey, typename TValue>
+class FlatMap {
+public:
+    using Key   = TKey;
+    using Value = TValue;
+    using Item  = std::pair<TKey, TValue>;
+
+private:
+    Array<Item> mItems; // Sorted by key, each key only once
+
+    struct SerializedItem {
+        TKey   key;
+        TValue value;
+        void   enumerateStructMembers(auto&& functor) {
+            functor(key, "key");
+            functor(value, "value");
+        }
+    };
+
+public:
+    FlatMap()                                    = default;
+    FlatMap(const FlatMap& other)                = default;
+    FlatMap(FlatMap&& other) noexcept            = default;
+    FlatMap& operator=(const FlatMap& other)     = default;
+    FlatMap& operator=(FlatMap&& other) noexcept = default;
+
+    /// The container does not need to be sorted. If a key is present multiple times, its first occurrence
+    /// is used, same as in Map.
+    template <IterableContainer TContainer>
+    explicit FlatMap(TContainer&& container)
+        requires Detail::MapItemConstructible<decltype(*std::begin(container)), FlatMap> {
+        insertRange(std::forward<TContainer>(container));
+    }
+
+    /// Same format as Map, the two can be used interchangeably
+    void serializeCustom(ISerializer& serializer) const requires Serializable<TKey> && Serializable<TValue> {
+        Array<SerializedItem> flat;
+        flat.reserve(size());
+        for (auto&& [key, value] : mItems) {
+            flat.emplaceBack(key, value);
+        }
+        serializer.serialize(size(), "size");
+        serializer.serializeList(flat, "items");
+    }
+    void deserializeCustom(IDeserializer& deserializer)
+        requires std::copyable<TKey> && std::copyable<TValue> && Deserializable<TKey> &&
+                 Deserializable<TValue> {
+        int64 newSize;
+        deserializer.deserialize(newSize, "size");
+        Array<SerializedItem> flat(newSize);
+        deserializer.deserializeList(flat, "items");
+        mItems.clear();
+        mItems.reserve(newSize);
+        for (auto&& [key, value] : flat) {
+            mItems.emplaceBack(std::move(key), std::move(value));
+        }
+        sortAndMerge(0);
+    }
+
+    bool operator==(const FlatMap& other) const requires EqualsComparable<TKey> && EqualsComparable<TValue>;
+
+    // =======================================================================================================
+    // Iterators
+    // =======================================================================================================
+
+    auto begin() const {
+        return mItems.begin();
+    }
+    auto end() const {
+        return mItems.end();
+    }
+    auto begin() {
+        return mItems.begin();
+    }
+    auto end() {
+        return mItems.end();
+    }
+
+    // =======================================================================================================
+    // Queries
+    // =======================================================================================================
+
+    bool isEmpty() const {
+        return mItems.isEmpty();
+    }
+    bool notEmpty() const {
+        return mItems.notEmpty();
+    }
+
+    int64 size() const {
+        return mItems.size();
+    }
+
+    template <typename T2>
+    bool contains(T2&& key) const requires LessThanComparable<T2, TKey> {
+        return findIndex(key) >= 0;
+    }
+
+    template <typename T2>
+    const TValue* find(T2&& key) const requires LessThanComparable<T2, TKey> {
+        const int64 index = findIndex(key);
+        return index >= 0 ? &mItems[index].second : nullptr;
+    }
+    template <typename T2>
+    TValue* find(T2&& key) requires LessThanComparable<T2, TKey> {
+        const int64 index = findIndex(key);
+        return index >= 0 ? &mItems[index].second : nullptr;
+    }
+
+    /// Creates an element if the key is not already present!
+    template <typename T2>
+    TValue& operator[](T2&& key)
+        requires LessThanComparable<T2, TKey> && std::is_default_constructible_v<TValue> {
+        const int64 index = lowerBound(key);
+        if (index == size() || key < mItems[index].first) {
+            mItems.insert(index, Item(TKey(std::forward<T2>(key)), TValue()));
+        }
+        return mItems[index].second;
+    }
+
+    // =======================================================================================================
+    // Modification
+    // =======================================================================================================
+
+    void reserve(const int64 count) {
+        mItems.reserve(count);
+    }
+
+    /// Sorts only the new items and merges them with the existing ones, so inserting a large range at once is
+    /// much faster than inserting the items one by one. Keys already present in the map are skipped.
+    template <IterableContainer T>
+    void insertRange(T&& range) requires Detail::MapItemConstructible<decltype(*std::begin(range)), FlatMap> {
+        const int64 oldSize = size();
+        for (auto&& item : range) {
+            if constexpr (std::is_rvalue_reference_v<T&&>) {
+                mItems.emplaceBack(std::move(item.first), std::move(item.second));
+            } else {
+                mItems.emplaceBack(item.first, item.second);
+            }
+        }
+        sortAndMerge(oldSize);
+    }
+
+    void insert(TKey key, TValue value) {
+        BUFF_ASSERT(!contains(key));
+        const int64 index = lowerBound(key);
+        mItems.insert(index, Item(std::move(key), std::move(value)));
+    }
+
+    void clear() {
+        mItems.clear();
+    }
+
+    template <typename T2>
+    void erase(T2&& key) requires LessThanComparable<T2, TKey> {
+        const int64 index = findIndex(key);
+        BUFF_ASSERT(index >= 0);
+        mItems.eraseByIndex(index);
+    }
+
+private:
+    template <typename T2>
+    int64 lowerBound(const T2& key) const {
+        const Item* begin = mItems.data();
+        return std::lower_bound(begin,
+                                begin + mItems.size(),
+                                key,
+                                [](const Item& item, const T2& value) { return item.first < value; }) -
+               begin;
+    }
+
+    template <typename T2>
+    int64 findIndex(const T2& key) const {
+        const int64 index = lowerBound(key);
+        return index < size() && !(key < mItems[index].first) ? index : -1;
+    }
+
+    /// Items before firstUnsorted are sorted and unique, the rest is arbitrary
+    void sortAndMerge(const int64 firstUnsorted) {
+        Item*      begin  = mItems.data();
+        Item*      middle = begin + firstUnsorted;
+        Item*      end    = begin + mItems.size();
+        const auto less   = [](const Item& a, const Item& b) { return a.first < b.first; };
+        // Stable sort and merge keep the first occurrence of each key in front of the others
+        std::stable_sort(middle, end, less);
+        std::inplace_merge(begin, middle, end, less);
+        Item* newEnd = std::unique(begin, end, [](const Item& a, const Item& b) { return !(a.first < b.first); });
+        mItems.eraseRange(newEnd - begin, end - newEnd);
+    }
+};
+
+// Needs to be out of class so FlatMap compiles with not yet defined types
+template <LessThanComparable TKey, typename TValue>
+bool FlatMap<TKey, TValue>::operator==(const FlatMap& other) const
+    requires EqualsComparable<TKey> && EqualsComparable<TValue>
+    = default;
+
+BUFF_NAMESPACE_END
@@ -0,0 +1,31 @@
+#include "Lib/containers/FlatSet.h"
+#include "Lib/Bootstrap.Test.h"
+
+BUFF_NAMESPACE_BEGIN
+
+struct NoncopyableMovableFlatSetKey : NoncopyableMovable {
+    int  value;
+    bool operator<(const NoncopyableMovableFlatSetKey& other) const {
+        return value < other.value;
+    }
+};
+
+// Test compilation:
+template class FlatSet<int>;
+template class FlatSet<float>;
+template class FlatSet<String>;
+template class FlatSet<String*>;
+template class FlatSet<NoncopyableMovableFlatSetKey>;
+
+TEST_CASE("FlatSet") {
+    FlatSet<String> set(Array<String> {"b", "c", "a", "b"});
+    CHECK(set.size() == 3);
+    CHECK(set.contains("a"));
+    CHECK(!set.contains("d"));
+    CHECK(set.insert("d"));
+    CHECK(!set.insert("a"));
+    set.erase("b");
+    CHECK(Array<String>(set) == Array<String> {"a", "c", "d"});
+}
+
+BUFF_NAMESPACE_END
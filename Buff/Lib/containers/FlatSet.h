@@ -0,0 +1,123 @@
+#pragma once
+#include "Lib/Bootstrap.h"
+#include "Lib/Concepts.h"
+#include "Lib/containers/Array.h"
+#include "Lib/Serialization.h"
+
+BUFF_NAMESPACE_BEGIN
+
+/// Drop-in replacement of Set storing the items in a sorted Array. See FlatMap for the trade-offs.
+template <LessThanComparable T>
+class FlatSet {
+    Array<T> mItems; // Sorted, unique
+
+public:
+    FlatSet()                                    = default;
+    FlatSet(const FlatSet& other)                = default;
+    FlatSet(FlatSet&& other) noexcept            = default;
+    FlatSet& operator=(const FlatSet& other)     = default;
+    FlatSet& operator=(FlatSet&& other) noexcept = default;
+
+    /// The container does not need to be sorted, duplicates are removed
+    template <IterableContainer TContainer>
+    explicit FlatSet(TContainer&& container)
+        requires ConstructibleFrom<T, decltype(*std::begin(container))> {
+        insertRange(std::forward<TContainer>(container));
+    }
+
+    template <typename T2>
+    bool contains(T2&& key) const requires LessThanComparable<T, T2> {
+        const int64 index = lowerBound(key);
+        return index < size() && !(key < mItems[index]);
+    }
+
+    bool insert(const T& other) requires std::copyable<T> {
+        const int64 index = lowerBound(other);
+        if (index < size() && !(other < mItems[index])) {
+            return false;
+        }
+        mItems.insert(index, other);
+        return true;
+    }
+
+    bool insert(T&& other) {
+        const int64 index = lowerBound(other);
+        if (index < size() && !(other < mItems[index])) {
+            return false;
+        }
+        mItems.insert(index, std::move(other));
+        return true;
+    }
+
+    /// Sorts only the new items and merges them with the existing ones
+    template <IterableContainer TContainer>
+    void insertRange(TContainer&& container) requires ConstructibleFrom<T, decltype(*std::begin(container))> {
+        const int64 oldSize = size();
+        for (auto&& item : container) {
+            if constexpr (std::is_rvalue_reference_v<TContainer&&>) {
+                mItems.emplaceBack(std::move(item));
+            } else {
+                mItems.emplaceBack(item);
+            }
+        }
+        T* begin  = mItems.data();
+        T* middle = begin + oldSize;
+        T* end    = begin + mItems.size();
+        std::stable_sort(middle, end, std::less<> {});
+        std::inplace_merge(begin, middle, end, std::less<> {});
+        T* newEnd = std::unique(begin, end, [](const T& a, const T& b) { return !(a < b); });
+        mItems.eraseRange(newEnd - begin, end - newEnd);
+    }
+
+    template <typename T2>
+    void erase(T2&& key) requires LessThanComparable<T, T2> {
+        const int64 index = lowerBound(key);
+        BUFF_ASSERT(index < size() && !(key < mItems[index]));
+        mItems.eraseByIndex(index);
+    }
+
+    /// Elements cannot be modified, that could break the ordering
+    auto begin() const {
+        return mItems.begin();
+    }
+    auto end() const {
+        return mItems.end();
+    }
+
+    void clear() {
+        mItems.clear();
+    }
+
+    void reserve(const int64 count) {
+        mItems.reserve(count);
+    }
+
+    int64 size() const {
+        return mItems.size();
+    }
+    bool isEmpty() const {
+        return mItems.isEmpty();
+    }
+
+    void serializeCustom(ISerializer& serializer) const requires Serializable<T> {
+        serializer.serialize(size(), "size");
+        serializer.serializeList(mItems, "items");
+    }
+    void deserializeCustom(IDeserializer& deserializer) requires Deserializable<T> {
+        int64 newSize;
+        deserializer.deserialize(newSize, "size");
+        Array<T> flat(newSize);
+        deserializer.deserializeList(flat, "items");
+        mItems.clear();
+        insertRange(std::move(flat));
+    }
+
+private:
+    template <typename T2>
+    int64 lowerBound(const T2& key) const {
+        const T* begin = mItems.data();
+        return std::lower_bound(begin, begin + mItems.size(), key, std::less<> {}) - begin;
+    }
+};
+
+BUFF_NAMESPACE_END
@@ -1,5 +1,12 @@
 #include "Lib/containers/HashMap.h"
+#include "Lib/Arena.h"
 #include "Lib/Bootstrap.Test.h"
+#include "Lib/Json.h"
+#include "Lib/Pixel.h"
+#include "Lib/Random.h"
+#include "Lib/Time.h"
+#include <iostream>
+#include <unordered_map>
 
 BUFF_NAMESPACE_BEGIN
 
@@ -23,6 +30,7 @@ template class HashMap<String, String>;
 template class HashMap<String*, int>;
 template class HashMap<NoncopyableMovableHashable, int>;
 template class HashMap<int, NoncopyableMovable>;
+template class HashMap<int, int, ArenaAllocator<std::pair<int, int>>>;
 
 struct CountedKey : NoncopyableMovable {
     inline static int sCount = 0;
@@ -145,4 +153,148 @@ TEST_CASE("HashMap CachedKey") {
 //     CHECK(CountedKey::sCount == 2);
 // }
 
+TEST_CASE("HashMap random operations") {
+    HashMap<int64, int64>            map;
+    std::unordered_map<int64, int64> reference;
+    RandomNumberGenerator            rng;
+    for (const int i : range(100'000)) {
+        const int64 key = rng.getRandomInt(5'000);
+        switch (rng.getRandomInt(3)) {
+        case 0:
+            map[key] = i;
+            reference[key] = i;
+            break;
+        case 1:
+            if (reference.erase(key)) {
+                map.erase(key);
+            } else {
+                CHECK(!map.contains(key));
+            }
+            break;
+        default:
+            if (auto it = reference.find(key); it != reference.end()) {
+                REQUIRE(map.find(key));
+                CHECK(*map.find(key) == it->second);
+            } else {
+                CHECK(!map.find(key));
+            }
+        }
+        CHECK(map.size() == int64(reference.size()));
+    }
+    int64 count = 0;
+    for (auto& [key, value] : map) {
+        CHECK(reference.at(key) == value);
+        ++count;
+    }
+    CHECK(count == map.size());
+    map.clear();
+    CHECK(map.isEmpty());
+    CHECK(map.begin() == map.end());
+    CHECK(!map.contains(0));
+}
+
+TEST_CASE("HashMap copy") {
+    HashMap<String, String> map;
+    for (const int i : range(100)) {
+        map[toStr(i)] = toStr(i * 2);
+    }
+    for (const int i : range(100)) {
+        if (i % 3 == 0) {
+            map.erase(toStr(i));
+        }
+    }
+    HashMap<String, String> copy = map;
+    CHECK(copy.size() == map.size());
+    for (const int i : range(100)) {
+        CHECK(copy.contains(toStr(i)) == (i % 3 != 0));
+    }
+    copy = HashMap<String, String>();
+    CHECK(copy.isEmpty());
+    copy = map;
+    CHECK(*copy.find("1") == "2");
+}
+
+TEST_CASE("HashMap reserve") {
+    HashMap<int, int> map;
+    map.reserve(1000);
+    const int64 capacity = map.getCapacity();
+    CHECK(capacity >= 1000);
+    for (const int i : range(1000)) {
+        map.insert(i, i);
+    }
+    CHECK(map.getCapacity() == capacity);
+}
+
+TEST_CASE("HashMap insertRange") {
+    HashMap<int, String> map;
+    map[1] = "one";
+    map.insertRange(Array<std::pair<int, String>> {{1, "uno"}, {2, "two"}});
+    CHECK(map.size() == 2);
+    CHECK(*map.find(1) == "one");
+    CHECK(*map.find(2) == "two");
+}
+
+TEST_CASE("HashMap arena") {
+    Arena                                                   arena;
+    HashMap<int, int, ArenaAllocator<std::pair<int, int>>> map(arena);
+    for (const int i : range(1000)) {
+        map[i] = i * 10;
+    }
+    CHECK(map.size() == 1000);
+    CHECK(*map.find(999) == 9990);
+    CHECK(arena.getUsedBytes() > 1000 * int64(sizeof(std::pair<int, int>)));
+}
+
+TEST_CASE("HashMap serialize") {
+    HashMap<String, Pixel> map; // Try non-trivial type and compound type
+    map["abc"] = Pixel(1, 2);
+    map["cde"] = Pixel(3, 4);
+
+    JsonSerializer serializer;
+    serializer.serialize(map, "map");
+    const String state = serializer.getJson(true);
+    CHECK(parseJson(state));
+
+    JsonDeserializer       deserializer(state);
+    HashMap<String, Pixel> map2;
+    deserializer.deserialize(map2, "map");
+    CHECK(map2.size() == 2);
+    CHECK(*map2.find("abc") == Pixel(1, 2));
+    CHECK(*map2.find("cde") == Pixel(3, 4));
+}
+
+template <typename TMap>
+static void benchmarkHashMap(const char* name, const int64 count) {
+    RandomNumberGenerator rng;
+    Array<int64>          keys(count);
+    for (auto& key : keys) {
+        key = int64(rng());
+    }
+    TMap        map;
+    const Timer timer;
+    for (const int64 key : keys) {
+        map[key] = key;
+    }
+    const Duration insertTime = timer.getElapsed();
+    int64          found      = 0;
+    for (const int64 key : keys) {
+        found += map.contains(key);
+    }
+    for (const int64 key : keys) {
+        found += map.contains(key + 1);
+    }
+    CHECK(found >= count);
+    Duration lookupTime = timer.getElapsed();
+    lookupTime -= insertTime;
+    std::cout << name << " " << count << " items: insert " << insertTime.getUserReadable()
+              << ", lookup (hit + miss) " << lookupTime.getUserReadable() << std::endl;
+}
+
+TEST_CASE("HashMap benchmark" * doctest::skip()) {
+    for (const int64 count : {1'000, 1'000'000, 100'000'000}) {
+        benchmarkHashMap<HashMap<int64, int64>>("HashMap", count);
+        benchmarkHashMap<std::unordered_map<int64, int64>>("std::unordered_map", count);
+    }
+}
+
 BUFF_NAMESPACE_END
@@ -1,27 +1,19 @@
 #pragma once
 #include "Lib/Bootstrap.h"
 #include "Lib/containers/Array.h"
-#include <robin_hood.h>
+#include "Lib/Hash.h"
+#include "Lib/Serialization.h"
+#include "Lib/Simd.h"
+#include <memory>
 
 BUFF_NAMESPACE_BEGIN
 
 namespace Detail {
-template <typename T>
-concept HasGetHashFunction = requires(const T& a) {
-    { a.getHash() } -> std::convertible_to<size_t>;
-};
-template <typename T>
-concept HasStdHashOverload = requires(const T& a) {
-    { std::hash<T> {}(a) } -> std::convertible_to<size_t>;
-};
+/// Uses hashValue, so built-in types and strings hash the same on all platforms
 struct MyHash {
-    template <HasGetHashFunction T>
-    size_t operator()(const T& x) const {
-        return x.getHash();
-    }
-    template <HasStdHashOverload T>
+    template <ValueHashable T>
     size_t operator()(const T& x) const {
-        return std::hash<T> {}(x);
+        return size_t(hashValue(x));
     }
 };
 struct MyEquals {
@@ -36,9 +28,20 @@ concept HashMapItemConstructible =
     ConstructibleFrom<typename TMap::Key, decltype(std::declval<T>().first)> &&
     ConstructibleFrom<typename TMap::Value, decltype(std::declval<T>().second)>;
 
+/// Values of HashMap control bytes which do not hold a part of hash. Both are negative, full slots are >= 0.
+inline constexpr int8 HASH_MAP_EMPTY   = -128;
+inline constexpr int8 HASH_MAP_DELETED = -2;
+
+/// Many hash functions (e.g. std::hash<int>) are identity, spread their bits so that both the low 7 bits
+/// stored in control bytes and the high bits selecting the group are usable.
+inline uint64 mixHash(const size_t hash) {
+    const uint64 result = uint64(hash) * 0x9E3779B97F4A7C15ull;
+    return result ^ (result >> 32);
+}
+
 } // namespace Detail
 
-// Concept for a class with std::hash defined
+// Concept for a class usable as HashMap key: hashable by hashValue and equality comparable
 template <typename T>
 concept Hashable = requires(const T& t) {
     { Detail::MyHash {}(t) } -> std::convertible_to<std::size_t>;
@@ -69,32 +72,190 @@ struct CachedHash {
     }
 };
 
-template <Hashable TKey, typename TValue>
+/// Open addressing hash map in the style of Swiss tables. Each slot has a control byte holding 7 bits of
+/// the key hash (or empty/deleted marker), and lookups compare a group of 16 control bytes at once with
+/// SIMD, so keys are only compared for probable matches. Elements are stored inline, so pointers to them
+/// are invalidated by insertions.
+/// \param TAllocator Standard library compatible allocator, e.g. ArenaAllocator
+template <Hashable TKey, typename TValue, typename TAllocator = std::allocator<std::pair<TKey, TValue>>>
 class HashMap {
-    robin_hood::unordered_flat_map<TKey, TValue, Detail::MyHash, Detail::MyEquals> mImpl;
+public:
+    using Key   = TKey;
+    using Value = TValue;
+    using Item  = std::pair<TKey, TValue>;
+
+private:
+    using AllocatorTraits  = std::allocator_traits<TAllocator>;
+    using ControlAllocator = typename AllocatorTraits::template rebind_alloc<int8>;
+
+    static constexpr int GROUP_SIZE = Simd::Bytes16::SIZE;
+
+    Item* mSlots   = nullptr;
+    int8* mControl = nullptr;
+    /// Zero or power of 2 multiple of GROUP_SIZE
+    int64 mCapacity = 0;
+    int64 mSize     = 0;
+    /// How many more items can be placed into empty (not deleted) slots before the table is rebuilt
+    int64 mGrowthLeft = 0;
+
+    TAllocator mAllocator;
+
+    struct SerializedItem {
+        TKey   key;
+        TValue value;
+        void   enumerateStructMembers(auto&& functor) {
+            functor(key, "key");
+            functor(value, "value");
+        }
+    };
+
+    template <bool TConst>
+    class IteratorImpl {
+        using ItemType = std::conditional_t<TConst, const Item, Item>;
+
+        const int8* mControl = nullptr;
+        const int8* mEnd     = nullptr;
+        ItemType*   mSlot    = nullptr;
+
+    public:
+        using value_type      = Item;
+        using difference_type = std::ptrdiff_t;
+
+        IteratorImpl() = default;
+        IteratorImpl(const int8* control, const int8* end, ItemType* slot)
+            : mControl(control)
+            , mEnd(end)
+            , mSlot(slot) {
+            skipEmpty();
+        }
+
+        ItemType& operator*() const {
+            return *mSlot;
+        }
+        ItemType* operator->() const {
+            return mSlot;
+        }
+        IteratorImpl& operator++() {
+            ++mControl;
+            ++mSlot;
+            skipEmpty();
+            return *this;
+        }
+        IteratorImpl operator++(int) {
+            IteratorImpl result = *this;
+            ++*this;
+            return result;
+        }
+        bool operator==(const IteratorImpl& other) const {
+            return mControl == other.mControl;
+        }
+
+    private:
+        void skipEmpty() {
+            while (mControl != mEnd && *mControl < 0) {
+                ++mControl;
+                ++mSlot;
+            }
+        }
+    };
 
 public:
-    HashMap()                                    = default;
-    HashMap(const HashMap& other)                = default;
-    HashMap(HashMap&& other) noexcept            = default;
-    HashMap& operator=(const HashMap& other)     = default;
-    HashMap& operator=(HashMap&& other) noexcept = default;
+    using Iterator      = IteratorImpl<false>;
+    using ConstIterator = IteratorImpl<true>;
+
+    HashMap() = default;
+
+    explicit HashMap(const TAllocator& allocator)
+        : mAllocator(allocator) {}
+
+    HashMap(const HashMap& other) requires std::copy_constructible<TKey> && std::copy_constructible<TValue>
+        : HashMap(AllocatorTraits::select_on_container_copy_construction(other.mAllocator)) {
+        // Constructor delegation makes sure the destructor cleans up if a copy throws
+        if (other.mCapacity == 0) {
+            return;
+        }
+        allocateTable(other.mCapacity);
+        // Same layout as the other map, including deleted slots, so no need to hash anything
+        for (const int64 i : range(mCapacity)) {
+            if (other.mControl[i] >= 0) {
+                AllocatorTraits::construct(mAllocator, mSlots + i, other.mSlots[i]);
+                ++mSize;
+            }
+            mControl[i] = other.mControl[i];
+        }
+        mGrowthLeft = other.mGrowthLeft;
+    }
+
+    HashMap(HashMap&& other) noexcept
+        : mSlots(std::exchange(other.mSlots, nullptr))
+        , mControl(std::exchange(other.mControl, nullptr))
+        , mCapacity(std::exchange(other.mCapacity, 0))
+        , mSize(std::exchange(other.mSize, 0))
+        , mGrowthLeft(std::exchange(other.mGrowthLeft, 0))
+        , mAllocator(other.mAllocator) {}
+
+    HashMap& operator=(const HashMap& other)
+        requires std::copy_constructible<TKey> && std::copy_constructible<TValue> {
+        if (this != &other) {
+            *this = HashMap(other);
+        }
+        return *this;
+    }
+
+    HashMap& operator=(HashMap&& other) noexcept {
+        std::swap(mSlots, other.mSlots);
+        std::swap(mControl, other.mControl);
+        std::swap(mCapacity, other.mCapacity);
+        std::swap(mSize, other.mSize);
+        std::swap(mGrowthLeft, other.mGrowthLeft);
+        std::swap(mAllocator, other.mAllocator);
+        return *this;
+    }
+
+    ~HashMap() {
+        destroyItems();
+        deallocateTable(mSlots, mControl, mCapacity);
+    }
+
+    /// Items are written in unspecified order
+    void serializeCustom(ISerializer& serializer) const requires Serializable<TKey> && Serializable<TValue> {
+        Array<SerializedItem> flat;
+        flat.reserve(size());
+        for (auto&& [key, value] : *this) {
+            flat.emplaceBack(key, value);
+        }
+        serializer.serialize(size(), "size");
+        serializer.serializeList(flat, "items");
+    }
+    void deserializeCustom(IDeserializer& deserializer)
+        requires std::copyable<TKey> && std::copyable<TValue> && Deserializable<TKey> &&
+                 Deserializable<TValue> {
+        int64 newSize;
+        deserializer.deserialize(newSize, "size");
+        Array<SerializedItem> flat(newSize);
+        deserializer.deserializeList(flat, "items");
+        clear();
+        reserve(flat.size());
+        for (auto&& [key, value] : flat) {
+            (*this)[std::move(key)] = std::move(value);
+        }
+    }
 
     // =======================================================================================================
     // Iterators
     // =======================================================================================================
 
-    auto begin() const {
-        return mImpl.cbegin();
+    ConstIterator begin() const {
+        return ConstIterator(mControl, mControl + mCapacity, mSlots);
     }
-    auto end() const {
-        return mImpl.cend();
+    ConstIterator end() const {
+        return ConstIterator(mControl + mCapacity, mControl + mCapacity, mSlots + mCapacity);
     }
-    auto begin() {
-        return mImpl.begin();
+    Iterator begin() {
+        return Iterator(mControl, mControl + mCapacity, mSlots);
     }
-    auto end() {
-        return mImpl.end();
+    Iterator end() {
+        return Iterator(mControl + mCapacity, mControl + mCapacity, mSlots + mCapacity);
     }
 
     Array<std::pair<const TKey*, const TValue*>> getAllElementsOrdered() const requires std::sortable<TKey*> {
@@ -112,73 +273,246 @@ public:
     // =======================================================================================================
 
     bool isEmpty() const {
-        return mImpl.empty();
+        return mSize == 0;
     }
     bool notEmpty() const {
-        return !mImpl.empty();
+        return mSize != 0;
     }
 
     int64 size() const {
-        return mImpl.size();
+        return mSize;
     }
 
-    template <typename T2>
-    bool contains(T2&& key) const {
-        return mImpl.contains(std::forward<T2>(key));
+    /// Number of slots currently allocated
+    int64 getCapacity() const {
+        return mCapacity;
     }
 
-    template <typename T2>
-    const TValue* find(T2&& key) const {
-        auto it = mImpl.find(std::forward<T2>(key));
-        return it != mImpl.end() ? &it->second : nullptr;
+    bool contains(const TKey& key) const {
+        return findIndex(key, Detail::MyHash {}(key)) >= 0;
     }
-    template <typename T2>
-    TValue* find(T2&& key) {
-        auto it = mImpl.find(std::forward<T2>(key));
-        return it != mImpl.end() ? &it->second : nullptr;
+
+    const TValue* find(const TKey& key) const {
+        const int64 index = findIndex(key, Detail::MyHash {}(key));
+        return index >= 0 ? &mSlots[index].second : nullptr;
+    }
+    TValue* find(const TKey& key) {
+        const int64 index = findIndex(key, Detail::MyHash {}(key));
+        return index >= 0 ? &mSlots[index].second : nullptr;
     }
 
+    const TValue* findWithCached(const CachedHash<TKey>& cached) const {
+        const int64 index = findIndex(cached, cached.getHash());
+        return index >= 0 ? &mSlots[index].second : nullptr;
+    }
     TValue* findWithCached(const CachedHash<TKey>& cached) {
-        auto it = mImpl.find(cached, robin_hood::is_transparent_tag {});
-        return it != mImpl.end() ? &it->second : nullptr;
+        const int64 index = findIndex(cached, cached.getHash());
+        return index >= 0 ? &mSlots[index].second : nullptr;
     }
 
     /// Creates an element if the key is not already present!
-    template <typename T2>
-    TValue& operator[](T2&& key) {
-        return mImpl[std::forward<T2>(key)];
+    TValue& operator[](const TKey& key)
+        requires std::copy_constructible<TKey> && std::is_default_constructible_v<TValue> {
+        return findOrInsert(key);
+    }
+    /// Creates an element if the key is not already present!
+    TValue& operator[](TKey&& key) requires std::is_default_constructible_v<TValue> {
+        return findOrInsert(std::move(key));
     }
 
     // =======================================================================================================
     // Modification
     // =======================================================================================================
 
+    /// Makes sure that count items can be stored without rebuilding the table
     void reserve(const int64 count) {
         BUFF_ASSERT(count >= 0);
-        mImpl.reserve(count);
+        int64 capacity = GROUP_SIZE;
+        while (getMaxLoad(capacity) < count) {
+            capacity *= 2;
+        }
+        if (capacity > mCapacity) {
+            rehash(capacity);
+        }
     }
 
+    /// Keys already present in the map are skipped
     template <IterableContainer T>
     void insertRange(T&& range)
         requires Detail::HashMapItemConstructible<decltype(*std::begin(range)), HashMap> {
-        mImpl.insert(range.begin(), range.end());
+        for (auto&& item : range) {
+            TKey         key(item.first);
+            const size_t hash = Detail::MyHash {}(key);
+            if (findIndex(key, hash) < 0) {
+                emplaceNew(hash, std::move(key), item.second);
+            }
+        }
     }
 
     /// Returns reference to the value stored inside the hash map
     TValue& insert(TKey key, TValue value) {
-        BUFF_ASSERT(!contains(key));
-        return mImpl.emplace(std::move(key), std::move(value)).first->second;
+        const size_t hash = Detail::MyHash {}(key);
+        BUFF_ASSERT(findIndex(key, hash) < 0);
+        return emplaceNew(hash, std::move(key), std::move(value)).second;
     }
 
+    /// Keeps the allocated memory
     void clear() {
-        mImpl.clear();
+        destroyItems();
+        if (mCapacity > 0) {
+            std::fill_n(mControl, mCapacity, Detail::HASH_MAP_EMPTY);
+        }
+        mSize       = 0;
+        mGrowthLeft = getMaxLoad(mCapacity);
+    }
+
+    void erase(const TKey& key) {
+        const int64 index = findIndex(key, Detail::MyHash {}(key));
+        BUFF_ASSERT(index >= 0);
+        AllocatorTraits::destroy(mAllocator, mSlots + index);
+        --mSize;
+        // A group with an empty slot terminates every probe sequence passing through it, so the slot can be
+        // made empty again. Otherwise later items of the sequence must remain reachable.
+        const int64 groupStart = index & ~int64(GROUP_SIZE - 1);
+        if (Simd::Bytes16::load(mControl + groupStart).equalMask(uint8(Detail::HASH_MAP_EMPTY))) {
+            mControl[index] = Detail::HASH_MAP_EMPTY;
+            ++mGrowthLeft;
+        } else {
+            mControl[index] = Detail::HASH_MAP_DELETED;
+        }
+    }
+
+private:
+    /// 7/8 of slots can be used
+    static int64 getMaxLoad(const int64 capacity) {
+        return capacity - capacity / 8;
+    }
+
+    /// Probes whole groups in a triangular sequence, which visits every group of a power of 2 table
+    int64 findIndex(const auto& key, const size_t hash) const {
+        if (mCapacity == 0) {
+            return -1;
+        }
+        const uint64 mixed     = Detail::mixHash(hash);
+        const uint8  hashBits  = uint8(mixed & 0x7F);
+        const int64  groupMask = mCapacity / GROUP_SIZE - 1;
+        int64        group     = int64(mixed >> 7) & groupMask;
+        for (int64 step = 1;; ++step) {
+            const int64         offset  = group * GROUP_SIZE;
+            const Simd::Bytes16 control = Simd::Bytes16::load(mControl + offset);
+            for (uint mask = control.equalMask(hashBits); mask != 0; mask &= mask - 1) {
+                const int64 index = offset + Simd::lowestBit(mask);
+                if (Detail::MyEquals {}(mSlots[index].first, key)) [[likely]] {
+                    return index;
+                }
+            }
+            if (control.equalMask(uint8(Detail::HASH_MAP_EMPTY)) != 0) [[likely]] {
+                return -1;
+            }
+            group = (group + step) & groupMask;
+        }
+    }
+
+    /// First empty or deleted slot in the probe sequence. There is always one, the table is never full.
+    int64 findFreeIndex(const uint64 mixed) const {
+        const int64 groupMask = mCapacity / GROUP_SIZE - 1;
+        int64       group     = int64(mixed >> 7) & groupMask;
+        for (int64 step = 1;; ++step) {
+            const int64 offset = group * GROUP_SIZE;
+            const uint  mask   = Simd::Bytes16::load(mControl + offset).highBitMask();
+            if (mask != 0) [[likely]] {
+                return offset + Simd::lowestBit(mask);
+            }
+            group = (group + step) & groupMask;
+        }
+    }
+
+    /// The key must not be present in the map
+    template <typename... TArgs>
+    Item& emplaceNew(const size_t hash, TArgs&&... args) {
+        const uint64 mixed = Detail::mixHash(hash);
+        int64        index = mCapacity > 0 ? findFreeIndex(mixed) : -1;
+        if (index < 0 || (mGrowthLeft == 0 && mControl[index] == Detail::HASH_MAP_EMPTY)) [[unlikely]] {
+            // Either grow, or just get rid of deleted slots when there are many of them
+            if (mCapacity == 0) {
+                rehash(GROUP_SIZE);
+            } else {
+                rehash(mSize * 2 < getMaxLoad(mCapacity) ? mCapacity : mCapacity * 2);
+            }
+            index = findFreeIndex(mixed);
+        }
+        AllocatorTraits::construct(mAllocator, mSlots + index, std::forward<TArgs>(args)...);
+        mGrowthLeft -= mControl[index] == Detail::HASH_MAP_EMPTY;
+        mControl[index] = int8(mixed & 0x7F);
+        ++mSize;
+        return mSlots[index];
+    }
+
+    template <typename TKeyArg>
+    TValue& findOrInsert(TKeyArg&& key) {
+        const size_t hash  = Detail::MyHash {}(key);
+        const int64  index = findIndex(key, hash);
+        if (index >= 0) {
+            return mSlots[index].second;
+        }
+        return emplaceNew(hash,
+                          std::piecewise_construct,
+                          std::forward_as_tuple(std::forward<TKeyArg>(key)),
+                          std::tuple<>())
+            .second;
     }
 
-    template <typename T2>
-    void erase(T2&& key) {
-        auto it = mImpl.find(std::forward<T2>(key));
-        BUFF_ASSERT(it != mImpl.end());
-        mImpl.erase(it);
+    void allocateTable(const int64 capacity) {
+        BUFF_ASSERT(capacity % GROUP_SIZE == 0 && std::has_single_bit(uint64(capacity)), capacity);
+        ControlAllocator controlAllocator(mAllocator);
+        mSlots = AllocatorTraits::allocate(mAllocator, capacity);
+        try {
+            mControl = std::allocator_traits<ControlAllocator>::allocate(controlAllocator, capacity);
+        } catch (...) {
+            AllocatorTraits::deallocate(mAllocator, mSlots, capacity);
+            mSlots = nullptr;
+            throw;
+        }
+        std::fill_n(mControl, capacity, Detail::HASH_MAP_EMPTY);
+        mCapacity   = capacity;
+        mGrowthLeft = getMaxLoad(capacity);
+    }
+
+    void deallocateTable(Item* slots, int8* control, const int64 capacity) {
+        if (capacity > 0) {
+            ControlAllocator controlAllocator(mAllocator);
+            std::allocator_traits<ControlAllocator>::deallocate(controlAllocator, control, capacity);
+            AllocatorTraits::deallocate(mAllocator, slots, capacity);
+        }
+    }
+
+    void destroyItems() {
+        if constexpr (!std::is_trivially_destructible_v<Item>) {
+            for (const int64 i : range(mCapacity)) {
+                if (mControl[i] >= 0) {
+                    AllocatorTraits::destroy(mAllocator, mSlots + i);
+                }
+            }
+        }
+    }
+
+    void rehash(const int64 newCapacity) {
+        Item*       oldSlots    = mSlots;
+        int8*       oldControl  = mControl;
+        const int64 oldCapacity = mCapacity;
+        allocateTable(newCapacity);
+        for (const int64 i : range(oldCapacity)) {
+            if (oldControl[i] >= 0) {
+                Item&        item  = oldSlots[i];
+                const uint64 mixed = Detail::mixHash(Detail::MyHash {}(item.first));
+                const int64  index = findFreeIndex(mixed);
+                AllocatorTraits::construct(mAllocator, mSlots + index, std::move(item));
+                AllocatorTraits::destroy(mAllocator, &item);
+                mControl[index] = int8(mixed & 0x7F);
+            }
+        }
+        mGrowthLeft -= mSize;
+        deallocateTable(oldSlots, oldControl, oldCapacity);
     }
 };
 
@@ -2,6 +2,7 @@
 #include "Lib/AutoPtr.h"
 #include "Lib/Bootstrap.h"
 #include "Lib/containers/Array.h"
+#include "Lib/containers/FlatMap.h"
 #include "Lib/containers/Map.h"
 #include "Lib/Exception.h"
 #include "Lib/Path.h"
@@ -27,12 +28,7 @@ using ConstGenericPropertyValue   = GenericPropertyValue<true>;
 using HashedKey                   = uint64;
 
 constexpr HashedKey keyStringHash(const StringView str) {
-    // https://stackoverflow.com/questions/1660501/what-is-a-good-64bit-hash-function-in-java-for-textual-strings
-    uint64 hash = 1125899906842597L; // prime
-    for (auto& ch : str) {
-        hash = 31 * hash + static_cast<unsigned char>(ch);
-    }
-    return hash;
+    return hashBytes(str.data(), str.size());
 }
 
 enum class PropertyType {
@@ -220,8 +216,8 @@ protected:
             : offset(offset)
             , definition(definition) {}
     };
-    std::byte*        mAlignedMemory = nullptr;
-    Map<Key, Storage> mIdMapping;
+    std::byte*            mAlignedMemory = nullptr;
+    FlatMap<Key, Storage> mIdMapping;
 
     Array<MetaStructObserver> mUniversalObservers;
 
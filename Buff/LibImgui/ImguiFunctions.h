@@ -23,7 +23,7 @@ inline void buildFonts() {
 inline void addTextCentered(const BoundingBox2& pos, Rgba8Bit col, const StringView text) {
     const float drawWidth = pos.getSize().x;
     float       y         = pos.getTopLeft().y;
-    for (auto& segment : text.explode("\n")) {
+    for (const StringView segment : text.split("\n")) {
         const char* remaining = segment.data();
         if (segment.isEmpty()) { // Empty lines should be visible
             y += ImGui::CalcTextSize(" ", nullptr, false, pos.getSize().x).y;
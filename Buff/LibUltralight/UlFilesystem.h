@@ -1,6 +1,7 @@
 #pragma once
 #include "LibUltralight/LibUltralight.h"
 #include "LibUltralight/UlLogger.h"
+#include "Lib/containers/FlatMap.h"
 #include "Lib/Filesystem.h"
 #include "Lib/meta/MetaStruct.h"
 #include "Lib/Path.h"
@@ -70,8 +71,8 @@ public:
         // The wrong implementation is in "AppCore\src\win\FileSystemWin.cpp, and we are using portions of
         // Linux implementation from AppCore\src\linux\FileSystemBasic.cpp
 
-        static const Map<StringView, StringView> MIME_MAP =
-            Map<StringView, StringView>(std::initializer_list<std::pair<StringView, StringView>> {
+        static const FlatMap<StringView, StringView> MIME_MAP =
+            FlatMap<StringView, StringView>(std::initializer_list<std::pair<StringView, StringView>> {
                 {"js"_Sv,   "application/javascript"_Sv},
                 {"json"_Sv, "application/json"_Sv      },
                 {"jsx"_Sv,  "text/jscript"_Sv          },
@@ -88,9 +88,15 @@ static Expected<String> httpPostRequestImpl(const StringView       url,
     String       server     = url.getSubstring(0, firstSlash);
     const String endpoint   = url.getSubstring(firstSlash);
     int          port       = 80;
-    if (const Optional<int> portSplit = url.findFirstOf(":")) {
+    if (const Optional<int> portSplit = url.findFirstOf(":"); portSplit && *portSplit < firstSlash) {
         server = url.getSubstring(0, *portSplit);
-        port   = *fromStr<int>(url.getSubstring(*portSplit + 1));
+        // The port ends where the endpoint starts
+        const Optional<int> parsedPort =
+            fromStr<int>(url.getSubstring(*portSplit + 1, firstSlash - *portSplit - 1));
+        if (!parsedPort) {
+            return makeUnexpected("Invalid port in URL " + url);
+        }
+        port = *parsedPort;
     }
 
     hConnect = InternetConnect(hInternet,
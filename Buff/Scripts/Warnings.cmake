@@ -3,7 +3,6 @@ function(setupWarnings)
     if (EMSCRIPTEN)
         target_compile_options(${name} PRIVATE
             -Wno-shorten-64-to-32 # Because emscripten compiles x86
-            -Wno-deprecated-builtins # In robin_hood.h
             -Wno-disabled-macro-expansion # emscripten does: #define stderr (strerr)
             -Wno-old-style-cast # Expanded from macros from Imgui
             # Warnings that are turned on in emscripten but not in normal clang. TODO: enable in normal clang?